@@ -363,6 +363,8 @@ void CanvasView::mouseReleaseEvent(QMouseEvent *event)
             if (auto *srcImg = dynamic_cast<TransformableImageObject*>(src)) {
                 if (srcImg != m_selectedImage)
                     srcImg->endTransform();
+                // The transform went to the source in place
+                if (canvas->project()) canvas->project()->markObjectDirty(srcImg);
             }
         }
         m_selectedImage->endTransform();
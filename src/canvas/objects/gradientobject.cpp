@@ -51,7 +51,7 @@ void GradientObject::paint(QPainter *painter,
                            QWidget * /*widget*/)
 {
     if (m_bounds.isEmpty()) return;
-    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setRenderHint(QPainter::Antialiasing, !isDraftPaint());
     painter->save();
 
     painter->setOpacity(m_objectOpacity);
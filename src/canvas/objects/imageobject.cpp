@@ -72,8 +72,8 @@ void ImageObject::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
     Q_UNUSED(option)
     Q_UNUSED(widget)
 
-    painter->setRenderHint(QPainter::Antialiasing);
-    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->setRenderHint(QPainter::Antialiasing, !isDraftPaint());
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, !isDraftPaint());
 
     if (!m_pixmap.isNull()) {
         painter->drawPixmap(boundingRect().toRect(), m_pixmap);
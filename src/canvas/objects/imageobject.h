@@ -17,6 +17,8 @@ public:
     void setImage(const QPixmap &pixmap);
     void setImagePath(const QString &path);
     QPixmap image() const { return m_pixmap; }
+    // The pixmap's cacheKey(); reading it does not copy the pixmap
+    qint64 imageKey() const { return m_pixmap.cacheKey(); }
 
     void setSize(const QSizeF &size);
     QSizeF size() const { return m_size; }
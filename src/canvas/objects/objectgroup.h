@@ -36,6 +36,9 @@ public:
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
                QWidget *widget = nullptr) override;
+    void prepareForPaint() const override {
+        for (VectorObject *child : m_children) child->prepareForPaint();
+    }
 
     // Generate a thumbnail pixmap for the Asset Panel
     QPixmap thumbnail(int size = 64) const;
@@ -293,7 +293,7 @@ void PathObject::paintPressureStroke(QPainter *painter, qreal baseWidth,
 {
     painter->save();
     painter->setOpacity(m_objectOpacity * opacityMul);
-    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setRenderHint(QPainter::Antialiasing, !isDraftPaint());
 
     const qreal effBase = baseWidth * m_pressureConnWidthScale;
 
@@ -356,7 +356,7 @@ QPen PathObject::buildStrokePen(qreal width, QColor color) const
 void PathObject::paintSmooth(QPainter *painter) const
 {
     painter->save();
-    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setRenderHint(QPainter::Antialiasing, !isDraftPaint());
 
     if (!m_pressurePoints.isEmpty()) {
         paintPressureStroke(painter, m_strokeWidth, 0.08, 1.0);
@@ -565,7 +565,7 @@ void PathObject::paint(QPainter *painter,
     Q_UNUSED(option); Q_UNUSED(widget);
     if (m_path.isEmpty() && m_pressurePoints.isEmpty()) return;
 
-    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setRenderHint(QPainter::Antialiasing, !isDraftPaint());
 
     if (m_fillColor != Qt::transparent) {
         painter->setBrush(m_fillColor);
@@ -573,7 +573,8 @@ void PathObject::paint(QPainter *painter,
         painter->drawPath(m_path);
     }
 
-    switch (m_texture) {
+    // Drafts skip the (many-dab) brush textures
+    switch (isDraftPaint() ? PathTexture::Smooth : m_texture) {
     case PathTexture::Smooth: paintSmooth(painter); break;
     case PathTexture::Grainy: paintGrainy(painter); break;
     case PathTexture::Chalk:  paintChalk(painter);  break;
@@ -69,6 +69,8 @@ public:
     void setPressureConnectionWidthScale(qreal s) { m_pressureConnWidthScale = qBound(0.05, s, 10.0); update(); }
     qreal pressureConnectionWidthScale() const { return m_pressureConnWidthScale; }
 
+    void prepareForPaint() const override { if (m_smoothedDirty) rebuildSmoothedPressure(); }
+
 private:
     void rebuildSmoothPath();
     void drawArrowHead(QPainter *painter, const QPainterPath &path) const;
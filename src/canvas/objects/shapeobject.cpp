@@ -44,7 +44,7 @@ void ShapeObject::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
     Q_UNUSED(option)
     Q_UNUSED(widget)
 
-    painter->setRenderHint(QPainter::Antialiasing);
+    painter->setRenderHint(QPainter::Antialiasing, !isDraftPaint());
 
     // Stroke
     if (m_strokeWidth > 0) {
@@ -122,9 +122,9 @@ void TextObject::paint(QPainter *painter,
     Q_UNUSED(option)
     Q_UNUSED(widget)
 
-    painter->setRenderHint(QPainter::Antialiasing,       true);
-    painter->setRenderHint(QPainter::TextAntialiasing,   true);
-    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter->setRenderHint(QPainter::Antialiasing,       !isDraftPaint());
+    painter->setRenderHint(QPainter::TextAntialiasing,   !isDraftPaint());
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, !isDraftPaint());
 
     QFont font = buildFont();
     painter->setFont(font);          // set BEFORE querying metrics
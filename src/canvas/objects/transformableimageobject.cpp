@@ -10,9 +10,16 @@
 
 TransformableImageObject::TransformableImageObject(const QImage &image,
                                                    QGraphicsItem *parent)
+    : TransformableImageObject(image, QPixmap::fromImage(image), parent)
+{
+}
+
+TransformableImageObject::TransformableImageObject(const QImage &image,
+                                                   const QPixmap &pixmap,
+                                                   QGraphicsItem *parent)
     : VectorObject(parent)
     , m_image(image)
-    , m_pixmap(QPixmap::fromImage(image))
+    , m_pixmap(pixmap)
     , m_w(image.width())
     , m_h(image.height())
     , m_pos(0, 0)
@@ -27,7 +34,7 @@ TransformableImageObject::TransformableImageObject(const QImage &image,
 
 VectorObject* TransformableImageObject::clone() const
 {
-    auto *copy = new TransformableImageObject(m_image);
+    auto *copy = new TransformableImageObject(m_image, m_pixmap);
     copy->m_w     = m_w;
     copy->m_h     = m_h;
     copy->m_pos   = m_pos;
@@ -71,7 +78,7 @@ void TransformableImageObject::paint(QPainter *painter,
     painter->save();
     painter->translate(m_pos);
     painter->rotate(m_angle);
-    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, !isDraftPaint());
     painter->drawPixmap(QRectF(-m_w/2, -m_h/2, m_w, m_h).toRect(), m_pixmap);
     painter->restore();
 }
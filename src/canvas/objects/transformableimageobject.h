@@ -28,6 +28,10 @@ class TransformableImageObject : public VectorObject
 public:
     explicit TransformableImageObject(const QImage &image,
                                       QGraphicsItem *parent = nullptr);
+    // Shares an already converted pixmap (clones, project blobs) instead of
+    // converting the image again for every object
+    TransformableImageObject(const QImage &image, const QPixmap &pixmap,
+                             QGraphicsItem *parent = nullptr);
     ~TransformableImageObject() override = default;
 
     // ── VectorObject interface ────────────────────────────────────────────────
@@ -1,5 +1,7 @@
 #include "vectorobject.h"
 
+static thread_local bool s_draftPaint = false;
+
 VectorObject::VectorObject(QGraphicsItem *parent)
     : QGraphicsItem(parent)
     , m_strokeColor(Qt::black)
@@ -39,3 +41,13 @@ void VectorObject::setObjectOpacity(qreal opacity)
     m_objectOpacity = qBound(0.0, opacity, 1.0);
     setOpacity(m_objectOpacity);
 }
+
+bool VectorObject::isDraftPaint()
+{
+    return s_draftPaint;
+}
+
+void VectorObject::setDraftPaint(bool draft)
+{
+    s_draftPaint = draft;
+}
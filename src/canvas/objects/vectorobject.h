@@ -55,6 +55,16 @@ public:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
                QWidget *widget = nullptr) override = 0;
 
+    // Build any lazily cached paint data now, so that paint() and
+    // boundingRect() only read. Call on the owning thread before the same
+    // object is painted from several threads at once.
+    virtual void prepareForPaint() const {}
+
+    // Draft painting for quick export previews: no antialiasing and no
+    // brush textures. Per thread, so each export worker sets its own.
+    static bool isDraftPaint();
+    static void setDraftPaint(bool draft);
+
     // --- Common Properties ---
     QColor strokeColor() const { return m_strokeColor; }
     void setStrokeColor(const QColor &color);
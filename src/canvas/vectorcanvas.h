@@ -33,6 +33,7 @@ public:
     Tool* currentTool() const { return m_currentTool; }
 
     QUndoStack* undoStack() const { return m_undoStack; }
+    Project* project() const { return m_project; }
 
     void setOnionSkinEnabled(bool enabled);
     bool onionSkinEnabled() const { return m_onionSkinEnabled; }
@@ -175,10 +175,12 @@ void RemoveLayerCommand::redo()
 
 // ============= FillColorCommand =============
 
-FillColorCommand::FillColorCommand(VectorObject *object, const QColor &newColor,
-                                   QUndoCommand *parent)
+FillColorCommand::FillColorCommand(VectorObject *object, Layer *layer, int frame,
+                                   const QColor &newColor, QUndoCommand *parent)
     : QUndoCommand(parent)
     , m_object(object)
+    , m_layer(layer)
+    , m_frame(frame)
     , m_oldColor(object->fillColor())
     , m_newColor(newColor)
 {
@@ -188,19 +190,24 @@ FillColorCommand::FillColorCommand(VectorObject *object, const QColor &newColor,
 void FillColorCommand::undo()
 {
     m_object->setFillColor(m_oldColor);
+    if (m_layer) m_layer->markFrameDirty(m_frame);
 }
 
 void FillColorCommand::redo()
 {
     m_object->setFillColor(m_newColor);
+    if (m_layer) m_layer->markFrameDirty(m_frame);
 }
 
 // ============= PathObjectPathCommand =============
 
-PathObjectPathCommand::PathObjectPathCommand(PathObject *path, const QPainterPath &oldPath,
+PathObjectPathCommand::PathObjectPathCommand(PathObject *path, Layer *layer, int frame,
+                                             const QPainterPath &oldPath,
                                              const QPainterPath &newPath, QUndoCommand *parent)
     : QUndoCommand(parent)
     , m_path(path)
+    , m_layer(layer)
+    , m_frame(frame)
     , m_oldPath(oldPath)
     , m_newPath(newPath)
 {
@@ -211,10 +218,12 @@ void PathObjectPathCommand::undo()
 {
     if (m_path)
         m_path->setPath(m_oldPath);
+    if (m_layer) m_layer->markFrameDirty(m_frame);
 }
 
 void PathObjectPathCommand::redo()
 {
     if (m_path)
         m_path->setPath(m_newPath);
+    if (m_layer) m_layer->markFrameDirty(m_frame);
 }
@@ -115,12 +115,12 @@ private:
 };
 
 /**
- * Command for changing the fill color of an object
+ * Command for changing the fill color of an object on a layer's keyframe
  */
 class FillColorCommand : public QUndoCommand
 {
 public:
-    FillColorCommand(VectorObject *object, const QColor &newColor,
+    FillColorCommand(VectorObject *object, Layer *layer, int frame, const QColor &newColor,
                      QUndoCommand *parent = nullptr);
 
     void undo() override;
@@ -128,6 +128,8 @@ public:
 
 private:
     VectorObject *m_object;
+    Layer *m_layer;
+    int m_frame;
     QColor m_oldColor;
     QColor m_newColor;
 };
@@ -138,7 +140,7 @@ class PathObject;
 class PathObjectPathCommand : public QUndoCommand
 {
 public:
-    PathObjectPathCommand(PathObject *path, const QPainterPath &oldPath,
+    PathObjectPathCommand(PathObject *path, Layer *layer, int frame, const QPainterPath &oldPath,
                           const QPainterPath &newPath, QUndoCommand *parent = nullptr);
 
     void undo() override;
@@ -146,6 +148,8 @@ public:
 
 private:
     PathObject *m_path;
+    Layer *m_layer;
+    int m_frame;
     QPainterPath m_oldPath;
     QPainterPath m_newPath;
 };
@@ -2,7 +2,9 @@
 #include "frame.h"
 #include "canvas/objects/vectorobject.h"
 #include "canvas/objects/pathobject.h"
+#include "io/objectserializer.h"
 #include <QRectF>
+#include <atomic>
 
 Layer::Layer(const QString &name, QObject *parent)
     : QObject(parent)
@@ -115,6 +117,8 @@ QList<VectorObject*> Layer::objectsAtFrame(int frameNumber) const
         const FrameInterpolation &interp = it.value();
         if (frameNumber > interp.startFrame && frameNumber < interp.endFrame) {
             // Get start and end keyframe objects
+            ensureFrameLoaded(interp.startFrame);
+            ensureFrameLoaded(interp.endFrame);
             const QList<VectorObject*> &startObjs = m_frames.value(interp.startFrame);
             const QList<VectorObject*> &endObjs   = m_frames.value(interp.endFrame);
 
@@ -164,16 +168,20 @@ QList<VectorObject*> Layer::objectsAtFrame(int frameNumber) const
     // --- Extended (hold) frames ---
     int keyFrame = getKeyFrameFor(frameNumber);
     if (keyFrame != -1 && keyFrame != frameNumber) {
+        ensureFrameLoaded(keyFrame);
         return m_frames.value(keyFrame, QList<VectorObject*>());
     }
 
     // --- Normal keyframe ---
+    ensureFrameLoaded(frameNumber);
     return m_frames.value(frameNumber, QList<VectorObject*>());
 }
 
 void Layer::addObjectToFrame(int frameNumber, VectorObject *obj)
 {
     if (obj) {
+        ensureFrameLoaded(frameNumber);
+
         // CRITICAL FIX: Check if this frame is extended from a key frame
         int keyFrame = getKeyFrameFor(frameNumber);
 
@@ -189,6 +197,7 @@ void Layer::addObjectToFrame(int frameNumber, VectorObject *obj)
             int extensionEnd = getExtensionEnd(frameNumber);
 
             // Copy objects from key frame to make this an independent frame
+            ensureFrameLoaded(keyFrame);
             QList<VectorObject*> keyFrameObjects = m_frames.value(keyFrame, QList<VectorObject*>());
             for (VectorObject *keyObj : keyFrameObjects) {
                 // Clone the object so this frame has its own copy
@@ -212,6 +221,7 @@ void Layer::addObjectToFrame(int frameNumber, VectorObject *obj)
 
         // Now add the new object to this frame
         m_frames[frameNumber].append(obj);
+        markFrameDirty(frameNumber);
         emit modified();
     }
 }
@@ -224,11 +234,13 @@ void Layer::addMotionPathObjectToFrame(int frameNumber, VectorObject *obj)
 
 void Layer::removeObjectFromFrame(int frameNumber, VectorObject *obj)
 {
+    ensureFrameLoaded(frameNumber);
     if (m_frames.contains(frameNumber)) {
         m_frames[frameNumber].removeOne(obj);
         if (m_frames[frameNumber].isEmpty()) {
             m_frames.remove(frameNumber);
         }
+        markFrameDirty(frameNumber);
         emit modified();
     }
 }
@@ -241,6 +253,7 @@ void Layer::duplicateFrame(int srcFrame, int destFrame)
 
     // Get the source objects (respects extensions & interpolation via objectsAtFrame,
     // but for a straight duplicate we want the raw key-frame data only).
+    ensureFrameLoaded(srcFrame);
     const QList<VectorObject*> srcObjs = m_frames.value(srcFrame, QList<VectorObject*>());
     if (srcObjs.isEmpty()) return;
 
@@ -254,6 +267,7 @@ void Layer::duplicateFrame(int srcFrame, int destFrame)
         m_frames[destFrame].append(copy);
     }
 
+    markFrameDirty(destFrame);
     emit modified();
 }
 
@@ -266,6 +280,14 @@ void Layer::swapFrameCells(int a, int b)
     if (!listB.isEmpty()) m_frames.insert(a, listB);
     if (!listA.isEmpty()) m_frames.insert(b, listA);
 
+    // Archived frames move with their cell without being decoded
+    const bool hasArchivedA = m_archivedFrames.contains(a);
+    const bool hasArchivedB = m_archivedFrames.contains(b);
+    ArchivedFrame archivedA = m_archivedFrames.take(a);
+    ArchivedFrame archivedB = m_archivedFrames.take(b);
+    if (hasArchivedB) m_archivedFrames.insert(a, archivedB);
+    if (hasArchivedA) m_archivedFrames.insert(b, archivedA);
+
     QColor ca = m_frameColors.value(a);
     QColor cb = m_frameColors.value(b);
     m_frameColors.remove(a);
@@ -287,10 +309,19 @@ void Layer::swapFrameCells(int a, int b)
     if (ma) m_motionPathFrames.insert(b);
     if (mb) m_motionPathFrames.insert(a);
 
+    markFrameDirty(a);
+    markFrameDirty(b);
     emit modified();
 }
 
 void Layer::clearFrame(int frameNumber){
+    // An archived frame is simply forgotten; there is nothing to delete yet
+    if (m_archivedFrames.remove(frameNumber) > 0 && !m_frames.contains(frameNumber)) {
+        markFrameDirty(frameNumber);
+        emit modified();
+        return;
+    }
+
     if (m_frames.contains(frameNumber)) {
         qDeleteAll(m_frames[frameNumber]);
         m_frames.remove(frameNumber);
@@ -300,6 +331,7 @@ void Layer::clearFrame(int frameNumber){
             delete m_framCache.take(frameNumber);
         }
 
+        markFrameDirty(frameNumber);
         emit modified();
     }
 }
@@ -307,14 +339,14 @@ void Layer::clearFrame(int frameNumber){
 bool Layer::hasContentAtFrame(int frameNumber) const
 {
     // Check if frame has actual content
-    if (m_frames.contains(frameNumber) && !m_frames[frameNumber].isEmpty()) {
+    if (hasStoredFrame(frameNumber)) {
         return true;
     }
 
     // Check if this frame is extended from a key frame
     int keyFrame = getKeyFrameFor(frameNumber);
     if (keyFrame != -1 && keyFrame != frameNumber) {
-        return m_frames.contains(keyFrame) && !m_frames[keyFrame].isEmpty();
+        return hasStoredFrame(keyFrame);
     }
 
     return false;
@@ -329,7 +361,7 @@ void Layer::extendFrameTo(int fromFrame, int toFrame)
     }
 
     // Only allow extending frames that have actual content
-    if (!m_frames.contains(fromFrame) || m_frames[fromFrame].isEmpty()) {
+    if (!hasStoredFrame(fromFrame)) {
         return;
     }
 
@@ -361,7 +393,7 @@ bool Layer::isFrameExtended(int frameNumber) const
 int Layer::getKeyFrameFor(int frameNumber) const
 {
     // If this frame has actual content, it IS the key frame
-    if (m_frames.contains(frameNumber) && !m_frames[frameNumber].isEmpty()) {
+    if (hasStoredFrame(frameNumber)) {
         return frameNumber;
     }
 
@@ -395,13 +427,123 @@ int Layer::getExtensionEnd(int frameNumber) const
 
 bool Layer::isKeyFrame(int frameNumber) const
 {
-    return m_frames.contains(frameNumber) && !m_frames[frameNumber].isEmpty();
+    return hasStoredFrame(frameNumber);
+}
+
+QList<int> Layer::allFrameNumbers() const
+{
+    if (m_archivedFrames.isEmpty())
+        return m_frames.keys();
+
+    QList<int> frames = m_frames.keys();
+    for (auto it = m_archivedFrames.constBegin(); it != m_archivedFrames.constEnd(); ++it) {
+        if (!m_frames.contains(it.key()))
+            frames.append(it.key());
+    }
+    std::sort(frames.begin(), frames.end());
+    return frames;
+}
+
+// ============= LAZY LOADING =============
+
+void Layer::setArchivedFrame(int frameNumber, std::shared_ptr<ProjectArchive> archive,
+                             const ArchiveChunk &chunk)
+{
+    if (!archive) return;
+    m_archivedFrames[frameNumber] = ArchivedFrame{ std::move(archive), chunk };
+}
+
+void Layer::rebindArchivedFrame(int frameNumber, std::shared_ptr<ProjectArchive> archive,
+                                const ArchiveChunk &chunk)
+{
+    auto it = m_archivedFrames.find(frameNumber);
+    if (it == m_archivedFrames.end() || !archive) return;
+    *it = ArchivedFrame{ std::move(archive), chunk };
+}
+
+QByteArray Layer::archivedChunk(int frameNumber) const
+{
+    auto it = m_archivedFrames.constFind(frameNumber);
+    if (it == m_archivedFrames.constEnd()) return QByteArray();
+    return it->archive->chunk(it->chunk);
+}
+
+QList<QByteArray> Layer::archivedBlobs(int frameNumber) const
+{
+    auto it = m_archivedFrames.constFind(frameNumber);
+    if (it == m_archivedFrames.constEnd()) return QList<QByteArray>();
+    return it->chunk.blobs;
+}
+
+QList<ArchiveChunk> Layer::archivedChunks(const ProjectArchive *archive) const
+{
+    QList<ArchiveChunk> chunks;
+    for (const ArchivedFrame &archived : m_archivedFrames) {
+        if (archived.archive.get() == archive)
+            chunks.append(archived.chunk);
+    }
+    return chunks;
+}
+
+void Layer::markFrameDirty(int frameNumber)
+{
+    // Shared by every project, including the private ones export jobs build
+    // on their workers, so revisions stay unique across threads
+    static std::atomic<quint64> revisionCounter{0};
+    m_dirtyFrames.insert(frameNumber);
+    m_frameRevisions[frameNumber] = ++revisionCounter;
+    emit frameChanged(frameNumber);
+}
+
+bool Layer::hasStoredFrame(int frameNumber) const
+{
+    if (m_archivedFrames.contains(frameNumber)) return true;
+    auto it = m_frames.constFind(frameNumber);
+    return it != m_frames.constEnd() && !it->isEmpty();
+}
+
+void Layer::ensureFrameLoaded(int frameNumber) const
+{
+    if (!m_archivedFrames.contains(frameNumber)) return;
+    const_cast<Layer*>(this)->attachParsedFrame(frameNumber, parseArchivedFrame(frameNumber));
+}
+
+QList<ObjectSerializer::ObjectData> Layer::parseArchivedFrame(int frameNumber) const
+{
+    auto it = m_archivedFrames.constFind(frameNumber);
+    if (it == m_archivedFrames.constEnd()) return QList<ObjectSerializer::ObjectData>();
+    return ObjectSerializer::parseFrame(it->archive->chunk(it->chunk), it->archive.get());
+}
+
+void Layer::attachParsedFrame(int frameNumber, const QList<ObjectSerializer::ObjectData> &data)
+{
+    auto it = m_archivedFrames.find(frameNumber);
+    if (it == m_archivedFrames.end()) return;   // already decoded or removed
+
+    const ArchivedFrame archived = it.value();
+    m_archivedFrames.erase(it);
+
+    QList<VectorObject*> objects = ObjectSerializer::createFrame(data, archived.archive.get());
+    if (objects.isEmpty()) return;
+
+    // Decoding only materializes data that was already part of the layer,
+    // so it is not an edit and does not emit modified().
+    QList<VectorObject*> &list = m_frames[frameNumber];
+    list = objects + list;
+}
+
+void Layer::attachLoadedObjects(int frameNumber, const QList<VectorObject*> &objects)
+{
+    if (objects.isEmpty()) return;
+    // Like attachParsedFrame(): loading is not an edit
+    m_frames[frameNumber].append(objects);
 }
 
 // ============= COMPATIBILITY: Frame* interface =============
 
 Frame* Layer::frameAt(int index)
 {
+    ensureFrameLoaded(index);
     if (!m_framCache.contains(index)) {
         m_framCache[index] = new Frame(index, this);
     }
@@ -416,6 +558,7 @@ Frame* Layer::frameAt(int index)
 
 Frame* Layer::frameIfExists(int index) const
 {
+    ensureFrameLoaded(index);
     if (m_framCache.contains(index)) {
         return m_framCache[index];
     }
@@ -435,7 +578,7 @@ const Frame* Layer::getActiveFrameAt(int index) const
     }
 
     // Find previous frame with content
-    QList<int> frameNums = m_frames.keys();
+    QList<int> frameNums = allFrameNumbers();
     std::sort(frameNums.begin(), frameNums.end(), std::greater<int>());
 
     for (int frameNum : frameNums) {
@@ -551,6 +694,14 @@ void Layer::setAudioClip(int index, const AudioData &audio)
     }
 }
 
+void Layer::setAudioClipPeaks(int index, std::shared_ptr<const WaveformPeaks> peaks)
+{
+    if (index >= 0 && index < m_audioClips.size() && m_audioClips[index].peaks != peaks) {
+        m_audioClips[index].peaks = std::move(peaks);
+        emit audioPeaksChanged();
+    }
+}
+
 void Layer::setAudioData(const AudioData &audio)
 {
     // Legacy compat: replace first clip or add if empty
@@ -628,6 +779,7 @@ void Layer::makeKeyFrame(int frameNumber)
     // Add the cloned objects to this frame
     m_frames[frameNumber] = newObjects;
 
+    markFrameDirty(frameNumber);
     emit modified();
 }
 
@@ -7,10 +7,15 @@
 #include <QMap>
 #include <QList>
 #include <QSet>
+#include <QHash>
 #include <QPointF>
+#include <memory>
+#include "io/projectarchive.h"
+#include "io/objectserializer.h"
 
 class Frame;  // Keep for compatibility
 class VectorObject;
+class WaveformPeaks;
 
 enum class LayerType {
     Art,
@@ -58,9 +63,12 @@ struct AudioData {
     bool muted;
     bool isMidi;          // true = MIDI file (.mid/.midi)
     QString renderedPath; // path to FluidSynth-rendered WAV (MIDI only)
-    QVector<float> waveformData;  // PCM waveform samples for visualization
-    QVector<MidiNote> midiNotes;  // parsed notes for piano-roll display
+    std::shared_ptr<const WaveformPeaks> peaks;  // min/max/RMS pyramid for the timeline
+    QVector<MidiNote> midiNotes;  // parsed notes for piano-roll display, sorted by startBeat
     double midiTotalBeats;        // total length in beats
+    int midiMinPitch = 127;       // pitch range and longest note, found when parsed
+    int midiMaxPitch = 0;
+    double midiMaxNoteBeats = 0;
 
     AudioData() : startFrame(1), durationFrames(-1), volume(1.0f),
                   muted(false), isMidi(false), midiTotalBeats(0) {}
@@ -128,7 +136,7 @@ public:
     void swapFrameCells(int frameA, int frameB);
     bool hasContentAtFrame(int frameNumber) const;
     // Returns all frame numbers that have direct content (for dynamic frame sizing)
-    QList<int> allFrameNumbers() const { return m_frames.keys(); }
+    QList<int> allFrameNumbers() const;
     // Returns all extension-end frame numbers
     QList<int> allExtensionEnds() const {
         QList<int> ends;
@@ -172,6 +180,8 @@ public:
     void addAudioClip(const AudioData &audio);
     void removeAudioClip(int index);
     void setAudioClip(int index, const AudioData &audio);
+    // Display data only: emits audioPeaksChanged(), not modified()
+    void setAudioClipPeaks(int index, std::shared_ptr<const WaveformPeaks> peaks);
     const QList<AudioData>& audioClips() const { return m_audioClips; }
     bool hasAudio() const { return !m_audioClips.isEmpty(); }
     void clearAudio();
@@ -197,10 +207,45 @@ public:
 
     void emitModified() { emit modified(); }
 
+    // Lazy loading: an archived frame is only decoded the first time its
+    // objects are requested. Until then it counts as a keyframe with content.
+    void setArchivedFrame(int frameNumber, std::shared_ptr<ProjectArchive> archive,
+                          const ArchiveChunk &chunk);
+    bool isFrameLoaded(int frameNumber) const { return !m_archivedFrames.contains(frameNumber); }
+    // Points a frame that is still archived at another reader of the same
+    // content, e.g. the file as re-read after a save (no-op otherwise)
+    void rebindArchivedFrame(int frameNumber, std::shared_ptr<ProjectArchive> archive,
+                             const ArchiveChunk &chunk);
+    // Compressed chunk of a frame that is still archived (empty once decoded)
+    QByteArray archivedChunk(int frameNumber) const;
+    // Image blobs the archived chunk refers to
+    QList<QByteArray> archivedBlobs(int frameNumber) const;
+    // Chunks of the frames still archived in the given reader
+    QList<ArchiveChunk> archivedChunks(const ProjectArchive *archive) const;
+    // Two-step decode for loading many frames at once: parseArchivedFrame()
+    // may run on worker threads (as long as no frames are added or removed
+    // meanwhile), attachParsedFrame() then creates the objects on the GUI thread
+    QList<ObjectSerializer::ObjectData> parseArchivedFrame(int frameNumber) const;
+    void attachParsedFrame(int frameNumber, const QList<ObjectSerializer::ObjectData> &data);
+    // Objects read from a file or snapshot while the layer is being built;
+    // unlike addObjectToFrame() this neither marks the frame dirty nor
+    // emits anything
+    void attachLoadedObjects(int frameNumber, const QList<VectorObject*> &objects);
+
+    // Frames whose objects changed since the last save (journaled saves)
+    QSet<int> dirtyFrames() const { return m_dirtyFrames; }
+    void markFrameDirty(int frameNumber);
+    void clearDirtyFrames() { m_dirtyFrames.clear(); }
+    // Changes whenever the frame is marked dirty; never reused, so it can
+    // key caches of the frame's content (0 = unchanged since loading)
+    quint64 frameRevision(int frameNumber) const { return m_frameRevisions.value(frameNumber); }
+
 signals:
     void modified();
+    void frameChanged(int frameNumber);   // objects of a keyframe changed
     void visibilityChanged(bool visible);
     void lockedChanged(bool locked);
+    void audioPeaksChanged();
     void typeChanged(LayerType type);
 
 private:
@@ -216,6 +261,17 @@ private:
     // Frame data: frameNumber -> list of objects
     QMap<int, QList<VectorObject*>> m_frames;
 
+    // Frames still sitting in the project file, decoded by ensureFrameLoaded()
+    struct ArchivedFrame {
+        std::shared_ptr<ProjectArchive> archive;
+        ArchiveChunk chunk;
+    };
+    mutable QMap<int, ArchivedFrame> m_archivedFrames;
+    QSet<int> m_dirtyFrames;
+    QHash<int, quint64> m_frameRevisions;
+    void ensureFrameLoaded(int frameNumber) const;
+    bool hasStoredFrame(int frameNumber) const;
+
     // COMPATIBILITY: Cache Frame objects for tools that need them
     mutable QMap<int, Frame*> m_framCache;
 
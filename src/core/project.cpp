@@ -2,68 +2,25 @@
 #include "layer.h"
 #include "frame.h"
 #include "canvas/objects/vectorobject.h"
-#include "canvas/objects/pathobject.h"
-#include "canvas/objects/shapeobject.h"
-#include "canvas/objects/textobject.h"
 #include "canvas/objects/imageobject.h"
-#include "canvas/objects/transformableimageobject.h"
+#include "io/objectserializer.h"
+#include "io/projectarchive.h"
+#include "io/imageblobstore.h"
+#include "utils/parallel.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
 #include <QFileInfo>
 #include <QColor>
-#include <QBuffer>
+#include <QHash>
+#include <QPair>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QThread>
 #include <QUndoCommand>
 
-// Forward declarations for serialization helpers
-static QJsonObject serializeVectorObject(VectorObject *obj);
-static VectorObject* deserializeVectorObject(const QJsonObject &data);
-
-// ── RDP path simplification (mirrors vectorcanvas.cpp) ───────────────────────
-// Applied on load to clean up any paths saved before the stroke-time
-// simplification was added (e.g. the BackupTestSave.avg project).
-static void rdpRecurseP(const QVector<QPointF> &pts, int lo, int hi,
-                        qreal eps, QVector<bool> &keep)
-{
-    if (hi <= lo + 1) return;
-    const QPointF &a = pts[lo], &b = pts[hi];
-    qreal dx = b.x()-a.x(), dy = b.y()-a.y(), len2 = dx*dx+dy*dy;
-    qreal maxD2 = 0; int maxI = lo;
-    for (int i = lo+1; i < hi; ++i) {
-        qreal d2;
-        if (len2 < 1e-10) { qreal ex=pts[i].x()-a.x(),ey=pts[i].y()-a.y(); d2=ex*ex+ey*ey; }
-        else { qreal c=(pts[i].x()-a.x())*dy-(pts[i].y()-a.y())*dx; d2=(c*c)/len2; }
-        if (d2 > maxD2) { maxD2=d2; maxI=i; }
-    }
-    if (maxD2 > eps*eps) { keep[maxI]=true; rdpRecurseP(pts,lo,maxI,eps,keep); rdpRecurseP(pts,maxI,hi,eps,keep); }
-}
-
-static QPainterPath rdpSimplifyPath(const QPainterPath &src, qreal epsilon = 1.0)
-{
-    const int n = src.elementCount();
-    if (n < 3) return src;
-    QPainterPath result;
-    QVector<QPointF> run;
-    auto flush = [&]() {
-        if (run.size() < 2) { if (!run.isEmpty()) result.lineTo(run[0]); run.clear(); return; }
-        QVector<bool> keep(run.size(), false);
-        keep.front() = keep.back() = true;
-        rdpRecurseP(run, 0, run.size()-1, epsilon, keep);
-        for (int i = 1; i < run.size(); ++i) if (keep[i]) result.lineTo(run[i]);
-        run.clear();
-    };
-    for (int i = 0; i < n; ++i) {
-        auto e = src.elementAt(i);
-        if      (e.type == QPainterPath::MoveToElement)  { flush(); result.moveTo(e.x,e.y); run << QPointF(e.x,e.y); }
-        else if (e.type == QPainterPath::LineToElement)   { run << QPointF(e.x,e.y); }
-        else { flush(); if (e.type==QPainterPath::CurveToElement && i+2<n) { auto c2=src.elementAt(i+1),ep=src.elementAt(i+2); result.cubicTo(e.x,e.y,c2.x,c2.y,ep.x,ep.y); i+=2; } }
-    }
-    flush();
-    return result;
-}
-// ── End RDP ───────────────────────────────────────────────────────────────────
-
 //const Frame& Project::frame(int index) const {
 // Returns a const reference to the frame
 // return *(m_layers[m_currentLayerIndex]->frameAt(index));
@@ -95,6 +52,7 @@ Project::Project(QObject *parent)
 
 Project::~Project()
 {
+    finishCompaction();
     qDeleteAll(m_layers);
 }
 
@@ -105,6 +63,9 @@ void Project::createNew(int width, int height, int fps)
     m_fps = fps;
     m_currentFrame = 1;
     m_totalFrames = 10;   // Start with 10 blank frames; grows dynamically
+    finishCompaction();
+    m_archive.reset();
+    m_savedLayers.clear();
 
     // Clear existing layers
     qDeleteAll(m_layers);
@@ -114,6 +75,7 @@ void Project::createNew(int width, int height, int fps)
     addLayer("Layer 1");
     m_currentLayerIndex = 0;
 
+    emit projectLoaded();
     emit modified();
     emit layersChanged();
 }
@@ -411,7 +373,7 @@ Layer* Project::layerAt(int index) const
     return nullptr;
 }
 
-bool Project::saveToFile(const QString &filePath)
+QJsonObject Project::headerJson() const
 {
     QJsonObject projectObj;
 
@@ -477,23 +439,7 @@ bool Project::saveToFile(const QString &filePath)
             layerObj["interpKeyframes"] = interpKeyframesArray;
         }
 
-        // Save all frames with objects
-        QJsonArray framesArray;
-        for (int frame = 1; frame <= m_totalFrames; ++frame) {
-            QList<VectorObject*> objects = layer->objectsAtFrame(frame);
-            if (!objects.isEmpty() && layer->isKeyFrame(frame)) {
-                QJsonObject frameObj;
-                frameObj["number"] = frame;
-
-                QJsonArray objectsArray;
-                for (VectorObject *obj : objects) {
-                    objectsArray.append(serializeVectorObject(obj));
-                }
-                frameObj["objects"] = objectsArray;
-                framesArray.append(frameObj);
-            }
-        }
-        layerObj["frames"] = framesArray;
+        // Frame contents are stored as separate chunks (see frameChunk())
 
         // Save interpolation ranges (tween ranges) — FIX #26: was not previously saved
         QJsonArray interpRangesArray;
@@ -560,35 +506,390 @@ bool Project::saveToFile(const QString &filePath)
         layersArray.append(layerObj);
     }
     projectObj["layers"] = layersArray;
+    return projectObj;
+}
 
-    // Write to file — compressed binary format
-    // Magic header "AVG2" identifies compressed saves; legacy plain-JSON files lack it
-    // and are still loaded correctly in loadFromFile().
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file for writing:" << filePath;
+int Project::compressionLevel() const
+{
+    switch (m_saveCompression) {
+    case SaveCompression::Fast:  return 1;
+    case SaveCompression::Small: return 9;
+    default:                     return 6;
+    }
+}
+
+ProjectArchive::PendingChunk Project::frameChunk(int layerIndex, int frame, ImageBlobStore &blobs,
+                                                 QJsonObject *json) const
+{
+    Layer *layer = m_layers[layerIndex];
+    ProjectArchive::PendingChunk chunk;
+    chunk.layer = quint32(layerIndex);
+    chunk.frame = frame;
+    if (!layer->isKeyFrame(frame))
+        return chunk;   // empty data: the frame no longer exists
+
+    // Frames never opened since load are copied across still compressed;
+    // loaded ones return their JSON, compressed later by encodeFrames()
+    if (layer->isFrameLoaded(frame)) {
+        *json = ObjectSerializer::frameJson(layer->objectsAtFrame(frame), &blobs, &chunk.blobs);
+    } else {
+        chunk.data  = layer->archivedChunk(frame);
+        chunk.blobs = layer->archivedBlobs(frame);
+        for (const QByteArray &hash : chunk.blobs) {
+            if (!blobs.retain(hash))
+                qWarning() << "Image blob missing from source archive:" << hash;
+        }
+    }
+    return chunk;
+}
+
+QList<ProjectArchive::PendingChunk> Project::encodeFrames(const QList<QPair<int, int>> &frames,
+                                                          ImageBlobStore &blobs,
+                                                          qint64 *rawBytes) const
+{
+    // Reading the scene items has to happen here on the GUI thread, but each
+    // frame is an independent zlib stream, so compression runs on all cores
+    QList<ProjectArchive::PendingChunk> chunks;
+    QList<QJsonObject> json;
+    chunks.reserve(frames.size());
+    json.reserve(frames.size());
+    for (const QPair<int, int> &frame : frames) {
+        QJsonObject frameJson;
+        chunks.append(frameChunk(frame.first, frame.second, blobs, &frameJson));
+        json.append(frameJson);
+    }
+
+    const int level = compressionLevel();
+    QAtomicInteger<qint64> raw(0);
+    parallelFor(chunks.size(), [&](int i) {
+        if (json.at(i).isEmpty()) return;
+        qint64 size = 0;
+        chunks[i].data = ObjectSerializer::compressFrame(json.at(i), level, &size);
+        raw.fetchAndAddRelaxed(size);
+    });
+    if (rawBytes) *rawBytes = raw.loadRelaxed();
+    return chunks;
+}
+
+// One line per save so slow saves can be traced to compression or I/O
+static void logSaveThroughput(const char *kind, const QString &filePath, int chunks,
+                              qint64 rawBytes, qint64 written, qint64 msecs)
+{
+    const double mb = 1024.0 * 1024.0;
+    const double seconds = qMax<qint64>(msecs, 1) / 1000.0;
+    qDebug().noquote() << QString("%1 save of %2: %3 chunks, %4 MB JSON -> %5 MB written "
+                                  "in %6 ms (%7 MB/s in, %8 MB/s out)")
+                              .arg(kind, QFileInfo(filePath).fileName())
+                              .arg(chunks)
+                              .arg(rawBytes / mb, 0, 'f', 2)
+                              .arg(written / mb, 0, 'f', 2)
+                              .arg(msecs)
+                              .arg(rawBytes / mb / seconds, 0, 'f', 1)
+                              .arg(written / mb / seconds, 0, 'f', 1);
+}
+
+bool Project::saveToFile(const QString &filePath)
+{
+    // Never write while a compaction may still rename over the file
+    finishCompaction();
+
+    // Saving back to the file we came from only appends the frames that
+    // changed. Layer add/remove/reorder shifts chunk indices, so those
+    // (and saves to a new path) always write a full snapshot.
+    if (isArchiveFile(filePath) && m_layers == m_savedLayers) {
+        if (saveJournal())
+            return true;
+        qWarning() << "Journal append failed, writing a full snapshot instead";
+    }
+    return saveSnapshot(filePath);
+}
+
+bool Project::saveSnapshot(const QString &filePath)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<QPair<int, int>> frames;
+    for (int layerIndex = 0; layerIndex < m_layers.size(); ++layerIndex) {
+        for (int frame : m_layers[layerIndex]->allFrameNumbers()) {
+            if (m_layers[layerIndex]->isKeyFrame(frame))
+                frames.append(qMakePair(layerIndex, frame));
+        }
+    }
+    // Images are stored once per distinct content; unchanged ones are copied
+    // from the file we were loaded from instead of being re-encoded
+    ImageBlobStore blobs(m_archive);
+    qint64 rawBytes = 0;
+    const QList<ProjectArchive::PendingChunk> chunks = encodeFrames(frames, blobs, &rawBytes);
+
+    // The save renames over the file; Windows refuses while it is still open
+    // or mapped, so the reader lets go of it first
+    if (isArchiveFile(filePath))
+        detachArchive();
+
+    // Write to file — chunked "AVG3" container (see ProjectArchive).
+    // Older "AVG2" compressed saves and legacy plain-JSON files lack the new
+    // magic and are still loaded correctly in loadFromFile().
+    QString error;
+    if (!ProjectArchive::write(filePath, headerJson(), chunks, blobs.blobs(), &error)) {
+        qWarning() << error;
         return false;
     }
 
-    QJsonDocument doc(projectObj);
-    // Compact (no whitespace) JSON cuts ~30% vs Indented before compression.
-    // qCompress level 7 gives near-maximum compression with reasonable CPU cost.
-    QByteArray compressed = qCompress(doc.toJson(QJsonDocument::Compact), 7);
-    file.write("AVG2");        // 4-byte magic — marks this as a compressed save
-    file.write(compressed);
-    file.close();
+    logSaveThroughput("Full", filePath, chunks.size(), rawBytes,
+                      QFileInfo(filePath).size(), timer.elapsed());
+    markSaved(filePath);
+    return true;
+}
+
+bool Project::saveJournal()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<QPair<int, int>> frames;
+    for (int layerIndex = 0; layerIndex < m_layers.size(); ++layerIndex) {
+        for (int frame : m_layers[layerIndex]->dirtyFrames())
+            frames.append(qMakePair(layerIndex, frame));
+    }
+    ImageBlobStore blobs(m_archive);
+    qint64 rawBytes = 0;
+    const QList<ProjectArchive::PendingChunk> chunks = encodeFrames(frames, blobs, &rawBytes);
+
+    // Only blobs the file does not hold yet go into the record
+    QHash<QByteArray, QByteArray> newBlobs;
+    const QHash<QByteArray, QByteArray> &allBlobs = blobs.blobs();
+    for (auto it = allBlobs.constBegin(); it != allBlobs.constEnd(); ++it) {
+        if (!m_archive->hasBlob(it.key()))
+            newBlobs.insert(it.key(), it.value());
+    }
+
+    QString error;
+    if (!m_archive->appendJournal(headerJson(), chunks, newBlobs, &error)) {
+        qWarning() << error;
+        return false;
+    }
+
+    const QString filePath = m_archive->filePath();
+    logSaveThroughput("Incremental", filePath, chunks.size(), rawBytes,
+                      QFileInfo(filePath).size() - m_archive->validSize(), timer.elapsed());
+    markSaved(filePath);
 
+    // Fold the journal back into a snapshot once it has grown large
+    if (m_archive && m_archive->journalNeedsCompaction())
+        startCompaction();
     return true;
 }
 
+void Project::markSaved(const QString &filePath)
+{
+    for (Layer *layer : m_layers)
+        layer->clearDirtyFrames();
+    m_savedLayers = m_layers;
+    reopenArchive(filePath);
+}
+
+bool Project::isArchiveFile(const QString &filePath) const
+{
+    return m_archive &&
+        QFileInfo(m_archive->filePath()).canonicalFilePath() == QFileInfo(filePath).canonicalFilePath();
+}
+
+void Project::detachArchive()
+{
+    // Only what is still read from the reader stays in memory: frames not
+    // decoded yet (also on removed layers the undo stack holds, which are
+    // still our children) and blobs of snapshots still being encoded. Once
+    // the file is re-read, reopenArchive() moves the frames to it.
+    QList<ArchiveChunk> chunks;
+    for (Layer *layer : findChildren<Layer*>(QString(), Qt::FindDirectChildrenOnly))
+        chunks += layer->archivedChunks(m_archive.get());
+
+    QSet<QByteArray> blobs;
+    for (const std::weak_ptr<const ProjectSnapshot> &weak : std::as_const(m_snapshots)) {
+        const std::shared_ptr<const ProjectSnapshot> snap = weak.lock();
+        if (!snap || snap->source != m_archive) continue;
+        for (const ProjectSnapshot::FrameCopy &copy : snap->frames) {
+            for (const QByteArray &hash : copy.blobs)
+                blobs.insert(hash);
+        }
+    }
+    m_archive->detach(chunks, blobs);
+}
+
+void Project::reopenArchive(const QString &filePath)
+{
+    auto archive = std::make_shared<ProjectArchive>();
+    if (!archive->open(filePath)) {
+        // Without a reader the next save simply writes a full snapshot
+        qWarning() << archive->lastError();
+        m_archive.reset();
+        return;
+    }
+    std::shared_ptr<ProjectArchive> previous = m_archive;
+    if (previous) archive->inheritCaches(*previous);
+    m_archive = archive;
+
+    // Frames not decoded yet move to the new reader, so earlier readers are
+    // released and only m_archive keeps the file open. The file holds the
+    // layers as of the last save; frames changed since then keep their reader.
+    QHash<QPair<quint32, qint32>, ArchiveChunk> chunks;
+    for (const ArchiveChunk &chunk : archive->chunks())
+        chunks.insert(qMakePair(chunk.layer, chunk.frame), chunk);
+    for (Layer *layer : m_layers) {
+        const int layerIndex = m_savedLayers.indexOf(layer);
+        if (layerIndex < 0) continue;
+        const QSet<int> dirty = layer->dirtyFrames();
+        for (int frame : layer->allFrameNumbers()) {
+            if (layer->isFrameLoaded(frame) || dirty.contains(frame)) continue;
+            auto it = chunks.constFind(qMakePair(quint32(layerIndex), qint32(frame)));
+            if (it != chunks.constEnd())
+                layer->rebindArchivedFrame(frame, archive, it.value());
+        }
+    }
+    // A reader still in use elsewhere must not pin the file either
+    if (previous && previous.use_count() > 1 &&
+        QFileInfo(previous->filePath()).canonicalFilePath() == QFileInfo(filePath).canonicalFilePath())
+        previous->detach();
+}
+
+void Project::markObjectDirty(VectorObject *object)
+{
+    int keyFrame = -1;
+    if (Layer *layer = layerOfObject(object, &keyFrame))
+        layer->markFrameDirty(keyFrame);
+}
+
+Layer* Project::layerOfObject(VectorObject *object, int *keyFrame) const
+{
+    while (object) {
+        auto *parent = dynamic_cast<VectorObject*>(object->parentItem());
+        if (!parent) break;
+        object = parent;
+    }
+    if (!object) return nullptr;
+
+    for (Layer *layer : m_layers) {
+        const int frame = layer->getKeyFrameFor(m_currentFrame);
+        if (frame != -1 && layer->objectsAtFrame(frame).contains(object)) {
+            if (keyFrame) *keyFrame = frame;
+            return layer;
+        }
+    }
+    return nullptr;
+}
+
+// QPixmap is GUI-thread only, so the pixmaps of copied image objects are
+// handed to the snapshot's encoder as QImage
+static void collectPixmapImages(VectorObject *obj, QHash<qint64, QImage> &images)
+{
+    auto *img = dynamic_cast<ImageObject*>(obj);
+    if (img && !images.contains(img->imageKey()))
+        images.insert(img->imageKey(), img->image().toImage());
+    for (QGraphicsItem *child : obj->childItems()) {
+        if (auto *childObj = dynamic_cast<VectorObject*>(child))
+            collectPixmapImages(childObj, images);
+    }
+}
+
+std::shared_ptr<ProjectSnapshot> Project::snapshot(const QHash<Layer*, QSet<int>> *changedFrames) const
+{
+    auto snap = std::make_shared<ProjectSnapshot>();
+    snap->header = headerJson();
+    snap->source = m_archive;
+    m_snapshots.removeIf([](const std::weak_ptr<const ProjectSnapshot> &weak) { return weak.expired(); });
+    m_snapshots.append(snap);
+    snap->compressionLevel = compressionLevel();
+    for (int layerIndex = 0; layerIndex < m_layers.size(); ++layerIndex) {
+        Layer *layer = m_layers[layerIndex];
+        const QList<int> frames = changedFrames ? changedFrames->value(layer).values()
+                                                : layer->allFrameNumbers();
+        for (int frame : frames) {
+            ProjectSnapshot::FrameCopy copy;
+            copy.layer = quint32(layerIndex);
+            copy.frame = frame;
+            if (!layer->isKeyFrame(frame)) {
+                if (!changedFrames) continue;   // extensions live in the header
+                copy.removed = true;
+            } else if (!layer->isFrameLoaded(frame)) {
+                copy.archived = true;
+                copy.chunk = layer->archivedChunk(frame);
+                copy.blobs = layer->archivedBlobs(frame);
+            } else {
+                for (VectorObject *obj : layer->objectsAtFrame(frame)) {
+                    copy.objects.append(obj->clone());
+                    collectPixmapImages(copy.objects.last(), snap->pixmapImages);
+                }
+            }
+            snap->frames.append(copy);
+        }
+    }
+    return snap;
+}
+
+void Project::startCompaction()
+{
+    if (m_compactor || !m_archive) return;
+
+    const QString filePath = m_archive->filePath();
+    // compact() replaces the file; see saveSnapshot()
+    detachArchive();
+    QThread *thread = QThread::create([filePath]() {
+        QString error;
+        if (!ProjectArchive::compact(filePath, &error))
+            qWarning() << "Project compaction failed:" << error;
+    });
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        if (m_compactor == thread) finishCompaction();
+    });
+    m_compactor = thread;
+    thread->start(QThread::LowPriority);
+}
+
+void Project::finishCompaction()
+{
+    if (!m_compactor) return;
+    QThread *thread = m_compactor;
+    m_compactor = nullptr;
+    thread->wait();
+    thread->deleteLater();
+    // The file now holds one snapshot; read it again so future journal
+    // records are appended after the new index
+    if (m_archive) reopenArchive(m_archive->filePath());
+}
+
 bool Project::loadFromFile(const QString &filePath)
 {
+    finishCompaction();
+
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open file for reading:" << filePath;
         return false;
     }
 
+    // AVG3: only the index is read here; frames are decoded on first access
+    if (ProjectArchive::isArchive(file.peek(4))) {
+        file.close();
+        auto archive = std::make_shared<ProjectArchive>();
+        if (!archive->open(filePath)) {
+            qWarning() << archive->lastError();
+            return false;
+        }
+        if (!loadFromJson(archive->header(), archive))
+            return false;
+
+        // Decode what the canvas shows first in parallel rather than one
+        // layer at a time as it paints
+        QList<int> visible{ m_currentFrame };
+        if (m_onionSkinEnabled) {
+            for (int i = 1; i <= m_onionSkinBefore; ++i) visible.append(m_currentFrame - i);
+            for (int i = 1; i <= m_onionSkinAfter; ++i)  visible.append(m_currentFrame + i);
+        }
+        loadFrames(visible);
+        return true;
+    }
+
     QByteArray raw = file.readAll();
     file.close();
 
@@ -610,7 +911,61 @@ bool Project::loadFromFile(const QString &filePath)
         return false;
     }
 
-    QJsonObject projectObj = doc.object();
+    return loadFromJson(doc.object(), nullptr);
+}
+
+QHash<Layer*, QSet<int>> Project::keyFramesShownAt(const QList<int> &frames) const
+{
+    QHash<Layer*, QSet<int>> keyFrames;
+    for (Layer *layer : m_layers) {
+        QSet<int> &wanted = keyFrames[layer];
+        for (int frame : frames) {
+            // Tween in-betweens are computed from both ends of their range
+            if (layer->isInterpolated(frame)) {
+                const FrameInterpolation interp = layer->getInterpolationFor(frame);
+                wanted.insert(interp.startFrame);
+                wanted.insert(interp.endFrame);
+            }
+            const int keyFrame = layer->getKeyFrameFor(frame);
+            if (keyFrame != -1) wanted.insert(keyFrame);
+        }
+    }
+    return keyFrames;
+}
+
+void Project::loadFrames(const QList<int> &frames)
+{
+    QList<QPair<Layer*, int>> pending;
+    const QHash<Layer*, QSet<int>> keyFrames = keyFramesShownAt(frames);
+    for (Layer *layer : m_layers) {
+        for (int keyFrame : keyFrames.value(layer)) {
+            if (!layer->isFrameLoaded(keyFrame))
+                pending.append(qMakePair(layer, keyFrame));
+        }
+    }
+    if (pending.isEmpty()) return;
+
+    // Decompression, JSON parsing and image decoding on the pool; item
+    // creation afterwards on this (GUI) thread
+    QList<QList<ObjectSerializer::ObjectData>> parsed(pending.size());
+    parallelFor(pending.size(), [&](int i) {
+        parsed[i] = pending[i].first->parseArchivedFrame(pending[i].second);
+    });
+    for (int i = 0; i < pending.size(); ++i)
+        pending[i].first->attachParsedFrame(pending[i].second, parsed[i]);
+}
+
+bool Project::loadFromSnapshot(ProjectSnapshot &snapshot)
+{
+    finishCompaction();
+    return loadFromJson(snapshot.header, nullptr, &snapshot);
+}
+
+bool Project::loadFromJson(const QJsonObject &projectObj, std::shared_ptr<ProjectArchive> archive,
+                           ProjectSnapshot *snapshot)
+{
+    m_archive = archive;
+    m_savedLayers.clear();
 
     // Load project metadata
     m_name = projectObj["name"].toString("Untitled");
@@ -633,10 +988,51 @@ bool Project::loadFromFile(const QString &filePath)
     qDeleteAll(m_layers);
     m_layers.clear();
 
+    // Archived frame chunks, grouped by the layer they belong to
+    QHash<quint32, QList<ArchiveChunk>> chunksByLayer;
+    if (archive) {
+        for (const ArchiveChunk &chunk : archive->chunks())
+            chunksByLayer[chunk.layer].append(chunk);
+    }
+
+    // Frames carried by a snapshot, grouped the same way
+    QHash<quint32, QList<ProjectSnapshot::FrameCopy*>> copiesByLayer;
+    if (snapshot) {
+        for (ProjectSnapshot::FrameCopy &copy : snapshot->frames)
+            if (!copy.removed) copiesByLayer[copy.layer].append(&copy);
+    }
+
     // Load layers
     QJsonArray layersArray = projectObj["layers"].toArray();
-    for (const QJsonValue &layerValue : layersArray) {
-        QJsonObject layerObj = layerValue.toObject();
+
+    // Older formats embed every frame. Rebuilding paths and decoding base64
+    // images is pure computation, so do it for all frames on all cores up
+    // front; the layer loop below then only creates the items.
+    struct LegacyFrame {
+        int layer;
+        int frame;
+        QJsonArray objects;
+        QList<ObjectSerializer::ObjectData> parsed;
+    };
+    QList<LegacyFrame> legacyFrames;
+    for (int layerIndex = 0; layerIndex < layersArray.size(); ++layerIndex) {
+        const QJsonArray framesArray = layersArray[layerIndex].toObject()["frames"].toArray();
+        for (const QJsonValue &frameVal : framesArray) {
+            QJsonObject frameObj = frameVal.toObject();
+            legacyFrames.append({ layerIndex, frameObj["number"].toInt(1),
+                                  frameObj["objects"].toArray(), {} });
+        }
+    }
+    parallelFor(legacyFrames.size(), [&](int i) {
+        LegacyFrame &frame = legacyFrames[i];
+        const QJsonArray &objects = frame.objects;
+        frame.parsed.reserve(objects.size());
+        for (const QJsonValue &objVal : objects)
+            frame.parsed.append(ObjectSerializer::parse(objVal.toObject()));
+    });
+    int nextLegacyFrame = 0;
+    for (int layerIndex = 0; layerIndex < layersArray.size(); ++layerIndex) {
+        QJsonObject layerObj = layersArray[layerIndex].toObject();
 
         Layer *layer = new Layer(layerObj["name"].toString("Layer"), this);
         layer->setVisible(layerObj["visible"].toBool(true));
@@ -703,6 +1099,35 @@ bool Project::loadFromFile(const QString &filePath)
             }
         }
 
+        // Load frames with vector objects. AVG3 frames stay in the archive
+        // until first use; older formats embed them in the layer object.
+        // Frames must exist before extensions, which only attach to content.
+        for (const ArchiveChunk &chunk : chunksByLayer.value(quint32(layerIndex)))
+            layer->setArchivedFrame(chunk.frame, archive, chunk);
+
+        for (ProjectSnapshot::FrameCopy *copy : copiesByLayer.value(quint32(layerIndex))) {
+            QList<VectorObject*> objects;
+            if (copy->archived) {
+                objects = ObjectSerializer::decodeFrame(copy->chunk, snapshot->source.get());
+            } else {
+                // The clones are ours now
+                objects = copy->objects;
+                copy->objects.clear();
+            }
+            layer->attachLoadedObjects(copy->frame, objects);
+        }
+
+        while (nextLegacyFrame < legacyFrames.size() &&
+               legacyFrames[nextLegacyFrame].layer == layerIndex) {
+            const LegacyFrame &frame = legacyFrames[nextLegacyFrame++];
+            QList<VectorObject*> objects;
+            for (const ObjectSerializer::ObjectData &data : frame.parsed) {
+                if (VectorObject *obj = ObjectSerializer::create(data))
+                    objects.append(obj);
+            }
+            layer->attachLoadedObjects(frame.frame, objects);
+        }
+
         // Load frame extensions (hold frames)
         if (layerObj.contains("frameExtensions")) {
             QJsonArray extsArray = layerObj["frameExtensions"].toArray();
@@ -715,24 +1140,6 @@ bool Project::loadFromFile(const QString &filePath)
             }
         }
 
-        // Load frames with vector objects
-        if (layerObj.contains("frames")) {
-            QJsonArray framesArray = layerObj["frames"].toArray();
-            for (const QJsonValue &frameVal : framesArray) {
-                QJsonObject frameObj = frameVal.toObject();
-                int frameNum = frameObj["number"].toInt(1);
-
-                // Load objects
-                QJsonArray objectsArray = frameObj["objects"].toArray();
-                for (const QJsonValue &objVal : objectsArray) {
-                    VectorObject *obj = deserializeVectorObject(objVal.toObject());
-                    if (obj) {
-                        layer->addObjectToFrame(frameNum, obj);
-                    }
-                }
-            }
-        }
-
         m_layers.append(layer);
 
         // Load interpolation ranges — FIX #26
@@ -784,257 +1191,19 @@ bool Project::loadFromFile(const QString &filePath)
     m_currentLayerIndex = 0;
     m_currentFrame = 1;
 
-    // ── Clean up legacy bloated paths on load ─────────────────────────────────
-    // Files saved before stroke-time RDP was added can have hundreds of
-    // near-duplicate points per stroke. Simplify them now so the canvas
-    // doesn't lag when rendering. This is a one-time cost on open; next save
-    // will write the simplified paths and the pass becomes a no-op.
-    for (Layer *layer : m_layers) {
-        for (int frameNum : layer->allFrameNumbers()) {
-            for (VectorObject *obj : layer->objectsAtFrame(frameNum)) {
-                if (auto *path = dynamic_cast<PathObject*>(obj)) {
-                    QPainterPath simplified = rdpSimplifyPath(path->path(), 1.0);
-                    if (simplified.elementCount() < path->path().elementCount())
-                        path->setPath(simplified);
-                }
-            }
-        }
-    }
-    // ── End cleanup ───────────────────────────────────────────────────────────
+    // Loading is not an edit; the next save to an AVG3 file can journal
+    for (Layer *layer : m_layers)
+        layer->clearDirtyFrames();
+    if (m_archive)
+        m_savedLayers = m_layers;
+
+    // Legacy bloated paths are simplified by ObjectSerializer as each frame
+    // is decoded, so there is no whole-project cleanup pass here any more.
 
+    emit projectLoaded();
     emit modified();
     emit layersChanged();
     emit onionSkinSettingsChanged();
 
     return true;
 }
-
-// ============= SERIALIZATION HELPERS =============
-
-static QJsonObject serializeVectorObject(VectorObject *obj)
-{
-    if (!obj) return QJsonObject();
-
-    QJsonObject data;
-
-    // Common properties
-    data["type"] = static_cast<int>(obj->objectType());
-    data["pos_x"] = obj->pos().x();
-    data["pos_y"] = obj->pos().y();
-    data["rotation"] = obj->rotation();
-    data["scale"] = obj->scale();
-    data["strokeColor"] = obj->strokeColor().name(QColor::HexArgb);
-    data["fillColor"] = obj->fillColor().name(QColor::HexArgb);
-    data["strokeWidth"] = obj->strokeWidth();
-    data["opacity"] = obj->objectOpacity();
-    data["zValue"] = obj->zValue();
-
-    // Type-specific properties
-    switch (obj->objectType()) {
-    case VectorObjectType::Path: {
-        PathObject *path = static_cast<PathObject*>(obj);
-        QPainterPath painterPath = path->path();
-
-        // Serialize path elements
-        QJsonArray elementsArray;
-        for (int i = 0; i < painterPath.elementCount(); ++i) {
-            QPainterPath::Element elem = painterPath.elementAt(i);
-            QJsonObject elemObj;
-            elemObj["type"] = elem.type;
-            // Round to 2 decimal places — sub-pixel precision is invisible
-            // but full double (15+ digits) balloons file size enormously
-            elemObj["x"] = qRound(elem.x * 100.0) / 100.0;
-            elemObj["y"] = qRound(elem.y * 100.0) / 100.0;
-            elementsArray.append(elemObj);
-        }
-        data["pathElements"] = elementsArray;
-        data["smoothPaths"] = path->smoothPaths();
-        data["texture"] = static_cast<int>(path->texture());
-        break;
-    }
-
-    case VectorObjectType::Rectangle:
-    case VectorObjectType::Ellipse: {
-        ShapeObject *shape = static_cast<ShapeObject*>(obj);
-        data["width"] = shape->rect().width();
-        data["height"] = shape->rect().height();
-        data["rect_x"] = shape->rect().x();
-        data["rect_y"] = shape->rect().y();
-        break;
-    }
-
-    case VectorObjectType::Text: {
-        TextObject *text = static_cast<TextObject*>(obj);
-        data["text"] = text->text();
-        data["fontFamily"] = text->fontFamily();
-        data["fontSize"] = text->fontSize();
-        // TextObject doesn't store bold/italic currently, just family and size
-        break;
-    }
-
-    case VectorObjectType::Image: {
-        // Handle both ImageObject and TransformableImageObject (which also reports Image type)
-        QImage image;
-        qreal imgW = 0, imgH = 0;
-        QPointF imgPos;
-        qreal imgAngle = 0;
-        bool isTransformable = false;
-
-        if (auto *timg = dynamic_cast<TransformableImageObject*>(obj)) {
-            // TransformableImageObject stores its own position, size, angle
-            image = timg->getImage();
-            imgW = timg->imgWidth();
-            imgH = timg->imgHeight();
-            imgPos = timg->position();
-            imgAngle = timg->imgAngle();
-            isTransformable = true;
-        } else if (auto *img = dynamic_cast<ImageObject*>(obj)) {
-            QPixmap pixmap = img->image();
-            image = pixmap.toImage();
-        }
-
-        QByteArray ba;
-        QBuffer buffer(&ba);
-        buffer.open(QIODevice::WriteOnly);
-        // WebP at quality 85 is ~3-5x smaller than PNG for photos/complex images.
-        // Fall back to PNG if WebP is unavailable (older Qt builds).
-        bool savedOk = image.save(&buffer, "WEBP", 85);
-        if (!savedOk) {
-            ba.clear();
-            buffer.seek(0);
-            image.save(&buffer, "PNG");
-        }
-        data["imageData"] = QString(ba.toBase64());
-        data["imageFmt"]  = savedOk ? QString("WEBP") : QString("PNG");
-        data["imageWidth"] = image.width();
-        data["imageHeight"] = image.height();
-        if (isTransformable) {
-            data["isTransformable"] = true;
-            data["img_w"] = imgW;
-            data["img_h"] = imgH;
-            data["img_pos_x"] = imgPos.x();
-            data["img_pos_y"] = imgPos.y();
-            data["img_angle"] = imgAngle;
-        }
-        break;
-    }
-    }
-
-    return data;
-}
-
-static VectorObject* deserializeVectorObject(const QJsonObject &data)
-{
-    if (data.isEmpty()) return nullptr;
-
-    VectorObjectType objType = static_cast<VectorObjectType>(data["type"].toInt());
-    VectorObject *obj = nullptr;
-
-    switch (objType) {
-    case VectorObjectType::Path: {
-        PathObject *path = new PathObject();
-
-        // Restore path elements
-        QJsonArray elementsArray = data["pathElements"].toArray();
-        QPainterPath painterPath;
-
-        for (const QJsonValue &elemVal : elementsArray) {
-            QJsonObject elemObj = elemVal.toObject();
-            QPainterPath::ElementType type = static_cast<QPainterPath::ElementType>(elemObj["type"].toInt());
-            qreal x = elemObj["x"].toDouble();
-            qreal y = elemObj["y"].toDouble();
-
-            switch (type) {
-            case QPainterPath::MoveToElement:
-                painterPath.moveTo(x, y);
-                break;
-            case QPainterPath::LineToElement:
-                painterPath.lineTo(x, y);
-                break;
-            case QPainterPath::CurveToElement:
-            case QPainterPath::CurveToDataElement:
-                // Handle curves (simplified)
-                painterPath.lineTo(x, y);
-                break;
-            }
-        }
-
-        path->setPath(painterPath);
-        path->setSmoothPaths(data["smoothPaths"].toBool(true));
-        path->setTexture(static_cast<PathTexture>(data["texture"].toInt()));
-        obj = path;
-        break;
-    }
-
-    case VectorObjectType::Rectangle: {
-        // FIXED: Removed the redundant ShapeType:: scope
-        ShapeObject *shape = new ShapeObject(ShapeObject::Rectangle);
-        qreal w = data["width"].toDouble();
-        qreal h = data["height"].toDouble();
-        qreal x = data["rect_x"].toDouble();
-        qreal y = data["rect_y"].toDouble();
-        shape->setRect(QRectF(x, y, w, h));
-        obj = shape;
-        break;
-    }
-
-    case VectorObjectType::Ellipse: {
-        // FIXED: Removed the redundant ShapeType:: scope
-        ShapeObject *shape = new ShapeObject(ShapeObject::Ellipse);
-        qreal w = data["width"].toDouble();
-        qreal h = data["height"].toDouble();
-        qreal x = data["rect_x"].toDouble();
-        qreal y = data["rect_y"].toDouble();
-        shape->setRect(QRectF(x, y, w, h));
-        obj = shape;
-        break;
-    }
-
-    case VectorObjectType::Text: {
-        TextObject *text = new TextObject();
-        text->setText(data["text"].toString());
-        text->setFontFamily(data["fontFamily"].toString("Arial"));
-        text->setFontSize(data["fontSize"].toInt(12));
-        obj = text;
-        break;
-    }
-
-    case VectorObjectType::Image: {
-        // Decode base64 image data — use saved format tag if present, PNG for legacy files
-        QByteArray ba = QByteArray::fromBase64(data["imageData"].toString().toLatin1());
-        QString fmt = data["imageFmt"].toString("PNG");
-        QImage image;
-        image.loadFromData(ba, fmt.toLatin1().constData());
-
-        if (data["isTransformable"].toBool(false)) {
-            // Reconstruct as TransformableImageObject
-            auto *timg = new TransformableImageObject(image);
-            timg->setImgSize(data["img_w"].toDouble(image.width()),
-                             data["img_h"].toDouble(image.height()));
-            timg->setPosition(QPointF(data["img_pos_x"].toDouble(0),
-                                      data["img_pos_y"].toDouble(0)));
-            timg->setImgAngle(data["img_angle"].toDouble(0));
-            obj = timg;
-        } else {
-            ImageObject *img = new ImageObject();
-            img->setImage(QPixmap::fromImage(image));
-            obj = img;
-        }
-        break;
-    }
-    }
-
-    if (obj) {
-        // Restore common properties
-        obj->setPos(data["pos_x"].toDouble(), data["pos_y"].toDouble());
-        obj->setRotation(data["rotation"].toDouble());
-        obj->setScale(data["scale"].toDouble(1.0));
-        obj->setStrokeColor(QColor(data["strokeColor"].toString("#000000")));
-        obj->setFillColor(QColor(data["fillColor"].toString("#00000000")));
-        obj->setStrokeWidth(data["strokeWidth"].toDouble(1.0));
-        obj->setObjectOpacity(data["opacity"].toDouble(1.0));
-        obj->setZValue(data["zValue"].toDouble(0.0));
-    }
-
-    return obj;
-}
@@ -7,9 +7,16 @@
 #include <memory>
 #include <QUndoStack>
 #include <QSet>
+#include <QHash>
+#include <QPair>
+#include "io/projectarchive.h"
+#include "io/projectsnapshot.h"
 
 class Layer;
+class VectorObject;
 class Frame;
+class ImageBlobStore;
+class QThread;
 
 class Project : public QObject
 {
@@ -78,10 +85,49 @@ public:
 
     void moveMultipleFrames(const QSet<int>& frames, int delta);
 
+    // zlib effort for frame chunks: Fast = level 1, Balanced = 6, Small = 9.
+    // An application preference (see ProjectSettings), not saved in the file.
+    enum class SaveCompression { Fast, Balanced, Small };
+    SaveCompression saveCompression() const { return m_saveCompression; }
+    void setSaveCompression(SaveCompression compression) { m_saveCompression = compression; }
+    int compressionLevel() const;
+
     // Save/Load
+    // Re-saving to the file the project came from appends a journal record
+    // with just the changed frames; anything else writes a full snapshot.
     bool saveToFile(const QString &filePath);
     bool loadFromFile(const QString &filePath);
 
+    // Decode the archived keyframes shown at the given frames on every layer,
+    // spread over all cores. Frames are otherwise decoded one at a time on
+    // first access; call this before touching many of them at once.
+    void loadFrames(const QList<int> &frames);
+
+    // Keyframes each layer needs to show the given frames: held keyframes
+    // and both ends of tweens included
+    QHash<Layer*, QSet<int>> keyFramesShownAt(const QList<int> &frames) const;
+
+    // Flag the keyframe holding a source object (see layerOfObject()) as
+    // changed. Call after an edit that modified the object in place without
+    // going through Layer.
+    void markObjectDirty(VectorObject *object);
+
+    // Layer holding a source object shown at the current frame, and the
+    // keyframe it belongs to (nullptr if no layer holds it). Child objects
+    // resolve to the group that owns them.
+    Layer* layerOfObject(VectorObject *object, int *keyFrame) const;
+
+    // Copy of the project for saving on a worker thread (see ProjectSnapshot).
+    // With changedFrames only those keyframes are copied, otherwise all of them.
+    std::shared_ptr<ProjectSnapshot> snapshot(
+        const QHash<Layer*, QSet<int>> *changedFrames = nullptr) const;
+
+    // Rebuild a project from a snapshot, e.g. a private copy for rendering.
+    // The project takes over the snapshot's cloned objects (nothing is
+    // cloned again) and leaves the snapshot's frames empty. Frames the
+    // snapshot carries compressed are decoded into pixmaps; like the
+    // rebuild itself, that belongs on the GUI thread.
+    bool loadFromSnapshot(ProjectSnapshot &snapshot);
 
 signals:
     void modified();
@@ -89,8 +135,38 @@ signals:
     void currentLayerChanged(Layer *layer);
     void layersChanged();
     void onionSkinSettingsChanged();
+    // Every layer was replaced: a new project was created or one was loaded
+    void projectLoaded();
 
 private:
+    bool loadFromJson(const QJsonObject &projectObj, std::shared_ptr<ProjectArchive> archive,
+                      ProjectSnapshot *snapshot = nullptr);
+
+    // Saving
+    QJsonObject headerJson() const;
+    ProjectArchive::PendingChunk frameChunk(int layerIndex, int frame, ImageBlobStore &blobs,
+                                            QJsonObject *json) const;
+    QList<ProjectArchive::PendingChunk> encodeFrames(const QList<QPair<int, int>> &frames,
+                                                     ImageBlobStore &blobs, qint64 *rawBytes) const;
+    bool saveSnapshot(const QString &filePath);
+    bool saveJournal();
+    void markSaved(const QString &filePath);
+    bool isArchiveFile(const QString &filePath) const;
+    void detachArchive();
+    void reopenArchive(const QString &filePath);
+    void startCompaction();
+    void finishCompaction();   // blocks until a running compaction is done
+
+    // File the project was last loaded from / saved to (AVG3 only); source
+    // of archived frames and of image blobs that can be copied on save
+    std::shared_ptr<ProjectArchive> m_archive;
+    // Layer list as of that file; journaling requires it to be unchanged
+    QList<Layer*> m_savedLayers;
+    // Snapshots handed out by snapshot(), possibly still being encoded
+    mutable QList<std::weak_ptr<const ProjectSnapshot>> m_snapshots;
+    QThread *m_compactor = nullptr;
+    SaveCompression m_saveCompression = SaveCompression::Balanced;
+
     QString m_name;
     int m_width;
     int m_height;
@@ -0,0 +1,196 @@
+#include "waveformpeaks.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <cmath>
+
+static const quint32 PeaksMagic = 0x41565046;   // "AVPF"
+static const quint32 PeaksVersion = 1;
+
+void WaveformPeaks::setFormat(int channelCount, int sampleRate)
+{
+    m_channels = qMax(1, channelCount);
+    m_sampleRate = qMax(1, sampleRate);
+    m_frameCount = 0;
+    m_levels = { QList<QVector<PeakBucket>>(m_channels) };
+    m_min.fill(0.0f, m_channels);
+    m_max.fill(0.0f, m_channels);
+    m_sumSquares.fill(0.0, m_channels);
+    m_pending = 0;
+}
+
+void WaveformPeaks::addSamples(const float *samples, int frameCount)
+{
+    if (m_levels.isEmpty()) return;
+    for (int i = 0; i < frameCount; ++i) {
+        for (int c = 0; c < m_channels; ++c) {
+            const float s = samples[i * m_channels + c];
+            if (m_pending == 0) {
+                m_min[c] = m_max[c] = s;
+            } else {
+                m_min[c] = qMin(m_min[c], s);
+                m_max[c] = qMax(m_max[c], s);
+            }
+            m_sumSquares[c] += double(s) * s;
+        }
+        ++m_frameCount;
+        if (++m_pending == BaseBucketSize)
+            flushBucket();
+    }
+}
+
+void WaveformPeaks::flushBucket()
+{
+    for (int c = 0; c < m_channels; ++c) {
+        PeakBucket bucket;
+        bucket.min = m_min[c];
+        bucket.max = m_max[c];
+        bucket.rms = float(std::sqrt(m_sumSquares[c] / m_pending));
+        m_levels[0][c].append(bucket);
+        m_sumSquares[c] = 0.0;
+    }
+    m_pending = 0;
+}
+
+void WaveformPeaks::finish()
+{
+    if (m_levels.isEmpty()) return;
+    if (m_pending > 0)
+        flushBucket();
+    buildLevels();
+
+    m_min.clear();
+    m_max.clear();
+    m_sumSquares.clear();
+}
+
+void WaveformPeaks::buildLevels()
+{
+    m_levels.resize(1);
+    // Each level merges LevelFactor buckets of the one below; stop once a
+    // level is only a few buckets wide
+    while (m_levels.last().first().size() > LevelFactor) {
+        const QList<QVector<PeakBucket>> &below = m_levels.last();
+        QList<QVector<PeakBucket>> level(m_channels);
+        for (int c = 0; c < m_channels; ++c) {
+            const QVector<PeakBucket> &src = below[c];
+            QVector<PeakBucket> &dst = level[c];
+            dst.reserve((src.size() + LevelFactor - 1) / LevelFactor);
+            for (int i = 0; i < src.size(); i += LevelFactor) {
+                const int end = qMin(int(src.size()), i + LevelFactor);
+                PeakBucket merged = src[i];
+                double squares = double(src[i].rms) * src[i].rms;
+                for (int j = i + 1; j < end; ++j) {
+                    merged.min = qMin(merged.min, src[j].min);
+                    merged.max = qMax(merged.max, src[j].max);
+                    squares += double(src[j].rms) * src[j].rms;
+                }
+                merged.rms = float(std::sqrt(squares / (end - i)));
+                dst.append(merged);
+            }
+        }
+        m_levels.append(level);
+    }
+}
+
+bool WaveformPeaks::save(const QString &path) const
+{
+    if (m_levels.isEmpty()) return false;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << PeaksMagic << PeaksVersion << qint32(m_channels) << qint32(m_sampleRate)
+        << m_frameCount << qint64(m_levels[0][0].size());
+    for (const QVector<PeakBucket> &channel : m_levels[0]) {
+        for (const PeakBucket &b : channel)
+            out << b.min << b.max << b.rms;
+    }
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool WaveformPeaks::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    quint32 magic = 0, version = 0;
+    qint32 channels = 0, sampleRate = 0;
+    qint64 frameCount = 0, bucketCount = 0;
+    in >> magic >> version >> channels >> sampleRate >> frameCount >> bucketCount;
+    if (in.status() != QDataStream::Ok || magic != PeaksMagic || version != PeaksVersion
+        || channels < 1 || sampleRate < 1 || bucketCount < 1
+        || bucketCount * channels * 12 > file.size())
+        return false;
+
+    QList<QVector<PeakBucket>> level(channels);
+    for (QVector<PeakBucket> &channel : level) {
+        channel.resize(bucketCount);
+        for (PeakBucket &b : channel)
+            in >> b.min >> b.max >> b.rms;
+    }
+    if (in.status() != QDataStream::Ok) return false;
+
+    m_channels = channels;
+    m_sampleRate = sampleRate;
+    m_frameCount = frameCount;
+    m_levels = { level };
+    m_pending = 0;
+    buildLevels();
+    return true;
+}
+
+qint64 WaveformPeaks::bucketSize(int level) const
+{
+    qint64 size = BaseBucketSize;
+    for (int i = 0; i < level; ++i)
+        size *= LevelFactor;
+    return size;
+}
+
+const QVector<PeakBucket> &WaveformPeaks::buckets(int level, int channel) const
+{
+    return m_levels.at(level).at(channel);
+}
+
+int WaveformPeaks::levelFor(double samplesPerPixel) const
+{
+    int level = 0;
+    while (level + 1 < m_levels.size() && bucketSize(level + 1) <= samplesPerPixel)
+        ++level;
+    return level;
+}
+
+PeakBucket WaveformPeaks::peak(int level, int channel, qint64 first, qint64 last) const
+{
+    PeakBucket result;
+    if (m_levels.isEmpty() || level < 0 || level >= m_levels.size()) return result;
+
+    const qint64 size = bucketSize(level);
+    const int firstChannel = channel < 0 ? 0 : channel;
+    const int lastChannel = channel < 0 ? m_channels - 1 : channel;
+    bool any = false;
+    double squares = 0.0;
+    int count = 0;
+    for (int c = firstChannel; c <= lastChannel; ++c) {
+        const QVector<PeakBucket> &levelBuckets = m_levels[level][c];
+        const qint64 from = qMax<qint64>(0, first / size);
+        // A range narrower than a bucket still reads the bucket it falls in
+        const qint64 to = qMin<qint64>(levelBuckets.size(), qMax(from + 1, (last + size - 1) / size));
+        for (qint64 i = from; i < to; ++i) {
+            const PeakBucket &b = levelBuckets[i];
+            result.min = any ? qMin(result.min, b.min) : b.min;
+            result.max = any ? qMax(result.max, b.max) : b.max;
+            squares += double(b.rms) * b.rms;
+            ++count;
+            any = true;
+        }
+    }
+    if (count > 0)
+        result.rms = float(std::sqrt(squares / count));
+    return result;
+}
@@ -0,0 +1,79 @@
+#ifndef WAVEFORMPEAKS_H
+#define WAVEFORMPEAKS_H
+
+#include <QList>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Min/max/RMS summary of one bucket of samples
+ */
+struct PeakBucket {
+    float min = 0.0f;
+    float max = 0.0f;
+    float rms = 0.0f;
+};
+
+/**
+ * @brief Multi-resolution peak pyramid of a decoded audio clip
+ *
+ * Level 0 summarises every 256 sample frames per channel; each level above
+ * merges four buckets of the one below (1024, 4096, ...) until a level fits
+ * in a handful of buckets. Built once while the clip is decoded, it lets
+ * the timeline draw a waveform in O(pixels) at any zoom without aliasing:
+ * every pixel reads the few buckets of the level closest to its width.
+ *
+ * Usage: setFormat(), addSamples() for each decoded buffer, then finish().
+ * A finished pyramid can be saved and loaded again (only level 0 is
+ * stored; the levels above are rebuilt on load).
+ */
+class WaveformPeaks
+{
+public:
+    static constexpr int BaseBucketSize = 256;
+    static constexpr int LevelFactor = 4;
+
+    void setFormat(int channelCount, int sampleRate);
+    // Interleaved samples in [-1, 1]
+    void addSamples(const float *samples, int frameCount);
+    void finish();
+
+    bool save(const QString &path) const;
+    bool load(const QString &path);
+
+    bool isEmpty() const { return m_frameCount == 0; }
+    int channelCount() const { return m_channels; }
+    int sampleRate() const { return m_sampleRate; }
+    qint64 frameCount() const { return m_frameCount; }
+    qint64 durationMs() const { return m_sampleRate > 0 ? m_frameCount * 1000 / m_sampleRate : -1; }
+
+    int levelCount() const { return m_levels.size(); }
+    qint64 bucketSize(int level) const;
+    const QVector<PeakBucket> &buckets(int level, int channel) const;
+
+    // The coarsest level whose buckets are not wider than samplesPerPixel
+    int levelFor(double samplesPerPixel) const;
+
+    /**
+     * @brief Peak of sample frames [first, last) at the given level
+     * @param channel A channel, or -1 for all channels merged
+     */
+    PeakBucket peak(int level, int channel, qint64 first, qint64 last) const;
+
+private:
+    void flushBucket();
+    void buildLevels();
+
+    int m_channels = 0;
+    int m_sampleRate = 0;
+    qint64 m_frameCount = 0;
+    // m_levels[level][channel] -> buckets
+    QList<QList<QVector<PeakBucket>>> m_levels;
+
+    // Level-0 bucket being filled, per channel
+    QVector<float> m_min, m_max;
+    QVector<double> m_sumSquares;
+    int m_pending = 0;
+};
+
+#endif // WAVEFORMPEAKS_H
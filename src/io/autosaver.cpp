@@ -0,0 +1,191 @@
+#include "autosaver.h"
+#include "projectarchive.h"
+#include "projectsnapshot.h"
+#include "imageblobstore.h"
+#include "core/project.h"
+#include "core/layer.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QThread>
+
+Autosaver::Autosaver(Project *project, QObject *parent)
+    : QObject(parent)
+    , m_project(project)
+{
+    connect(&m_timer, &QTimer::timeout, this, &Autosaver::autosaveNow);
+    connect(m_project, &Project::modified, this, &Autosaver::onModified);
+    connect(m_project, &Project::layersChanged, this, &Autosaver::trackLayers);
+    connect(m_project, &Project::projectLoaded, this, &Autosaver::onProjectLoaded);
+    trackLayers();
+
+    QSettings s("AkisVG", "AkisVG");
+    setIntervalMinutes(s.value("autosave/intervalMinutes", 5).toInt());
+}
+
+Autosaver::~Autosaver()
+{
+    // Let a running write finish so the file is never left half-written
+    if (m_worker) {
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+void Autosaver::setIntervalMinutes(int minutes)
+{
+    m_intervalMinutes = qMax(0, minutes);
+    if (m_intervalMinutes == 0) {
+        m_timer.stop();
+        return;
+    }
+    m_timer.start(m_intervalMinutes * 60 * 1000);
+}
+
+void Autosaver::setProjectPath(const QString &path)
+{
+    m_projectPath = path;
+}
+
+QString Autosaver::autosavePath() const
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                        + "/autosave";
+    if (m_projectPath.isEmpty())
+        return dir + "/Untitled.avg";
+
+    // One copy per project file; the path hash keeps same-named projects apart
+    const QFileInfo info(m_projectPath);
+    const QByteArray key = QCryptographicHash::hash(info.absoluteFilePath().toUtf8(),
+                                                    QCryptographicHash::Sha1).toHex().left(8);
+    return QString("%1/%2-%3.avg").arg(dir, info.completeBaseName(), QString::fromLatin1(key));
+}
+
+void Autosaver::trackLayers()
+{
+    for (Layer *layer : m_project->layers()) {
+        connect(layer, &Layer::frameChanged, this, &Autosaver::onFrameChanged,
+                Qt::UniqueConnection);
+        connect(layer, &Layer::modified, this, &Autosaver::onModified,
+                Qt::UniqueConnection);
+    }
+}
+
+void Autosaver::onProjectLoaded()
+{
+    // The old layers are gone; their pointers may be reused by new ones, so
+    // nothing tracked for them can carry over. The next autosave is full.
+    m_changedFrames.clear();
+    m_savedLayers.clear();
+    m_savedPath.clear();
+}
+
+void Autosaver::onFrameChanged(int frameNumber)
+{
+    if (Layer *layer = qobject_cast<Layer*>(sender()))
+        m_changedFrames[layer].insert(frameNumber);
+    m_modified = true;
+}
+
+void Autosaver::autosaveNow()
+{
+    if (m_worker || (!m_modified && m_changedFrames.isEmpty()))
+        return;
+
+    const QString path = autosavePath();
+    const bool full = path != m_savedPath || m_project->layers() != m_savedLayers;
+
+    QElapsedTimer timer;
+    timer.start();
+    m_snapshot = m_project->snapshot(full ? nullptr : &m_changedFrames);
+    m_blockedMs = timer.elapsed();
+
+    // Edits made from here on belong to the next autosave
+    m_changedFrames.clear();
+    m_modified = false;
+    m_savedPath = path;
+    m_savedLayers = m_project->layers();
+    trackLayers();
+
+    auto snapshot = m_snapshot;
+    auto result = std::make_shared<Result>();
+    m_result = result;
+    m_workerPath = path;
+    m_worker = QThread::create([snapshot, result, path, full]() {
+        run(*snapshot, path, full, *result);
+    });
+    connect(m_worker, &QThread::finished, this, &Autosaver::finishWorker);
+    m_worker->start(QThread::LowPriority);
+}
+
+void Autosaver::run(const ProjectSnapshot &snapshot, const QString &path,
+                    bool full, Result &result)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ImageBlobStore blobs(snapshot.source);
+    const QList<ProjectArchive::PendingChunk> chunks = snapshot.encode(blobs);
+
+    if (full) {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        result.ok = ProjectArchive::write(path, snapshot.header, chunks, blobs.blobs(),
+                                          &result.error);
+        result.bytes = QFileInfo(path).size();
+    } else {
+        ProjectArchive file;
+        if (!file.open(path)) {
+            result.error = file.lastError();
+            return;
+        }
+        QHash<QByteArray, QByteArray> newBlobs;
+        const QHash<QByteArray, QByteArray> &allBlobs = blobs.blobs();
+        for (auto it = allBlobs.constBegin(); it != allBlobs.constEnd(); ++it) {
+            if (!file.hasBlob(it.key()))
+                newBlobs.insert(it.key(), it.value());
+        }
+        result.ok = file.appendJournal(snapshot.header, chunks, newBlobs, &result.error);
+        result.bytes = QFileInfo(path).size() - file.validSize();
+
+        // Same policy as Project: fold a long journal into a new snapshot
+        bool compact = false;
+        if (result.ok) {
+            ProjectArchive appended;   // closed again before compact() replaces the file
+            compact = appended.open(path) && appended.journalNeedsCompaction();
+        }
+        if (compact) {
+            if (ProjectArchive::compact(path, &result.error))
+                result.bytes += QFileInfo(path).size();
+            else
+                qWarning() << "Autosave compaction failed:" << result.error;
+        }
+    }
+    result.ms = timer.elapsed();
+}
+
+void Autosaver::finishWorker()
+{
+    if (!m_worker) return;
+    m_worker->wait();
+    m_worker->deleteLater();
+    m_worker = nullptr;
+    // Clones are released here, on the GUI thread
+    m_snapshot.reset();
+
+    const Result result = *m_result;
+    m_result.reset();
+    if (!result.ok) {
+        // The file may not hold what we think; start over with a full write
+        m_savedPath.clear();
+        m_modified = true;
+        qWarning() << "Autosave failed:" << result.error;
+        emit autosaveFailed(result.error);
+        return;
+    }
+    emit autosaved(m_workerPath, result.bytes, m_blockedMs, m_blockedMs + result.ms);
+}
@@ -0,0 +1,98 @@
+#ifndef AUTOSAVER_H
+#define AUTOSAVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <memory>
+
+class Project;
+class Layer;
+class ProjectSnapshot;
+class QThread;
+
+/**
+ * @brief Periodically saves a recovery copy of the project in the background
+ *
+ * On each tick only a ProjectSnapshot is taken on the GUI thread; encoding,
+ * compression, the write and its fsync happen on a worker thread. The
+ * first autosave (and any after a layer was added, removed or moved)
+ * writes a full AVG3 file; later ones append a journal record holding just
+ * the keyframes changed since the previous autosave.
+ *
+ * The copy lives under the application data directory, never next to the
+ * user's file, so an autosave can not clobber a real save.
+ */
+class Autosaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Autosaver(Project *project, QObject *parent = nullptr);
+    ~Autosaver();
+
+    // Minutes between autosaves; 0 turns autosaving off
+    int intervalMinutes() const { return m_intervalMinutes; }
+    void setIntervalMinutes(int minutes);
+
+    // File the project is saved as (empty for an untitled project)
+    void setProjectPath(const QString &path);
+    QString autosavePath() const;
+
+    bool isRunning() const { return m_worker != nullptr; }
+
+public slots:
+    // Starts an autosave unless one is running or nothing changed
+    void autosaveNow();
+
+signals:
+    /**
+     * @param bytesWritten Bytes added to (or rewritten in) the autosave file
+     * @param blockedMs Time the GUI thread spent taking the snapshot
+     * @param totalMs Snapshot plus background encode/write time
+     */
+    void autosaved(const QString &path, qint64 bytesWritten, qint64 blockedMs, qint64 totalMs);
+    void autosaveFailed(const QString &error);
+
+private slots:
+    void onFrameChanged(int frameNumber);
+    void onModified() { m_modified = true; }
+    void trackLayers();
+    void onProjectLoaded();
+    void finishWorker();
+
+private:
+    struct Result {
+        bool    ok = false;
+        QString error;
+        qint64  bytes = 0;
+        qint64  ms = 0;
+    };
+
+    static void run(const ProjectSnapshot &snapshot, const QString &path,
+                    bool full, Result &result);
+
+    Project *m_project;
+    QTimer m_timer;
+    int m_intervalMinutes = 5;
+    QString m_projectPath;
+
+    // Changes since the last autosave
+    QHash<Layer*, QSet<int>> m_changedFrames;
+    bool m_modified = false;
+    // What the autosave file currently holds; a journal record is only
+    // valid on top of the same file with the same layer list
+    QString m_savedPath;
+    QList<Layer*> m_savedLayers;
+
+    QThread *m_worker = nullptr;
+    std::shared_ptr<ProjectSnapshot> m_snapshot;
+    std::shared_ptr<Result> m_result;
+    QString m_workerPath;
+    qint64 m_blockedMs = 0;
+};
+
+#endif // AUTOSAVER_H
@@ -0,0 +1,295 @@
+#include "exportjob.h"
+#include "exportmanifest.h"
+#include "ffmpegpipe.h"
+#include "framerenderer.h"
+#include "projectsnapshot.h"
+#include "core/project.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QThread>
+
+ExportJob::ExportJob(Project *project, const Settings &settings, QObject *parent)
+    : QObject(parent)
+    , m_settings(settings)
+{
+    // Decode first (in parallel) so the snapshot holds plain clones; image
+    // objects get their pixmaps here, on the GUI thread
+    project->loadFrames(settings.frames);
+    const QHash<Layer*, QSet<int>> keyFrames = project->keyFramesShownAt(settings.frames);
+    m_snapshot = project->snapshot(&keyFrames);
+
+    // A private copy, nothing here is reachable from the editor. It adopts
+    // the clones, so building it costs no more than the header.
+    m_project = std::make_unique<Project>();
+    if (!m_project->loadFromSnapshot(*m_snapshot))
+        m_project.reset();
+}
+
+ExportJob::~ExportJob()
+{
+    if (m_worker) {
+        m_cancelled = true;
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+QString ExportJob::displayName() const
+{
+    return QFileInfo(m_settings.outputPath).fileName();
+}
+
+void ExportJob::start()
+{
+    if (m_worker || m_finished) return;
+    m_worker = QThread::create([this]() { run(); });
+    connect(m_worker, &QThread::finished, this, &ExportJob::finishWorker);
+    m_worker->start(QThread::LowPriority);
+}
+
+void ExportJob::cancel()
+{
+    m_cancelled = true;
+}
+
+void ExportJob::finishWorker()
+{
+    if (!m_worker) return;
+    m_worker->wait();
+    m_worker->deleteLater();
+    m_worker = nullptr;
+    // Clones are released here, on the GUI thread
+    m_project.reset();
+    m_snapshot.reset();
+    m_finished = true;
+    if (m_cancelled && m_error.isEmpty())
+        m_error = "Cancelled";
+    emit finished(m_ok && !m_cancelled);
+}
+
+void ExportJob::reportProgress(int count)
+{
+    m_done += count;
+    emit progress(m_done, m_settings.frames.size());
+}
+
+void ExportJob::run()
+{
+    if (m_settings.frames.isEmpty()) {
+        m_error = "No frames to export";
+        return;
+    }
+
+    if (!m_project) {
+        m_error = "Could not copy the project for export";
+        return;
+    }
+
+    switch (m_settings.kind) {
+    case Kind::Video:       m_ok = renderVideo(*m_project);       break;
+    case Kind::Gif:         m_ok = renderGif(*m_project);         break;
+    case Kind::PngSequence: m_ok = renderPngSequence(*m_project); break;
+    }
+}
+
+bool ExportJob::renderVideo(Project &project)
+{
+    FrameRenderer renderer(&project);
+    renderer.setPixmapImages(&m_snapshot->pixmapImages);
+    renderer.setOutputSize(m_settings.outputSize);
+    renderer.setSupersampling(m_settings.supersampling);
+    renderer.setDraft(m_settings.draft);
+    renderer.prepare(m_settings.frames);
+    const QList<QByteArray> hashes = renderer.frameHashes(m_settings.frames);
+
+    // The video is encoded in segments of a few seconds, each starting on a
+    // keyframe, kept in the cache directory with a hash of what they show. A
+    // re-export encodes only the segments whose frames changed and joins
+    // the rest by stream copy.
+    const QString cacheDir = ExportManifest::videoCacheDir(m_settings.outputPath);
+    if (!QDir().mkpath(cacheDir)) {
+        m_error = "Could not create " + cacheDir;
+        return false;
+    }
+    const QString manifestPath = cacheDir + "/manifest.json";
+    ExportManifest manifest;
+    manifest.load(manifestPath);
+
+    QString suffix = QFileInfo(m_settings.outputPath).suffix().toLower();
+    if (suffix.isEmpty()) suffix = "mp4";
+    const QByteArray encoding = QString("%1|%2|").arg(m_settings.videoArgs.join(' '))
+                                    .arg(m_settings.fps).toUtf8();
+    const int segmentLength = qMax(1, m_settings.fps * VideoSegmentSeconds);
+
+    QStringList parts;
+    bool ok = true;
+    for (int start = 0; ok && start < m_settings.frames.size(); start += segmentLength) {
+        const int index = parts.size();
+        const QList<int> frames = m_settings.frames.mid(start, segmentLength);
+        const QList<QByteArray> frameHashes = hashes.mid(start, frames.size());
+        const QString part = QString("%1/part_%2.%3").arg(cacheDir)
+                                 .arg(index, 5, 10, QChar('0')).arg(suffix);
+        parts.append(part);
+
+        QCryptographicHash key(QCryptographicHash::Sha1);
+        key.addData(encoding);
+        for (const QByteArray &hash : frameHashes)
+            key.addData(hash);
+        const QByteArray segmentHash = key.result();
+        if (manifest.hash(index) == segmentHash && QFile::exists(part)) {
+            reportProgress(frames.size());
+            continue;
+        }
+
+        manifest.remove(index);
+        ok = encodeSegment(renderer, frames, frameHashes, part);
+        if (ok) manifest.setHash(index, segmentHash);
+    }
+
+    // Segments past the end belong to a longer earlier export
+    for (int index = parts.size(); manifest.hash(index).size() > 0; ++index) {
+        manifest.remove(index);
+        QFile::remove(QString("%1/part_%2.%3").arg(cacheDir)
+                          .arg(index, 5, 10, QChar('0')).arg(suffix));
+    }
+    manifest.save(manifestPath);
+
+    if (!ok || m_cancelled) return false;
+    return FfmpegPipe::concatenate(parts, m_settings.outputPath, &m_error);
+}
+
+bool ExportJob::encodeSegment(const FrameRenderer &renderer, const QList<int> &frames,
+                              const QList<QByteArray> &hashes, const QString &path)
+{
+    FfmpegPipe ffmpeg;
+    if (!ffmpeg.start(renderer.outputSize(), m_settings.fps,
+                      QStringList(m_settings.videoArgs) << path)) {
+        m_error = ffmpeg.lastError();
+        return false;
+    }
+
+    // A held drawing is painted once and its pixels sent for every frame
+    // of the hold
+    const bool ok = renderer.renderRuns(renderer.identityRuns(frames, hashes),
+        [&](const FrameRenderer::Run &run, const QImage &image, const QByteArray &) {
+            for (int i = 0; i < run.frames.size(); ++i) {
+                if (m_cancelled || !ffmpeg.writeFrame(image))
+                    return false;
+            }
+            reportProgress(run.frames.size());
+            return true;
+        });
+
+    if (m_cancelled) {
+        ffmpeg.cancel();
+        QFile::remove(path);
+        return false;
+    }
+    if (!ffmpeg.finish() || !ok) {
+        m_error = ffmpeg.lastError().right(2000);
+        QFile::remove(path);
+        return false;
+    }
+    return true;
+}
+
+bool ExportJob::renderGif(Project &project)
+{
+    FrameRenderer renderer(&project);
+    renderer.setPixmapImages(&m_snapshot->pixmapImages);
+    renderer.setOutputSize(m_settings.outputSize);
+    renderer.setSupersampling(m_settings.supersampling);
+    renderer.setDraft(m_settings.draft);
+
+    GifEncoder encoder;
+    if (!encoder.open(m_settings.outputPath, renderer.outputSize(), m_settings.gif)) {
+        m_error = encoder.lastError();
+        return false;
+    }
+
+    renderer.prepare(m_settings.frames);
+    bool ok = renderer.renderRuns(renderer.identityRuns(m_settings.frames),
+        [&](const FrameRenderer::Run &run, const QImage &image, const QByteArray &) {
+            if (m_cancelled
+                || !encoder.addFrame(image, m_settings.gifFrameDelayMs * run.frames.size()))
+                return false;
+            reportProgress(run.frames.size());
+            return true;
+        });
+    if (!ok && !m_cancelled)
+        m_error = encoder.lastError();
+    ok = encoder.close() && ok;
+    if (!ok && m_error.isEmpty())
+        m_error = encoder.lastError();
+    if (m_cancelled)
+        QFile::remove(m_settings.outputPath);
+    return ok;
+}
+
+bool ExportJob::renderPngSequence(Project &project)
+{
+    if (!QDir().mkpath(m_settings.outputPath)) {
+        m_error = "Could not create " + m_settings.outputPath;
+        return false;
+    }
+
+    FrameRenderer renderer(&project);
+    renderer.setPixmapImages(&m_snapshot->pixmapImages);
+    renderer.setOutputSize(m_settings.outputSize);
+    renderer.setSupersampling(m_settings.supersampling);
+    renderer.setDraft(m_settings.draft);
+    renderer.prepare(m_settings.frames);
+    const QList<QByteArray> hashes = renderer.frameHashes(m_settings.frames);
+
+    // Files whose manifest hash still matches are left alone; only frames
+    // that changed (or went missing) are rendered again
+    const QString manifestPath = ExportManifest::pngSequencePath(m_settings.outputPath);
+    ExportManifest manifest;
+    manifest.load(manifestPath);
+    QHash<int, QByteArray> hashOf;
+    for (int i = 0; i < m_settings.frames.size(); ++i)
+        hashOf.insert(m_settings.frames.at(i), hashes.at(i));
+
+    QList<FrameRenderer::Run> runs;
+    int unchanged = 0;
+    for (const FrameRenderer::Run &run : renderer.identityRuns(m_settings.frames, hashes)) {
+        // Any frame of a run renders the same, so the stale ones form a
+        // run of their own
+        FrameRenderer::Run stale;
+        for (int frame : run.frames) {
+            if (manifest.hash(frame) != hashOf.value(frame)
+                || !QFile::exists(FrameRenderer::sequenceFileName(m_settings.outputPath, frame)))
+                stale.frames.append(frame);
+        }
+        unchanged += run.frames.size() - stale.frames.size();
+        if (!stale.frames.isEmpty())
+            runs.append(stale);
+    }
+    if (unchanged > 0)
+        reportProgress(unchanged);
+
+    // PNG compression runs on the render threads; held frames are linked
+    // to (or copied from) the first file of the hold
+    const bool ok = renderer.renderRuns(runs,
+        [&](const FrameRenderer::Run &run, const QImage &, const QByteArray &png) {
+            if (m_cancelled) return false;
+            for (int frame : run.frames)
+                manifest.remove(frame);
+            if (!FrameRenderer::writeSequenceFiles(m_settings.outputPath, run.frames, png, &m_error))
+                return false;
+            for (int frame : run.frames)
+                manifest.setHash(frame, hashOf.value(frame));
+            reportProgress(run.frames.size());
+            return true;
+        }, &FrameRenderer::encodePng);
+
+    // Also after a cancel: what was written is reused next time
+    if (!manifest.save(manifestPath))
+        qWarning() << "ExportJob: could not write" << manifestPath;
+    return ok;
+}
@@ -0,0 +1,107 @@
+#ifndef EXPORTJOB_H
+#define EXPORTJOB_H
+
+#include <QList>
+#include <QObject>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+
+#include "gifencoder.h"
+
+class FrameRenderer;
+class Project;
+class ProjectSnapshot;
+class QThread;
+
+/**
+ * @brief One export (video, GIF or PNG sequence) rendered in the background
+ *
+ * The constructor takes a ProjectSnapshot of just the keyframes the export
+ * shows; that is the only time the live project is touched. A private
+ * project takes over the snapshot's clones right there, on the GUI thread,
+ * so the worker started by start() never creates an item or a pixmap: it
+ * renders and encodes with FrameRenderer, painting images from the
+ * snapshot's QImage copies, while the user keeps editing. Progress and the
+ * result arrive as queued signals.
+ *
+ * Re-exports to the same place are incremental: an ExportManifest records
+ * a content hash per PNG frame or video segment, and only what changed
+ * since is rendered and encoded again.
+ *
+ * Jobs are normally created and run one after another by ExportQueue.
+ */
+class ExportJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Kind {
+        Video,
+        Gif,
+        PngSequence
+    };
+
+    struct Settings {
+        Kind kind = Kind::Video;
+        QString outputPath;           // file, or the directory of a PNG sequence
+        QList<int> frames;            // in playback order
+        QSize outputSize;             // empty = project size
+        int supersampling = 1;
+        bool draft = false;
+
+        int fps = 24;                 // video
+        QStringList videoArgs;        // ffmpeg output options, the path is appended
+
+        int gifFrameDelayMs = 1000 / 24;
+        GifEncoder::Options gif;
+    };
+
+    ExportJob(Project *project, const Settings &settings, QObject *parent = nullptr);
+    ~ExportJob();   // cancels a running job and waits for it
+
+    const Settings &settings() const { return m_settings; }
+    QString displayName() const;
+
+    void start();
+    bool isRunning() const { return m_worker != nullptr; }
+    bool isFinished() const { return m_finished; }
+
+    // Returns at once; the worker stops at the next frame and finished(false)
+    // follows. A partly written GIF is removed; a video's finished segments
+    // are kept for the next export and the output file is left untouched.
+    void cancel();
+    bool isCancelled() const { return m_cancelled; }
+
+    QString lastError() const { return m_error; }
+
+signals:
+    void progress(int framesDone, int totalFrames);
+    void finished(bool ok);
+
+private:
+    void run();   // worker thread
+    bool renderVideo(Project &project);
+    bool encodeSegment(const FrameRenderer &renderer, const QList<int> &frames,
+                       const QList<QByteArray> &hashes, const QString &path);
+    bool renderGif(Project &project);
+    bool renderPngSequence(Project &project);
+    void reportProgress(int count);
+    void finishWorker();
+
+    static constexpr int VideoSegmentSeconds = 2;
+
+    Settings m_settings;
+    std::shared_ptr<ProjectSnapshot> m_snapshot;   // keeps pixmapImages
+    std::unique_ptr<Project> m_project;           // owns the snapshot's clones
+    QThread *m_worker = nullptr;
+    std::atomic<bool> m_cancelled{false};
+    int m_done = 0;                   // worker only
+    bool m_ok = false;                // written by the worker, read after it ends
+    QString m_error;
+    bool m_finished = false;
+};
+
+#endif // EXPORTJOB_H
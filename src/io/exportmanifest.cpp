@@ -0,0 +1,61 @@
+#include "exportmanifest.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+static const int kManifestVersion = 1;
+
+bool ExportManifest::load(const QString &path)
+{
+    m_hashes.clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root["version"].toInt() != kManifestVersion) return false;
+
+    const QJsonObject hashes = root["hashes"].toObject();
+    for (auto it = hashes.constBegin(); it != hashes.constEnd(); ++it) {
+        bool ok = false;
+        const int key = it.key().toInt(&ok);
+        if (ok) m_hashes.insert(key, QByteArray::fromHex(it.value().toString().toLatin1()));
+    }
+    return true;
+}
+
+bool ExportManifest::save(const QString &path) const
+{
+    QJsonObject hashes;
+    for (auto it = m_hashes.constBegin(); it != m_hashes.constEnd(); ++it)
+        hashes[QString::number(it.key())] = QString::fromLatin1(it.value().toHex());
+
+    QJsonObject root;
+    root["version"] = kManifestVersion;
+    root["hashes"] = hashes;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+QString ExportManifest::pngSequencePath(const QString &dir)
+{
+    return dir + "/.akisvg-export.json";
+}
+
+QString ExportManifest::videoCacheDir(const QString &videoPath)
+{
+    // Out of the user's folder; the path hash keeps same-named videos apart
+    const QFileInfo info(videoPath);
+    const QByteArray key = QCryptographicHash::hash(info.absoluteFilePath().toUtf8(),
+                                                    QCryptographicHash::Sha1).toHex().left(8);
+    return QString("%1/export/%2-%3")
+        .arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation),
+             info.completeBaseName(), QString::fromLatin1(key));
+}
@@ -0,0 +1,39 @@
+#ifndef EXPORTMANIFEST_H
+#define EXPORTMANIFEST_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+/**
+ * @brief Content hashes of what a previous export wrote
+ *
+ * A PNG sequence keeps its manifest in the output directory; a video keeps
+ * it with its encoded segments in the application's cache directory.
+ *
+ * A re-export compares FrameRenderer::frameHashes() against it and only
+ * renders what changed. Entries are keyed by frame number for PNG
+ * sequences and by segment index for videos. A missing or unreadable
+ * manifest just means everything counts as changed.
+ */
+class ExportManifest
+{
+public:
+    bool load(const QString &path);
+    bool save(const QString &path) const;   // atomic (QSaveFile)
+
+    QByteArray hash(int key) const { return m_hashes.value(key); }
+    void setHash(int key, const QByteArray &hash) { m_hashes.insert(key, hash); }
+    void remove(int key) { m_hashes.remove(key); }
+
+    // dir/.akisvg-export.json
+    static QString pngSequencePath(const QString &dir);
+    // <cache>/export/<name>-<hash>/: the encoded segments and their manifest,
+    // one directory per output file
+    static QString videoCacheDir(const QString &videoPath);
+
+private:
+    QHash<int, QByteArray> m_hashes;
+};
+
+#endif // EXPORTMANIFEST_H
@@ -0,0 +1,66 @@
+#include "exportqueue.h"
+
+ExportQueue::ExportQueue(Project *project, QObject *parent)
+    : QObject(parent)
+    , m_project(project)
+{
+}
+
+ExportQueue::~ExportQueue()
+{
+    // Jobs are children; deleting a running one cancels and waits for it
+    qDeleteAll(m_pending);
+    m_pending.clear();
+    delete m_current;
+    m_current = nullptr;
+}
+
+ExportJob *ExportQueue::enqueue(const ExportJob::Settings &settings)
+{
+    ExportJob *job = new ExportJob(m_project, settings, this);
+    m_pending.append(job);
+    emit queueChanged();
+    if (!m_current)
+        startNext();
+    return job;
+}
+
+void ExportQueue::cancelCurrent()
+{
+    if (m_current)
+        m_current->cancel();
+}
+
+void ExportQueue::cancelAll()
+{
+    if (!m_pending.isEmpty()) {
+        qDeleteAll(m_pending);
+        m_pending.clear();
+        emit queueChanged();
+    }
+    cancelCurrent();
+}
+
+void ExportQueue::startNext()
+{
+    if (m_pending.isEmpty()) return;
+    m_current = m_pending.takeFirst();
+    connect(m_current, &ExportJob::progress, this, [this](int done, int total) {
+        if (m_current) emit jobProgress(m_current, done, total);
+    });
+    connect(m_current, &ExportJob::finished, this, &ExportQueue::onJobFinished);
+    emit jobStarted(m_current);
+    emit queueChanged();
+    m_current->start();
+}
+
+void ExportQueue::onJobFinished(bool ok)
+{
+    ExportJob *job = m_current;
+    m_current = nullptr;
+    emit jobFinished(job, ok);
+    job->deleteLater();
+    startNext();
+    if (!m_current)
+        emit queueChanged();
+}
@@ -0,0 +1,52 @@
+#ifndef EXPORTQUEUE_H
+#define EXPORTQUEUE_H
+
+#include <QList>
+#include <QObject>
+
+#include "exportjob.h"
+
+/**
+ * @brief Runs ExportJobs in the background, one at a time
+ *
+ * Each job already renders on every core, so running them side by side
+ * would only interleave them. A job's snapshot is taken when it is
+ * enqueued, so it exports the project as it was at that moment even if it
+ * waits behind other jobs while the user keeps editing.
+ */
+class ExportQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ExportQueue(Project *project, QObject *parent = nullptr);
+    ~ExportQueue();
+
+    // Snapshots the project now and runs the job when its turn comes
+    ExportJob *enqueue(const ExportJob::Settings &settings);
+
+    ExportJob *currentJob() const { return m_current; }
+    int pendingCount() const { return m_pending.size(); }
+    bool isBusy() const { return m_current != nullptr; }
+
+public slots:
+    void cancelCurrent();
+    void cancelAll();
+
+signals:
+    void jobStarted(ExportJob *job);
+    void jobProgress(ExportJob *job, int framesDone, int totalFrames);
+    // The job is deleted after this returns
+    void jobFinished(ExportJob *job, bool ok);
+    void queueChanged();
+
+private:
+    void startNext();
+    void onJobFinished(bool ok);
+
+    Project *m_project;
+    QList<ExportJob*> m_pending;
+    ExportJob *m_current = nullptr;
+};
+
+#endif // EXPORTQUEUE_H
@@ -0,0 +1,234 @@
+#include "ffmpegpipe.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QThread>
+
+FfmpegPipe::FfmpegPipe(int maxQueuedFrames)
+    : m_maxQueued(qMax(1, maxQueuedFrames))
+{
+}
+
+FfmpegPipe::~FfmpegPipe()
+{
+    if (m_writer)
+        cancel();
+}
+
+QString FfmpegPipe::findFfmpeg()
+{
+    // QProcess does not go through a shell, so resolve the binary ourselves
+    QString bin = QStandardPaths::findExecutable("ffmpeg");
+    if (bin.isEmpty()) {
+        for (const char *p : {"/usr/bin/ffmpeg", "/usr/local/bin/ffmpeg", "/bin/ffmpeg"})
+            if (QFile::exists(p)) { bin = p; break; }
+    }
+    return bin;
+}
+
+bool FfmpegPipe::concatenate(const QStringList &parts, const QString &outputPath,
+                             QString *error)
+{
+    const QString program = findFfmpeg();
+    if (program.isEmpty()) {
+        if (error) *error = "ffmpeg was not found";
+        return false;
+    }
+    if (parts.isEmpty()) {
+        if (error) *error = "Nothing to join";
+        return false;
+    }
+
+    // Entries are relative to the list file; quotes are escaped ffmpeg-style
+    const QFileInfo first(parts.first());
+    QFile list(first.absolutePath() + "/concat.txt");
+    if (!list.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = "Could not write " + list.fileName();
+        return false;
+    }
+    for (const QString &part : parts) {
+        QString name = QFileInfo(part).fileName();
+        name.replace("'", "'\\''");
+        list.write(QString("file '%1'\n").arg(name).toUtf8());
+    }
+    list.close();
+
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(program, {"-y", "-loglevel", "error", "-f", "concat", "-safe", "0",
+                            "-i", list.fileName(), "-c", "copy", outputPath});
+    if (!process.waitForStarted(5000) || !process.waitForFinished(-1)
+        || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        if (error) {
+            *error = QString("ffmpeg could not join the video parts.\n\n%1")
+                         .arg(QString::fromLocal8Bit(process.readAll().right(4000)));
+        }
+        return false;
+    }
+    return true;
+}
+
+bool FfmpegPipe::start(const QSize &frameSize, int fps, const QStringList &outputArgs)
+{
+    const QString program = findFfmpeg();
+    if (program.isEmpty()) {
+        m_lastError = "ffmpeg was not found.\n\nInstall it with:  sudo pacman -S ffmpeg";
+        return false;
+    }
+
+    m_frameSize = frameSize;
+    // Format_ARGB32 is B, G, R, A in memory on little-endian machines
+    const char *pixelFormat = QSysInfo::ByteOrder == QSysInfo::LittleEndian ? "bgra" : "argb";
+
+    QStringList args;
+    args << "-y"
+         << "-loglevel"  << "error"
+         << "-f"         << "rawvideo"
+         << "-pix_fmt"   << pixelFormat
+         << "-s"         << QString("%1x%2").arg(frameSize.width()).arg(frameSize.height())
+         << "-framerate" << QString::number(qMax(1, fps))
+         << "-i"         << "-"
+         << outputArgs;
+
+    m_writer = QThread::create([this, program, args]() { runWriter(program, args); });
+    m_writer->start();
+    return true;
+}
+
+bool FfmpegPipe::writeFrame(const QImage &frame)
+{
+    if (frame.size() != m_frameSize) {
+        fail(QString("Frame is %1x%2, expected %3x%4")
+                 .arg(frame.width()).arg(frame.height())
+                 .arg(m_frameSize.width()).arg(m_frameSize.height()));
+        return false;
+    }
+    // Rendered frames are opaque, where premultiplied and straight alpha
+    // are the same bytes; anything else is converted
+    const QImage pixels = (frame.format() == QImage::Format_ARGB32
+                           || frame.format() == QImage::Format_ARGB32_Premultiplied
+                           || frame.format() == QImage::Format_RGB32)
+                              ? frame : frame.convertToFormat(QImage::Format_ARGB32);
+
+    QMutexLocker lock(&m_mutex);
+    while (m_queue.size() >= m_maxQueued && !m_failed && !m_cancelled)
+        m_frameTaken.wait(&m_mutex);
+    if (m_failed || m_cancelled || !m_writer)
+        return false;
+    m_queue.enqueue(pixels);
+    m_frameQueued.wakeOne();
+    return true;
+}
+
+bool FfmpegPipe::finish()
+{
+    if (!m_writer) return false;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_closed = true;
+        m_frameQueued.wakeOne();
+    }
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+
+    QMutexLocker lock(&m_mutex);
+    return !m_failed;
+}
+
+void FfmpegPipe::cancel()
+{
+    if (!m_writer) return;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_cancelled = true;
+        m_queue.clear();
+        m_frameQueued.wakeOne();
+        m_frameTaken.wakeAll();
+    }
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+}
+
+QString FfmpegPipe::lastError() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_lastError;
+}
+
+void FfmpegPipe::fail(const QString &error)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_failed) m_lastError = error;
+    m_failed = true;
+    m_queue.clear();
+    m_frameTaken.wakeAll();
+}
+
+void FfmpegPipe::runWriter(const QString &program, const QStringList &args)
+{
+    // The process lives on this thread; QProcess's blocking calls drain
+    // ffmpeg's output as they wait, so it never stalls on a full stderr
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(program, args);
+    if (!process.waitForStarted(5000)) {
+        fail(QString("Failed to launch ffmpeg:\n%1\n\n%2").arg(program, process.errorString()));
+        return;
+    }
+
+    QByteArray log;
+    auto keepLog = [&]() { log = (log + process.readAll()).right(4000); };
+
+    for (;;) {
+        QImage frame;
+        {
+            QMutexLocker lock(&m_mutex);
+            while (m_queue.isEmpty() && !m_closed && !m_cancelled)
+                m_frameQueued.wait(&m_mutex);
+            if (m_cancelled) break;
+            if (m_queue.isEmpty()) break;   // finish(): everything written
+            frame = m_queue.dequeue();
+            m_frameTaken.wakeOne();
+        }
+
+        process.write(reinterpret_cast<const char *>(frame.constBits()), frame.sizeInBytes());
+        // Wait until the pipe has taken the whole frame. The pipe only holds
+        // as much as ffmpeg reads, so this paces the writer to the encoder.
+        while (process.bytesToWrite() > 0) {
+            if (process.waitForBytesWritten(100)) continue;
+            if (process.state() != QProcess::Running) {
+                keepLog();
+                fail(QString("ffmpeg stopped while receiving frames.\n\n%1")
+                         .arg(QString::fromLocal8Bit(log)));
+                return;
+            }
+            QMutexLocker lock(&m_mutex);
+            if (m_cancelled) break;
+        }
+        keepLog();
+    }
+
+    bool cancelled;
+    {
+        QMutexLocker lock(&m_mutex);
+        cancelled = m_cancelled;
+    }
+    if (cancelled) {
+        process.kill();
+        process.waitForFinished(-1);
+        return;
+    }
+
+    process.closeWriteChannel();
+    process.waitForFinished(-1);
+    keepLog();
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        fail(QString("ffmpeg exited %1.\n\n%2")
+                 .arg(process.exitCode()).arg(QString::fromLocal8Bit(log)));
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef FFMPEGPIPE_H
+#define FFMPEGPIPE_H
+
+#include <QImage>
+#include <QMutex>
+#include <QQueue>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+
+class QThread;
+
+/**
+ * @brief Feeds rendered frames to an ffmpeg process over its stdin
+ *
+ * Frames go in as raw 32-bit pixels (-f rawvideo -pix_fmt bgra), so
+ * nothing is PNG-encoded, written to disk or decoded again. A writer
+ * thread owns the QProcess and pushes frames into the pipe while the
+ * caller renders the next ones; writeFrame() blocks once a few frames are
+ * queued, so a slow encoder throttles rendering instead of letting memory
+ * grow. There is no overall timeout: long exports simply take long.
+ *
+ * Usage: start(), writeFrame() for each frame in order, then finish()
+ * (or cancel()).
+ */
+class FfmpegPipe
+{
+public:
+    explicit FfmpegPipe(int maxQueuedFrames = 4);
+    ~FfmpegPipe();   // cancels an export that was not finished
+
+    FfmpegPipe(const FfmpegPipe &) = delete;
+    FfmpegPipe &operator=(const FfmpegPipe &) = delete;
+
+    /**
+     * @brief Locate the ffmpeg binary (empty if not installed)
+     */
+    static QString findFfmpeg();
+
+    /**
+     * @brief Join files encoded with the same options into one, without
+     *        re-encoding (ffmpeg's concat demuxer, stream copy)
+     *
+     * Blocks until ffmpeg is done. The list file goes next to the first part.
+     */
+    static bool concatenate(const QStringList &parts, const QString &outputPath,
+                            QString *error = nullptr);
+
+    /**
+     * @brief Launch ffmpeg reading frames of the given size from stdin
+     * @param outputArgs Everything after the input: filters, codec
+     *                   options and the output path
+     */
+    bool start(const QSize &frameSize, int fps, const QStringList &outputArgs);
+
+    /**
+     * @brief Queue the next frame; blocks while the queue is full
+     * @return false once ffmpeg has failed (see lastError())
+     */
+    bool writeFrame(const QImage &frame);
+
+    /**
+     * @brief Close ffmpeg's input and wait until it has written the file
+     */
+    bool finish();
+
+    // Stop ffmpeg and drop anything still queued
+    void cancel();
+
+    QString lastError() const;
+
+private:
+    void runWriter(const QString &program, const QStringList &args);
+    void fail(const QString &error);
+
+    QSize m_frameSize;
+    int m_maxQueued;
+    QThread *m_writer = nullptr;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_frameQueued;
+    QWaitCondition m_frameTaken;
+    QQueue<QImage> m_queue;
+    bool m_closed = false;
+    bool m_cancelled = false;
+    bool m_failed = false;
+    QString m_lastError;
+};
+
+#endif // FFMPEGPIPE_H
@@ -0,0 +1,352 @@
+#include "framerenderer.h"
+#include "imageblobstore.h"
+#include "objectserializer.h"
+#include "core/project.h"
+#include "core/layer.h"
+#include "canvas/objects/vectorobject.h"
+#include "canvas/objects/objectgroup.h"
+#include "canvas/objects/imageobject.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QPainter>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+FrameRenderer::FrameRenderer(Project *project)
+    : m_project(project)
+    , m_threads(QThread::idealThreadCount())
+{
+}
+
+void FrameRenderer::setThreadCount(int threads)
+{
+    m_threads = qMax(1, threads);
+}
+
+QSize FrameRenderer::outputSize() const
+{
+    return m_outputSize.isEmpty() ? QSize(m_project->width(), m_project->height()) : m_outputSize;
+}
+
+void FrameRenderer::setOutputSize(const QSize &size)
+{
+    m_outputSize = size;
+}
+
+void FrameRenderer::setSupersampling(int factor)
+{
+    m_supersampling = factor >= 4 ? 4 : factor >= 2 ? 2 : 1;
+}
+
+// Average each factor x factor block; premultiplied pixels average
+// correctly channel by channel
+static QImage boxDownsample(const QImage &image, int factor)
+{
+    QImage out(image.width() / factor, image.height() / factor, image.format());
+    const int area = factor * factor;
+    for (int y = 0; y < out.height(); ++y) {
+        QRgb *dst = reinterpret_cast<QRgb *>(out.scanLine(y));
+        for (int x = 0; x < out.width(); ++x) {
+            int a = 0, r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < factor; ++dy) {
+                const QRgb *src = reinterpret_cast<const QRgb *>(image.constScanLine(y * factor + dy))
+                                  + x * factor;
+                for (int dx = 0; dx < factor; ++dx) {
+                    a += qAlpha(src[dx]); r += qRed(src[dx]);
+                    g += qGreen(src[dx]); b += qBlue(src[dx]);
+                }
+            }
+            dst[x] = qRgba((r + area / 2) / area, (g + area / 2) / area,
+                           (b + area / 2) / area, (a + area / 2) / area);
+        }
+    }
+    return out;
+}
+
+// The item's full transform relative to its parent, composed the way
+// QGraphicsItem does (transform(), rotation and scale about the origin
+// point, then pos()). sceneTransform() would give the same answer for a
+// top-level item but caches it inside the item, which races when several
+// frames holding the same keyframe are painted at once.
+static QTransform itemTransform(const QGraphicsItem *item)
+{
+    const QPointF origin = item->transformOriginPoint();
+    QTransform t = item->transform();
+    t.translate(origin.x(), origin.y());
+    t.rotate(item->rotation());
+    t.scale(item->scale(), item->scale());
+    t.translate(-origin.x(), -origin.y());
+    return t * QTransform::fromTranslate(item->pos().x(), item->pos().y());
+}
+
+void FrameRenderer::paintObject(QPainter *painter, VectorObject *obj,
+                                const QHash<qint64, QImage> *pixmapImages)
+{
+    if (!obj->isVisible()) return;
+    painter->save();
+    painter->setTransform(itemTransform(obj), true);
+    auto *img = pixmapImages ? dynamic_cast<ImageObject*>(obj) : nullptr;
+    if (img && pixmapImages->contains(img->imageKey())) {
+        // As ImageObject::paint() draws it, without reading the QPixmap
+        painter->setRenderHint(QPainter::Antialiasing, !VectorObject::isDraftPaint());
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, !VectorObject::isDraftPaint());
+        painter->drawImage(img->boundingRect().toRect(), pixmapImages->value(img->imageKey()));
+    } else {
+        obj->paint(painter, nullptr, nullptr);
+    }
+    // Group children are separate items that the scene would paint itself
+    if (obj->objectType() == VectorObjectType::Group) {
+        for (VectorObject *child : static_cast<ObjectGroup*>(obj)->children())
+            paintObject(painter, child, pixmapImages);
+    }
+    painter->restore();
+}
+
+void FrameRenderer::prepare(const QList<int> &frames)
+{
+    m_project->loadFrames(frames);
+
+    // Tween in-betweens are cloned from their endpoints, so those are the
+    // objects that must be warm; holds paint their keyframe directly
+    const QHash<Layer*, QSet<int>> keyFrames = m_project->keyFramesShownAt(frames);
+    for (Layer *layer : m_project->layers()) {
+        for (int keyFrame : keyFrames.value(layer)) {
+            if (layer->isInterpolated(keyFrame)) continue;
+            for (VectorObject *obj : layer->objectsAtFrame(keyFrame)) {
+                obj->prepareForPaint();
+                obj->sceneTransform();   // tweens map endpoints to scene space
+            }
+        }
+    }
+}
+
+QImage FrameRenderer::renderFrame(int frame) const
+{
+    const QSize size = outputSize();
+    const int factor = m_draft ? 1 : m_supersampling;
+    QImage image(size * factor, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing, !m_draft);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, !m_draft);
+    VectorObject::setDraftPaint(m_draft);
+
+    // Scene units to output pixels: uniform scale, centred
+    const qreal scale = qMin(image.width() / qreal(m_project->width()),
+                             image.height() / qreal(m_project->height()));
+    painter.translate((image.width() - m_project->width() * scale) / 2,
+                      (image.height() - m_project->height() * scale) / 2);
+    painter.scale(scale, scale);
+
+    for (Layer *layer : m_project->layers()) {
+        if (!layer->isVisible()) continue;
+        // In-betweens come back as fresh clones that we own
+        const bool inBetween = layer->isInterpolated(frame);
+        const QList<VectorObject*> objects = layer->objectsAtFrame(frame);
+        painter.setOpacity(layer->opacity());
+        for (VectorObject *obj : objects)
+            paintObject(&painter, obj, m_pixmapImages);
+        if (inBetween) qDeleteAll(objects);
+    }
+    painter.end();
+    VectorObject::setDraftPaint(false);
+    return factor > 1 ? boxDownsample(image, factor) : image;
+}
+
+QList<QByteArray> FrameRenderer::frameHashes(const QList<int> &frames) const
+{
+    const QSize size = outputSize();
+    const QByteArray settings = QString("%1x%2|%3|%4|")
+        .arg(size.width()).arg(size.height())
+        .arg(m_draft ? 1 : m_supersampling).arg(m_draft ? "draft" : "final").toLatin1();
+
+    // Keyframes are hashed by their serialized form (image blobs by their
+    // own hash), once each
+    ImageBlobStore blobs;
+    if (m_pixmapImages)
+        blobs.setPixmapImages(*m_pixmapImages);
+    QHash<QPair<Layer*, int>, QByteArray> keyFrameHashes;
+    auto contentHash = [&](Layer *layer, int keyFrame) {
+        if (keyFrame == -1) return QByteArray("empty");
+        const QPair<Layer*, int> key(layer, keyFrame);
+        auto it = keyFrameHashes.constFind(key);
+        if (it != keyFrameHashes.constEnd()) return it.value();
+        // A keyframe inside another tween's range resolves to clones
+        const bool clones = layer->isInterpolated(keyFrame);
+        const QList<VectorObject*> objects = layer->objectsAtFrame(keyFrame);
+        const QJsonObject json = ObjectSerializer::frameJson(objects, &blobs);
+        if (clones) qDeleteAll(objects);
+        const QByteArray hash = QCryptographicHash::hash(
+            QJsonDocument(json).toJson(QJsonDocument::Compact), QCryptographicHash::Sha1);
+        keyFrameHashes.insert(key, hash);
+        return hash;
+    };
+
+    const QList<Layer*> layers = m_project->layers();
+    QList<QByteArray> hashes;
+    hashes.reserve(frames.size());
+    for (int frame : frames) {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(settings);
+        for (Layer *layer : layers) {
+            if (!layer->isVisible()) {
+                hash.addData("hidden|");
+                continue;
+            }
+            hash.addData(QByteArray::number(layer->opacity(), 'g', 6) + '|');
+            if (layer->isInterpolated(frame)) {
+                // An in-between is fully determined by its endpoints, its
+                // easing and where it sits in the tween
+                const FrameInterpolation tween = layer->getInterpolationFor(frame);
+                hash.addData(QString("tween %1 %2 %3 %4|").arg(tween.startFrame)
+                                 .arg(tween.endFrame).arg(frame).arg(tween.easingType).toUtf8());
+                hash.addData(contentHash(layer, tween.startFrame));
+                hash.addData(contentHash(layer, tween.endFrame));
+            } else {
+                hash.addData("key|");
+                hash.addData(contentHash(layer, layer->getKeyFrameFor(frame)));
+            }
+        }
+        hashes.append(hash.result());
+    }
+    return hashes;
+}
+
+QList<FrameRenderer::Run> FrameRenderer::identityRuns(const QList<int> &frames,
+                                                      QList<QByteArray> hashes) const
+{
+    if (hashes.size() != frames.size())
+        hashes = frameHashes(frames);
+
+    QList<Run> runs;
+    for (int i = 0; i < frames.size(); ++i) {
+        if (i > 0 && hashes.at(i) == hashes.at(i - 1))
+            runs.last().frames.append(frames.at(i));
+        else
+            runs.append(Run{ { frames.at(i) } });
+    }
+    return runs;
+}
+
+bool FrameRenderer::renderRuns(const QList<Run> &runs, const RunSink &sink,
+                               const Encoder &encoder) const
+{
+    QList<int> frames;
+    for (const Run &run : runs)
+        frames.append(run.frames.first());
+    int next = 0;
+    return renderInOrder(frames, [&](int, const QImage &image, const QByteArray &encoded) {
+        return sink(runs.at(next++), image, encoded);
+    }, encoder);
+}
+
+bool FrameRenderer::renderInOrder(const QList<int> &frames, const Sink &sink,
+                                  const Encoder &encoder) const
+{
+    struct Rendered {
+        QImage image;
+        QByteArray encoded;
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_threads);
+    QMutex mutex;
+    QWaitCondition frameDone;
+    QHash<int, Rendered> done;   // keyed by index into frames
+
+    auto submit = [&](int index) {
+        pool.start([&, index]() {
+            Rendered result;
+            result.image = renderFrame(frames.at(index));
+            if (encoder) result.encoded = encoder(result.image);
+            QMutexLocker lock(&mutex);
+            done.insert(index, result);
+            frameDone.wakeAll();
+        });
+    };
+
+    const int window = m_threads * 2;
+    int submitted = 0;
+    while (submitted < frames.size() && submitted < window)
+        submit(submitted++);
+
+    bool completed = true;
+    for (int index = 0; index < frames.size(); ++index) {
+        Rendered result;
+        {
+            QMutexLocker lock(&mutex);
+            while (!done.contains(index))
+                frameDone.wait(&mutex);
+            result = done.take(index);
+        }
+        // Keep the pool busy while the sink works
+        if (submitted < frames.size())
+            submit(submitted++);
+        if (!sink(frames.at(index), result.image, result.encoded)) {
+            completed = false;
+            break;
+        }
+    }
+
+    pool.clear();
+    pool.waitForDone();
+    return completed;
+}
+
+QString FrameRenderer::sequenceFileName(const QString &dir, int frame)
+{
+    return dir + QString("/frame_%1.png").arg(frame, 6, 10, QChar('0'));
+}
+
+QByteArray FrameRenderer::encodePng(const QImage &image)
+{
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return png;
+}
+
+bool FrameRenderer::linkOrCopy(const QString &from, const QString &to)
+{
+    QFile::remove(to);
+#ifdef Q_OS_UNIX
+    if (::link(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0)
+        return true;
+#endif
+    return QFile::copy(from, to);
+}
+
+bool FrameRenderer::writeSequenceFiles(const QString &dir, const QList<int> &frames,
+                                       const QByteArray &png, QString *error)
+{
+    if (frames.isEmpty()) return true;
+    // Never written through: an old file may be a link shared with other
+    // frames
+    QFile file(sequenceFileName(dir, frames.first()));
+    QFile::remove(file.fileName());
+    if (png.isEmpty() || !file.open(QIODevice::WriteOnly) || file.write(png) != png.size()) {
+        if (error) *error = QString("Could not write %1: %2").arg(file.fileName(), file.errorString());
+        return false;
+    }
+    file.close();
+    for (int i = 1; i < frames.size(); ++i) {
+        const QString copy = sequenceFileName(dir, frames.at(i));
+        if (!linkOrCopy(file.fileName(), copy)) {
+            if (error) *error = "Could not write " + copy;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,151 @@
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <functional>
+
+class Project;
+class QPainter;
+class VectorObject;
+
+/**
+ * @brief Paints animation frames straight from the Layer model
+ *
+ * Used by every export path (video, GIF, PNG sequence, --render). No
+ * canvas or scene is involved: each frame gets its own QImage and
+ * QPainter, so many frames can be painted at once on a thread pool.
+ *
+ * The stacking matches the canvas: layers in list order (the first layer
+ * at the bottom), objects in frame order, layer opacity applied to each
+ * object. Off the GUI thread, image objects should be painted from QImage
+ * copies of their pixmaps (see setPixmapImages()).
+ *
+ * The project must not be edited while frames are being rendered.
+ */
+class FrameRenderer
+{
+public:
+    // Runs on the worker right after a frame is painted (e.g. PNG
+    // compression); its result is handed to the Sink with the image
+    using Encoder = std::function<QByteArray(const QImage &image)>;
+    // Receives frames in order on the calling thread; return false to stop
+    using Sink = std::function<bool(int frame, const QImage &image, const QByteArray &encoded)>;
+
+    // Frames that look the same (a held drawing, a repeated keyframe)
+    // share one render
+    struct Run {
+        QList<int> frames;   // adjacent entries of the export list
+    };
+    using RunSink = std::function<bool(const Run &run, const QImage &image, const QByteArray &encoded)>;
+
+    explicit FrameRenderer(Project *project);
+
+    // Worker threads used by renderInOrder() (default: one per core)
+    int threadCount() const { return m_threads; }
+    void setThreadCount(int threads);
+
+    // Output resolution (default: project size). The vectors are painted
+    // at this size through the painter transform, never resampled; a
+    // different aspect ratio is fitted and centred on white.
+    QSize outputSize() const;
+    void setOutputSize(const QSize &size);
+
+    // Paint at 2x or 4x the output size and box-filter down (1 = off)
+    int supersampling() const { return m_supersampling; }
+    void setSupersampling(int factor);
+
+    // Fast previews: no antialiasing, no brush textures, no supersampling
+    bool isDraft() const { return m_draft; }
+    void setDraft(bool draft) { m_draft = draft; }
+
+    // QImage copies of image objects' pixmaps, by cacheKey(), made on the
+    // GUI thread (ProjectSnapshot::pixmapImages); images found here are
+    // painted from the copy. Must outlive the renderer.
+    void setPixmapImages(const QHash<qint64, QImage> *images) { m_pixmapImages = images; }
+
+    /**
+     * @brief Decode and warm up everything the given frames paint
+     *
+     * Must run before any of these frames is rendered, while nothing else
+     * uses the project. Decoding archived frames creates pixmaps, so a
+     * project that still has some is prepared on the GUI thread; a private
+     * copy holding only loaded frames can be prepared on a worker.
+     */
+    void prepare(const QList<int> &frames);
+
+    /**
+     * @brief Paint one frame at outputSize() on a white background
+     *
+     * Thread-safe for frames passed to prepare().
+     */
+    QImage renderFrame(int frame) const;
+
+    /**
+     * @brief Render frames in parallel and deliver them in list order
+     *
+     * At most two frames per thread are in flight, so a slow sink (an
+     * encoder) holds rendering back instead of piling up images.
+     * @return false if the sink stopped the run
+     */
+    bool renderInOrder(const QList<int> &frames, const Sink &sink,
+                       const Encoder &encoder = Encoder()) const;
+
+    /**
+     * @brief Content hash of each frame as it would come out of renderFrame()
+     *
+     * Covers every layer's visibility, opacity and shown objects (an
+     * in-between by its tween endpoints, easing and position) plus the
+     * output size, supersampling and draft mode: equal hashes mean equal
+     * pixels. Must run after prepare(). Images are hashed from
+     * setPixmapImages() where they are found there, so with those set no
+     * pixmap is read and this can run on a worker.
+     */
+    QList<QByteArray> frameHashes(const QList<int> &frames) const;
+
+    /**
+     * @brief Split an export list into visual identity runs
+     *
+     * Adjacent entries share a run when their frameHashes() match: a hold,
+     * or a keyframe repeated with the same content. Pass the hashes if they
+     * were already computed. Same threading rules as frameHashes().
+     */
+    QList<Run> identityRuns(const QList<int> &frames,
+                            QList<QByteArray> hashes = QList<QByteArray>()) const;
+
+    /**
+     * @brief renderInOrder() for runs: each run is painted once
+     */
+    bool renderRuns(const QList<Run> &runs, const RunSink &sink,
+                    const Encoder &encoder = Encoder()) const;
+
+    // Paints an object (and a group's children) the way the scene would,
+    // with its own transform on top of the painter's; images found in
+    // pixmapImages are drawn from the copy
+    static void paintObject(QPainter *painter, VectorObject *obj,
+                            const QHash<qint64, QImage> *pixmapImages = nullptr);
+
+    // PNG sequences: dir/frame_000123.png, numbered by absolute frame
+    static QString sequenceFileName(const QString &dir, int frame);
+    static QByteArray encodePng(const QImage &image);
+    // Hard-links `to` to `from` where the file system allows, else copies
+    static bool linkOrCopy(const QString &from, const QString &to);
+    // Writes png as the first frame's file and links the others to it.
+    // Existing files are replaced, never written through.
+    static bool writeSequenceFiles(const QString &dir, const QList<int> &frames,
+                                   const QByteArray &png, QString *error = nullptr);
+
+private:
+    Project *m_project;
+    int m_threads;
+    QSize m_outputSize;
+    int m_supersampling = 1;
+    bool m_draft = false;
+    const QHash<qint64, QImage> *m_pixmapImages = nullptr;
+};
+
+#endif // FRAMERENDERER_H
@@ -0,0 +1,660 @@
+#include "gifencoder.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <vector>
+
+// ============= COLOUR QUANTIZATION =============
+//
+// Both quantizers work on a histogram with 5 bits per channel; each bin
+// keeps the exact sums of its colours, so a bin's mean is the true colour
+// when only one colour fell into it (flat line art stays exact).
+
+namespace {
+
+struct ColorBin {
+    quint16 key = 0;      // r5 << 10 | g5 << 5 | b5
+    quint64 count = 0;
+    quint64 r = 0, g = 0, b = 0;
+};
+
+inline int binKey(QRgb c)
+{
+    return (qRed(c) >> 3) << 10 | (qGreen(c) >> 3) << 5 | (qBlue(c) >> 3);
+}
+
+// channel 0 = red, 1 = green, 2 = blue
+inline int binChannel(quint16 key, int channel)
+{
+    return (key >> (10 - 5 * channel)) & 31;
+}
+
+QRgb meanColor(quint64 r, quint64 g, quint64 b, quint64 count)
+{
+    if (count == 0) return qRgb(0, 0, 0);
+    return qRgb(int((r + count / 2) / count), int((g + count / 2) / count),
+                int((b + count / 2) / count));
+}
+
+class Histogram
+{
+public:
+    Histogram() : m_bins(32768) {}
+
+    void add(QRgb c)
+    {
+        ColorBin &bin = m_bins[binKey(c)];
+        ++bin.count;
+        bin.r += qRed(c);
+        bin.g += qGreen(c);
+        bin.b += qBlue(c);
+    }
+
+    std::vector<ColorBin> bins() const
+    {
+        std::vector<ColorBin> used;
+        for (int key = 0; key < int(m_bins.size()); ++key) {
+            if (m_bins[key].count == 0) continue;
+            ColorBin bin = m_bins[key];
+            bin.key = quint16(key);
+            used.push_back(bin);
+        }
+        return used;
+    }
+
+private:
+    std::vector<ColorBin> m_bins;
+};
+
+QList<QRgb> medianCut(std::vector<ColorBin> bins, int maxColors)
+{
+    struct Box {
+        int begin = 0, end = 0;
+        quint64 count = 0;
+        int channel = 0;   // widest channel
+        int range = 0;
+    };
+    auto measure = [&bins](int begin, int end) {
+        Box box;
+        box.begin = begin;
+        box.end = end;
+        int lo[3] = {31, 31, 31}, hi[3] = {0, 0, 0};
+        for (int i = begin; i < end; ++i) {
+            box.count += bins[i].count;
+            for (int c = 0; c < 3; ++c) {
+                lo[c] = qMin(lo[c], binChannel(bins[i].key, c));
+                hi[c] = qMax(hi[c], binChannel(bins[i].key, c));
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            if (hi[c] - lo[c] > box.range) {
+                box.range = hi[c] - lo[c];
+                box.channel = c;
+            }
+        }
+        return box;
+    };
+
+    std::vector<Box> boxes{ measure(0, int(bins.size())) };
+    while (int(boxes.size()) < maxColors) {
+        // Split the box holding the most pixels spread over the widest range
+        int pick = -1;
+        double best = 0;
+        for (int i = 0; i < int(boxes.size()); ++i) {
+            if (boxes[i].end - boxes[i].begin < 2) continue;
+            const double score = double(boxes[i].count) * (boxes[i].range + 1);
+            if (score > best) { best = score; pick = i; }
+        }
+        if (pick < 0) break;
+
+        const Box box = boxes[pick];
+        std::sort(bins.begin() + box.begin, bins.begin() + box.end,
+                  [&box](const ColorBin &a, const ColorBin &b) {
+                      return binChannel(a.key, box.channel) < binChannel(b.key, box.channel);
+                  });
+        quint64 seen = 0;
+        int mid = box.begin + 1;
+        for (int i = box.begin; i < box.end - 1; ++i) {
+            seen += bins[i].count;
+            mid = i + 1;
+            if (seen * 2 >= box.count) break;
+        }
+        boxes[pick] = measure(box.begin, mid);
+        boxes.push_back(measure(mid, box.end));
+    }
+
+    QList<QRgb> palette;
+    for (const Box &box : boxes) {
+        quint64 r = 0, g = 0, b = 0;
+        for (int i = box.begin; i < box.end; ++i) {
+            r += bins[i].r; g += bins[i].g; b += bins[i].b;
+        }
+        palette.append(meanColor(r, g, b, box.count));
+    }
+    return palette;
+}
+
+QList<QRgb> octree(const std::vector<ColorBin> &bins, int maxColors)
+{
+    // Five levels below the root, one per histogram bit; level-5 nodes are
+    // the initial leaves. Reduction merges the least used nodes of the
+    // deepest level first, so rare colours are folded before common ones.
+    struct Node {
+        quint64 count = 0, r = 0, g = 0, b = 0;
+        int children[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+        int level = 0;
+        bool leaf = false;
+    };
+    std::vector<Node> nodes(1);
+    int leaves = 0;
+
+    for (const ColorBin &bin : bins) {
+        int node = 0;
+        for (int level = 0; level < 5; ++level) {
+            const int shift = 4 - level;
+            const int child = ((binChannel(bin.key, 0) >> shift) & 1) << 2
+                            | ((binChannel(bin.key, 1) >> shift) & 1) << 1
+                            | ((binChannel(bin.key, 2) >> shift) & 1);
+            if (nodes[node].children[child] < 0) {
+                Node created;
+                created.level = level + 1;
+                created.leaf = created.level == 5;
+                if (created.leaf) ++leaves;
+                nodes.push_back(created);
+                nodes[node].children[child] = int(nodes.size()) - 1;
+            }
+            node = nodes[node].children[child];
+        }
+        Node &leaf = nodes[node];
+        leaf.count += bin.count;
+        leaf.r += bin.r; leaf.g += bin.g; leaf.b += bin.b;
+    }
+
+    for (int level = 4; level >= 0 && leaves > maxColors; --level) {
+        std::vector<int> candidates;
+        for (int i = 0; i < int(nodes.size()); ++i) {
+            if (nodes[i].level != level || nodes[i].leaf) continue;
+            Node &node = nodes[i];
+            node.count = node.r = node.g = node.b = 0;
+            for (int child : node.children) {
+                if (child < 0) continue;
+                node.count += nodes[child].count;
+                node.r += nodes[child].r; node.g += nodes[child].g; node.b += nodes[child].b;
+            }
+            candidates.push_back(i);
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [&nodes](int a, int b) { return nodes[a].count < nodes[b].count; });
+        for (int i : candidates) {
+            if (leaves <= maxColors) break;
+            int childCount = 0;
+            for (int &child : nodes[i].children) {
+                if (child >= 0) ++childCount;
+                child = -1;
+            }
+            nodes[i].leaf = true;
+            leaves -= childCount - 1;
+        }
+    }
+
+    QList<QRgb> palette;
+    std::vector<int> stack{0};
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        if (node.leaf) {
+            palette.append(meanColor(node.r, node.g, node.b, node.count));
+            continue;
+        }
+        for (int child : node.children)
+            if (child >= 0) stack.push_back(child);
+    }
+    return palette;
+}
+
+QList<QRgb> quantize(const Histogram &histogram, int maxColors, GifEncoder::Quantizer quantizer)
+{
+    const std::vector<ColorBin> bins = histogram.bins();
+    if (int(bins.size()) <= maxColors) {
+        QList<QRgb> palette;
+        for (const ColorBin &bin : bins)
+            palette.append(meanColor(bin.r, bin.g, bin.b, bin.count));
+        return palette;
+    }
+    return quantizer == GifEncoder::Quantizer::Octree ? octree(bins, maxColors)
+                                                      : medianCut(bins, maxColors);
+}
+
+// Nearest palette entry, with a direct-mapped cache keyed by the exact
+// colour so repeated colours (most of a drawing) cost one lookup
+class PaletteMapper
+{
+public:
+    explicit PaletteMapper(const QList<QRgb> &palette)
+        : m_palette(palette), m_keys(CacheSize, Empty), m_values(CacheSize) {}
+
+    int map(int r, int g, int b)
+    {
+        const quint32 rgb = quint32(r) << 16 | quint32(g) << 8 | quint32(b);
+        const quint32 slot = (rgb * 2654435761u) >> (32 - CacheBits);
+        if (m_keys[slot] == rgb) return m_values[slot];
+
+        int best = 0, bestDistance = INT_MAX;
+        for (int i = 0; i < m_palette.size(); ++i) {
+            const int dr = qRed(m_palette[i]) - r;
+            const int dg = qGreen(m_palette[i]) - g;
+            const int db = qBlue(m_palette[i]) - b;
+            const int distance = 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+            if (distance < bestDistance) { bestDistance = distance; best = i; }
+        }
+        m_keys[slot] = rgb;
+        m_values[slot] = quint8(best);
+        return best;
+    }
+
+private:
+    static constexpr int CacheBits = 16;
+    static constexpr int CacheSize = 1 << CacheBits;
+    static constexpr quint32 Empty = 0xffffffff;
+
+    QList<QRgb> m_palette;
+    std::vector<quint32> m_keys;
+    std::vector<quint8> m_values;
+};
+
+// ============= LZW =============
+
+// Appends variable-width codes LSB first and packs them into the
+// 255-byte sub-blocks GIF image data is stored in
+class CodeWriter
+{
+public:
+    void write(int code, int bits)
+    {
+        m_accumulator |= quint32(code) << m_bitCount;
+        m_bitCount += bits;
+        while (m_bitCount >= 8) {
+            m_bytes.append(char(m_accumulator & 0xff));
+            m_accumulator >>= 8;
+            m_bitCount -= 8;
+        }
+    }
+
+    QByteArray finish(int minCodeSize)
+    {
+        if (m_bitCount > 0)
+            m_bytes.append(char(m_accumulator & 0xff));
+        QByteArray out;
+        out.reserve(m_bytes.size() + m_bytes.size() / 255 + 3);
+        out.append(char(minCodeSize));
+        for (int pos = 0; pos < m_bytes.size(); pos += 255) {
+            const int len = qMin(255, int(m_bytes.size()) - pos);
+            out.append(char(len));
+            out.append(m_bytes.constData() + pos, len);
+        }
+        out.append(char(0));
+        return out;
+    }
+
+private:
+    QByteArray m_bytes;
+    quint32 m_accumulator = 0;
+    int m_bitCount = 0;
+};
+
+QByteArray lzwEncode(const std::vector<quint8> &indices, int minCodeSize)
+{
+    // Dictionary entries are (prefix code, next index) pairs kept in an
+    // open-addressing table; at most 4096 codes exist at a time
+    constexpr int TableBits = 13;
+    constexpr int TableSize = 1 << TableBits;
+    std::vector<qint32> keys(TableSize, -1);
+    std::vector<quint16> codes(TableSize);
+
+    const int clearCode = 1 << minCodeSize;
+    int codeSize = minCodeSize + 1;
+    int maxCode = clearCode + 1;
+
+    CodeWriter out;
+    out.write(clearCode, codeSize);
+
+    int current = -1;
+    for (quint8 index : indices) {
+        if (current < 0) {
+            current = index;
+            continue;
+        }
+        const qint32 key = current << 8 | index;
+        quint32 slot = (quint32(key) * 2654435761u) >> (32 - TableBits);
+        while (keys[slot] >= 0 && keys[slot] != key)
+            slot = (slot + 1) & (TableSize - 1);
+        if (keys[slot] == key) {
+            current = codes[slot];
+            continue;
+        }
+
+        out.write(current, codeSize);
+        keys[slot] = key;
+        codes[slot] = quint16(++maxCode);
+        if (maxCode >= (1 << codeSize))
+            ++codeSize;
+        if (maxCode == 4095) {
+            out.write(clearCode, codeSize);
+            std::fill(keys.begin(), keys.end(), -1);
+            codeSize = minCodeSize + 1;
+            maxCode = clearCode + 1;
+        }
+        current = index;
+    }
+    if (current >= 0) {
+        out.write(current, codeSize);
+        // The decoder adds an entry for this code too, and widens before
+        // reading the next one if that entry fills the current width
+        if (maxCode + 1 >= (1 << codeSize) && codeSize < 12)
+            ++codeSize;
+    }
+    out.write(clearCode + 1, codeSize);
+    return out.finish(minCodeSize);
+}
+
+// ============= HELPERS =============
+
+// Bits needed for a colour table holding `colors` entries (1..8)
+int tableBits(int colors)
+{
+    int bits = 1;
+    while ((1 << bits) < colors) ++bits;
+    return bits;
+}
+
+void appendLE16(QByteArray &out, int value)
+{
+    out.append(char(value & 0xff));
+    out.append(char((value >> 8) & 0xff));
+}
+
+void appendColorTable(QByteArray &out, const QList<QRgb> &palette)
+{
+    const int size = 1 << tableBits(palette.size());
+    for (int i = 0; i < size; ++i) {
+        const QRgb c = i < palette.size() ? palette[i] : qRgb(0, 0, 0);
+        out.append(char(qRed(c)));
+        out.append(char(qGreen(c)));
+        out.append(char(qBlue(c)));
+    }
+}
+
+// Bounding box of the pixels that differ between two same-sized frames
+QRect changedRect(const QImage &previous, const QImage &frame)
+{
+    int top = -1, bottom = -1, left = frame.width(), right = -1;
+    const int rowBytes = frame.width() * 4;
+    for (int y = 0; y < frame.height(); ++y) {
+        const QRgb *a = reinterpret_cast<const QRgb *>(previous.constScanLine(y));
+        const QRgb *b = reinterpret_cast<const QRgb *>(frame.constScanLine(y));
+        if (std::memcmp(a, b, rowBytes) == 0) continue;
+        if (top < 0) top = y;
+        bottom = y;
+        int x0 = 0;
+        while (a[x0] == b[x0]) ++x0;
+        int x1 = frame.width() - 1;
+        while (a[x1] == b[x1]) --x1;
+        left = qMin(left, x0);
+        right = qMax(right, x1);
+    }
+    if (top < 0) return QRect();
+    return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+} // namespace
+
+// ============= ENCODER =============
+
+GifEncoder::GifEncoder()
+{
+}
+
+GifEncoder::~GifEncoder()
+{
+    if (m_file.isOpen())
+        close();
+}
+
+bool GifEncoder::open(const QString &path, const QSize &size, const Options &options)
+{
+    if (size.isEmpty() || size.width() > 65535 || size.height() > 65535) {
+        m_lastError = "Invalid GIF size";
+        return false;
+    }
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_lastError = "Failed to open file for writing: " + path;
+        return false;
+    }
+    m_size = size;
+    m_options = options;
+    m_headerWritten = false;
+    m_globalPalette.clear();
+    m_previous = QImage();
+    m_hasPending = false;
+    m_timeMs = 0;
+    return true;
+}
+
+bool GifEncoder::write(const QByteArray &bytes)
+{
+    if (m_file.write(bytes) != bytes.size()) {
+        m_lastError = "Failed to write GIF: " + m_file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool GifEncoder::writeHeader(const QList<QRgb> *globalPalette)
+{
+    QByteArray out("GIF89a");
+    appendLE16(out, m_size.width());
+    appendLE16(out, m_size.height());
+    // Global colour table flag, 8 bits of colour resolution, table size
+    out.append(char(globalPalette ? 0x80 | 0x70 | (tableBits(globalPalette->size()) - 1) : 0x70));
+    out.append(char(0));   // background colour index
+    out.append(char(0));   // pixel aspect ratio
+    if (globalPalette)
+        appendColorTable(out, *globalPalette);
+
+    if (m_options.loopCount >= 0) {
+        out.append("\x21\xFF\x0B" "NETSCAPE2.0", 14);
+        out.append(char(3));
+        out.append(char(1));
+        appendLE16(out, m_options.loopCount);
+        out.append(char(0));
+    }
+    m_headerWritten = true;
+    return write(out);
+}
+
+bool GifEncoder::addFrame(const QImage &input, int delayMs)
+{
+    if (!m_file.isOpen()) {
+        m_lastError = "GIF file is not open";
+        return false;
+    }
+    if (input.size() != m_size) {
+        m_lastError = QString("Frame is %1x%2, expected %3x%4")
+                          .arg(input.width()).arg(input.height())
+                          .arg(m_size.width()).arg(m_size.height());
+        return false;
+    }
+    const QImage frame = input.convertToFormat(QImage::Format_RGB32);
+
+    // Only the part that changed since the previous frame is encoded
+    const bool delta = m_options.frameDelta && !m_previous.isNull();
+    const QRect rect = delta ? changedRect(m_previous, frame) : frame.rect();
+    if (rect.isEmpty()) {
+        extendLastFrame(delayMs);
+        return true;
+    }
+    auto changed = [&](int x, int y) {
+        return !delta || reinterpret_cast<const QRgb *>(m_previous.constScanLine(y))[x]
+                         != reinterpret_cast<const QRgb *>(frame.constScanLine(y))[x];
+    };
+
+    // Palette: the global one, or one built from this frame's changed pixels.
+    // One entry is kept free for transparency when unchanged pixels remain.
+    bool anyUnchanged = false;
+    QList<QRgb> palette;
+    if (m_options.globalPalette && m_headerWritten) {
+        palette = m_globalPalette;
+        anyUnchanged = delta;
+    } else {
+        Histogram histogram;
+        for (int y = rect.top(); y <= rect.bottom(); ++y) {
+            for (int x = rect.left(); x <= rect.right(); ++x) {
+                if (changed(x, y))
+                    histogram.add(reinterpret_cast<const QRgb *>(frame.constScanLine(y))[x]);
+                else
+                    anyUnchanged = true;
+            }
+        }
+        const bool reserveTransparent = anyUnchanged
+            || (m_options.globalPalette && m_options.frameDelta);
+        palette = quantize(histogram, reserveTransparent ? 255 : 256, m_options.quantizer);
+        if (palette.isEmpty())
+            palette.append(qRgb(0, 0, 0));
+    }
+
+    if (!m_headerWritten) {
+        if (m_options.globalPalette) {
+            m_globalPalette = palette;
+            if (m_options.frameDelta)
+                m_globalPalette.append(qRgb(0, 0, 0));   // transparent slot
+            palette = m_globalPalette;
+        }
+        if (!writeHeader(m_options.globalPalette ? &m_globalPalette : nullptr))
+            return false;
+    }
+
+    int transparentIndex = -1;
+    int colors = palette.size();
+    if (m_options.globalPalette) {
+        if (m_options.frameDelta) {
+            transparentIndex = palette.size() - 1;
+            colors = transparentIndex;
+        }
+    } else if (anyUnchanged) {
+        transparentIndex = palette.size();
+        palette.append(qRgb(0, 0, 0));
+    }
+
+    // Map to palette indices, optionally diffusing the error
+    // Floyd-Steinberg style (7/16 right, 3/16, 5/16, 1/16 below)
+    PaletteMapper mapper(colors == palette.size() ? palette : palette.mid(0, colors));
+    const int w = rect.width();
+    std::vector<quint8> indices(size_t(w) * rect.height());
+    std::vector<int> errThis((w + 2) * 3, 0), errNext((w + 2) * 3, 0);
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const QRgb *src = reinterpret_cast<const QRgb *>(frame.constScanLine(y));
+        quint8 *row = indices.data() + size_t(y - rect.top()) * w;
+        std::fill(errNext.begin(), errNext.end(), 0);
+        for (int i = 0; i < w; ++i) {
+            const int x = rect.left() + i;
+            if (!changed(x, y)) {
+                row[i] = quint8(transparentIndex);
+                continue;
+            }
+            int rgb[3] = { qRed(src[x]), qGreen(src[x]), qBlue(src[x]) };
+            if (m_options.dither) {
+                for (int c = 0; c < 3; ++c)
+                    rgb[c] = qBound(0, rgb[c] + errThis[(i + 1) * 3 + c] / 16, 255);
+            }
+            const int index = mapper.map(rgb[0], rgb[1], rgb[2]);
+            row[i] = quint8(index);
+            if (m_options.dither) {
+                const QRgb chosen = palette[index];
+                const int err[3] = { rgb[0] - qRed(chosen), rgb[1] - qGreen(chosen),
+                                     rgb[2] - qBlue(chosen) };
+                for (int c = 0; c < 3; ++c) {
+                    errThis[(i + 2) * 3 + c] += err[c] * 7;
+                    errNext[(i)     * 3 + c] += err[c] * 3;
+                    errNext[(i + 1) * 3 + c] += err[c] * 5;
+                    errNext[(i + 2) * 3 + c] += err[c];
+                }
+            }
+        }
+        std::swap(errThis, errNext);
+    }
+
+    if (!flushPending())
+        return false;
+
+    m_pending.rect = rect;
+    m_pending.palette = m_options.globalPalette ? QList<QRgb>() : palette;
+    m_pending.transparentIndex = transparentIndex;
+    m_pending.data = lzwEncode(indices, qMax(2, tableBits(palette.size())));
+    m_pending.startMs = m_timeMs;
+    m_pending.durationMs = delayMs;
+    m_hasPending = true;
+    m_timeMs += delayMs;
+
+    m_previous = frame;
+    return true;
+}
+
+void GifEncoder::extendLastFrame(int delayMs)
+{
+    if (!m_hasPending) return;
+    m_pending.durationMs += delayMs;
+    m_timeMs += delayMs;
+}
+
+bool GifEncoder::flushPending()
+{
+    if (!m_hasPending) return true;
+    m_hasPending = false;
+
+    // Delays are in 1/100 s; rounding against the running clock keeps
+    // e.g. 24 fps (4.17 cs per frame) from drifting. Viewers treat delays
+    // under 2 cs as "as fast as possible", so never go below that.
+    const qint64 startCs = (m_pending.startMs + 5) / 10;
+    const qint64 endCs = (m_pending.startMs + m_pending.durationMs + 5) / 10;
+    const int delayCs = int(qBound<qint64>(2, endCs - startCs, 65535));
+
+    QByteArray out;
+    out.reserve(m_pending.data.size() + 800);
+    // Graphic control extension: disposal 1 (keep the frame for the next
+    // delta to draw over), transparency flag, delay, transparent index
+    out.append("\x21\xF9\x04", 3);
+    out.append(char(1 << 2 | (m_pending.transparentIndex >= 0 ? 1 : 0)));
+    appendLE16(out, delayCs);
+    out.append(char(qMax(0, m_pending.transparentIndex)));
+    out.append(char(0));
+
+    // Image descriptor, local colour table, image data
+    out.append(char(0x2C));
+    appendLE16(out, m_pending.rect.left());
+    appendLE16(out, m_pending.rect.top());
+    appendLE16(out, m_pending.rect.width());
+    appendLE16(out, m_pending.rect.height());
+    if (m_pending.palette.isEmpty()) {
+        out.append(char(0));
+    } else {
+        out.append(char(0x80 | (tableBits(m_pending.palette.size()) - 1)));
+        appendColorTable(out, m_pending.palette);
+    }
+    out.append(m_pending.data);
+    m_pending.data.clear();
+    return write(out);
+}
+
+bool GifEncoder::close()
+{
+    if (!m_file.isOpen()) return false;
+    bool ok = m_headerWritten;
+    if (!ok)
+        m_lastError = "No frames were added";
+    ok = ok && flushPending() && write(QByteArray(1, char(0x3B)));
+    m_file.close();
+    m_previous = QImage();
+    return ok;
+}
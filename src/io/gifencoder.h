@@ -0,0 +1,93 @@
+#ifndef GIFENCODER_H
+#define GIFENCODER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QRgb>
+#include <QSize>
+#include <QString>
+
+/**
+ * @brief Streaming GIF89a writer
+ *
+ * Frames are quantized, LZW-compressed and written as they arrive; only
+ * the previous frame and one encoded frame are held in memory, and no
+ * external tool is involved.
+ *
+ * - Palettes: one per frame (local colour tables) or one global palette
+ *   taken from the first frame, built by median cut or an octree.
+ * - Optional Floyd-Steinberg dithering.
+ * - Frame deltas: each frame after the first only covers the rectangle
+ *   that changed, and pixels inside it that did not change are written
+ *   as transparent so the previous frame shows through. A frame that did
+ *   not change at all just lengthens the previous frame's delay.
+ *
+ * Frames are treated as opaque.
+ */
+class GifEncoder
+{
+public:
+    enum class Quantizer {
+        MedianCut,
+        Octree
+    };
+
+    struct Options {
+        Quantizer quantizer = Quantizer::MedianCut;
+        bool globalPalette = false;   // one palette, built from the first frame
+        bool dither = true;           // Floyd-Steinberg
+        bool frameDelta = true;       // changed rectangles + transparency
+        int  loopCount = 0;           // 0 = forever, -1 = play once
+    };
+
+    GifEncoder();
+    ~GifEncoder();   // closes the file if close() was not called
+
+    bool open(const QString &path, const QSize &size, const Options &options = Options());
+
+    /**
+     * @brief Append a frame shown for delayMs milliseconds
+     */
+    bool addFrame(const QImage &frame, int delayMs);
+
+    // Show the last frame for delayMs longer (e.g. a held drawing)
+    void extendLastFrame(int delayMs);
+
+    /**
+     * @brief Write the last frame and the trailer
+     */
+    bool close();
+
+    QString lastError() const { return m_lastError; }
+
+private:
+    struct PendingFrame {
+        QRect rect;
+        QList<QRgb> palette;
+        int transparentIndex = -1;
+        QByteArray data;   // LZW minimum code size + data sub-blocks
+        qint64 startMs = 0;
+        qint64 durationMs = 0;
+    };
+
+    bool writeHeader(const QList<QRgb> *globalPalette);
+    bool flushPending();
+    bool write(const QByteArray &bytes);
+
+    QFile m_file;
+    QSize m_size;
+    Options m_options;
+    bool m_headerWritten = false;
+    QList<QRgb> m_globalPalette;
+
+    QImage m_previous;          // last source frame, for deltas
+    PendingFrame m_pending;
+    bool m_hasPending = false;
+    qint64 m_timeMs = 0;        // start of the next frame
+    QString m_lastError;
+};
+
+#endif // GIFENCODER_H
@@ -0,0 +1,202 @@
+#include "headlessrenderer.h"
+#include "core/project.h"
+#include "framerenderer.h"
+#include "ffmpegpipe.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QSize>
+#include <QTextStream>
+#include <QThread>
+#include <cstring>
+
+bool HeadlessRenderer::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--render") == 0 || std::strncmp(argv[i], "--render=", 9) == 0)
+            return true;
+    }
+    return false;
+}
+
+// "12" or "1-500"
+static bool parseFrameRange(const QString &text, int *first, int *last)
+{
+    const QStringList parts = text.split('-');
+    if (parts.isEmpty() || parts.size() > 2) return false;
+    bool ok1 = false, ok2 = true;
+    *first = parts.first().trimmed().toInt(&ok1);
+    *last  = parts.size() == 2 ? parts.last().trimmed().toInt(&ok2) : *first;
+    return ok1 && ok2 && *first >= 1 && *last >= *first;
+}
+
+// "1920x1080"
+static bool parseSize(const QString &text, QSize *size)
+{
+    const QStringList parts = text.toLower().split('x');
+    if (parts.size() != 2) return false;
+    bool okW = false, okH = false;
+    *size = QSize(parts.first().trimmed().toInt(&okW), parts.last().trimmed().toInt(&okH));
+    return okW && okH && size->width() > 0 && size->height() > 0;
+}
+
+int HeadlessRenderer::run(const QStringList &arguments)
+{
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render an AkisVG project without opening a window.");
+    parser.addHelpOption();
+    const QCommandLineOption renderOption("render", "Project file to render.", "project");
+    const QCommandLineOption framesOption("frames",
+        "Frames to render, e.g. 1-500 or 12 (default: every used frame).", "range");
+    const QCommandLineOption outOption("out",
+        "Directory for a PNG sequence, or a .mp4/.mkv/.mov file (default: <project>_render).",
+        "path");
+    const QCommandLineOption threadsOption("threads",
+        "Render threads (default: one per core).", "count");
+    const QCommandLineOption sizeOption("size",
+        "Output size, e.g. 3840x2160 (default: project size).", "WxH");
+    const QCommandLineOption supersampleOption("supersample",
+        "Paint at 2x or 4x and filter down (default: 1).", "factor");
+    const QCommandLineOption draftOption("draft",
+        "Fast preview: no antialiasing or brush textures.");
+    parser.addOptions({renderOption, framesOption, outOption, threadsOption,
+                       sizeOption, supersampleOption, draftOption});
+    parser.process(arguments);
+
+    const QString projectPath = parser.value(renderOption);
+    Project project;
+    if (projectPath.isEmpty() || !project.loadFromFile(projectPath)) {
+        err << "Could not load project: " << projectPath << Qt::endl;
+        return 1;
+    }
+
+    int first = 1;
+    int last  = qMax(1, project.highestUsedFrame());
+    if (parser.isSet(framesOption) && !parseFrameRange(parser.value(framesOption), &first, &last)) {
+        err << "Invalid frame range: " << parser.value(framesOption) << Qt::endl;
+        return 1;
+    }
+
+    int threads = QThread::idealThreadCount();
+    if (parser.isSet(threadsOption)) {
+        bool ok = false;
+        threads = parser.value(threadsOption).toInt(&ok);
+        if (!ok || threads < 1) {
+            err << "Invalid thread count: " << parser.value(threadsOption) << Qt::endl;
+            return 1;
+        }
+    }
+
+    QSize size;
+    if (parser.isSet(sizeOption) && !parseSize(parser.value(sizeOption), &size)) {
+        err << "Invalid size: " << parser.value(sizeOption) << Qt::endl;
+        return 1;
+    }
+    int supersample = 1;
+    if (parser.isSet(supersampleOption)) {
+        supersample = parser.value(supersampleOption).toInt();
+        if (supersample != 1 && supersample != 2 && supersample != 4) {
+            err << "Supersampling must be 1, 2 or 4" << Qt::endl;
+            return 1;
+        }
+    }
+
+    QString outPath = parser.value(outOption);
+    if (outPath.isEmpty())
+        outPath = QFileInfo(projectPath).completeBaseName() + "_render";
+    const QString suffix = QFileInfo(outPath).suffix().toLower();
+    const bool video = suffix == "mp4" || suffix == "mkv" || suffix == "mov";
+
+    // yuv420p needs even dimensions, as in the export dialog
+    if (video) {
+        const QSize requested = size.isValid() ? size : QSize(project.width(), project.height());
+        size = QSize(requested.width() & ~1, requested.height() & ~1);
+        if (size.isEmpty()) {
+            err << "Video size must be at least 2x2" << Qt::endl;
+            return 1;
+        }
+        if (size != requested)
+            err << QString("Rounding the video size down to %1x%2")
+                       .arg(size.width()).arg(size.height()) << Qt::endl;
+    }
+
+    if (!video && !QDir().mkpath(outPath)) {
+        err << "Could not create output directory: " << outPath << Qt::endl;
+        return 1;
+    }
+
+    QList<int> frames;
+    for (int frame = first; frame <= last; ++frame)
+        frames.append(frame);
+
+    QElapsedTimer timer;
+    timer.start();
+    FrameRenderer renderer(&project);
+    renderer.setThreadCount(threads);
+    renderer.setOutputSize(size);
+    renderer.setSupersampling(supersample);
+    renderer.setDraft(parser.isSet(draftOption));
+    renderer.prepare(frames);
+
+    // Held drawings are painted once per hold
+    const QList<FrameRenderer::Run> runs = renderer.identityRuns(frames);
+    const int total = frames.size();
+    int done = 0;
+    auto reportProgress = [&](int count) {
+        const int before = done;
+        done += count;
+        if (done / 25 != before / 25 || done == total)
+            err << QString("Rendered %1/%2 frames").arg(done).arg(total) << Qt::endl;
+    };
+
+    if (video) {
+        FfmpegPipe ffmpeg(threads * 2);
+        const QStringList outputArgs{
+            "-c:v",     "libx264",
+            "-preset",  suffix == "mkv" ? "medium" : "slow",
+            "-crf",     "18",
+            "-pix_fmt", "yuv420p",
+            outPath
+        };
+        if (!ffmpeg.start(renderer.outputSize(), project.fps(), outputArgs)) {
+            err << ffmpeg.lastError() << Qt::endl;
+            return 1;
+        }
+        const bool ok = renderer.renderRuns(runs,
+            [&](const FrameRenderer::Run &run, const QImage &image, const QByteArray &) {
+                for (int i = 0; i < run.frames.size(); ++i)
+                    if (!ffmpeg.writeFrame(image)) return false;
+                reportProgress(run.frames.size());
+                return true;
+            });
+        if (!ffmpeg.finish() || !ok) {
+            err << "ffmpeg failed: " << ffmpeg.lastError().right(2000) << Qt::endl;
+            return 1;
+        }
+    } else {
+        // PNG compression runs on the render threads; files land in order.
+        // The rest of a run links to (or copies) its first file.
+        const bool ok = renderer.renderRuns(runs,
+            [&](const FrameRenderer::Run &run, const QImage &, const QByteArray &png) {
+                QString error;
+                if (!FrameRenderer::writeSequenceFiles(outPath, run.frames, png, &error)) {
+                    err << error << Qt::endl;
+                    return false;
+                }
+                reportProgress(run.frames.size());
+                return true;
+            }, &FrameRenderer::encodePng);
+        if (!ok) return 1;
+    }
+
+    const double seconds = timer.elapsed() / 1000.0;
+    err << QString("Rendered %1 frames to %2 in %3 s (%4 fps, %5 threads)")
+               .arg(total).arg(outPath).arg(seconds, 0, 'f', 1)
+               .arg(seconds > 0 ? total / seconds : 0.0, 0, 'f', 1).arg(threads)
+        << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef HEADLESSRENDERER_H
+#define HEADLESSRENDERER_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Renders a project from the command line, without any widgets
+ *
+ *   AkisVG --render shot.avg [--frames 1-500] [--out dir | file.mp4] [--threads N]
+ *          [--size WxH] [--supersample 2|4] [--draft]
+ *
+ * Frames are painted by FrameRenderer on a thread pool, so a shot can be
+ * rendered on a build server under the offscreen platform and split
+ * across processes by frame range. PNG sequences are named by absolute
+ * frame number (frame_000123.png), so several processes can write into
+ * the same directory.
+ */
+class HeadlessRenderer
+{
+public:
+    /**
+     * @brief True if the command line asks for a headless mode
+     *
+     * Checked in main() before the QApplication exists, so the offscreen
+     * platform can still be selected.
+     */
+    static bool isRequested(int argc, char *argv[]);
+
+    /**
+     * @brief Parse the arguments, render and return the process exit code
+     */
+    static int run(const QStringList &arguments);
+};
+
+#endif // HEADLESSRENDERER_H
@@ -0,0 +1,109 @@
+#include "imageblobstore.h"
+#include "projectarchive.h"
+#include "utils/parallel.h"
+#include <QBuffer>
+#include <QCryptographicHash>
+
+ImageBlobStore::ImageBlobStore(std::shared_ptr<ProjectArchive> source)
+    : m_source(std::move(source))
+{
+}
+
+QByteArray ImageBlobStore::contentHash(const QImage &image)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    const quint32 header[3] = { quint32(image.width()), quint32(image.height()),
+                                quint32(image.format()) };
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(header), sizeof(header)));
+    // Hash scanline by scanline so row padding never affects the key
+    const qsizetype rowBytes = (qsizetype(image.width()) * image.depth() + 7) / 8;
+    for (int y = 0; y < image.height(); ++y)
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(image.constScanLine(y)), rowBytes));
+    return hash.result().toHex();
+}
+
+QByteArray ImageBlobStore::addImage(const QImage &image)
+{
+    return add(image, image.cacheKey());
+}
+
+QByteArray ImageBlobStore::addPixmap(const QPixmap &pixmap)
+{
+    const qint64 key = pixmap.cacheKey();
+    if (m_hashByCacheKey.contains(key))
+        return m_hashByCacheKey.value(key);
+    if (m_source) {
+        QByteArray known = m_source->hashForCacheKey(key);
+        if (!known.isEmpty() && retain(known)) {
+            m_hashByCacheKey.insert(key, known);
+            return known;
+        }
+    }
+    return add(pixmap.toImage(), key);
+}
+
+QByteArray ImageBlobStore::addPixmapImage(qint64 cacheKey)
+{
+    // Keyed like the pixmap, so unchanged archive images are still reused
+    return add(m_pixmapImages.value(cacheKey), cacheKey);
+}
+
+QByteArray ImageBlobStore::add(const QImage &image, qint64 cacheKey)
+{
+    if (m_hashByCacheKey.contains(cacheKey))
+        return m_hashByCacheKey.value(cacheKey);
+
+    // Unchanged image straight from the archive: reuse its stored bytes
+    if (m_source) {
+        QByteArray known = m_source->hashForCacheKey(cacheKey);
+        if (!known.isEmpty() && retain(known)) {
+            m_hashByCacheKey.insert(cacheKey, known);
+            return known;
+        }
+    }
+
+    const QByteArray hash = contentHash(image);
+    m_hashByCacheKey.insert(cacheKey, hash);
+    if (m_blobs.contains(hash) || m_pending.contains(hash) || retain(hash))
+        return hash;
+
+    m_pending.insert(hash, image);
+    return hash;
+}
+
+const QHash<QByteArray, QByteArray>& ImageBlobStore::blobs()
+{
+    if (m_pending.isEmpty())
+        return m_blobs;
+
+    const QList<QByteArray> hashes = m_pending.keys();
+    QList<QByteArray> encoded(hashes.size());
+    parallelFor(hashes.size(), [&](int i) {
+        const QImage image = m_pending.value(hashes.at(i));
+        QByteArray &ba = encoded[i];
+        QBuffer buffer(&ba);
+        buffer.open(QIODevice::WriteOnly);
+        // WebP at quality 85 is ~3-5x smaller than PNG for photos/complex images.
+        // Fall back to PNG if WebP is unavailable (older Qt builds).
+        if (!image.save(&buffer, "WEBP", 85)) {
+            ba.clear();
+            buffer.seek(0);
+            image.save(&buffer, "PNG");
+        }
+    });
+    for (int i = 0; i < hashes.size(); ++i)
+        m_blobs.insert(hashes.at(i), encoded.at(i));
+    m_pending.clear();
+    return m_blobs;
+}
+
+bool ImageBlobStore::retain(const QByteArray &hash)
+{
+    if (m_blobs.contains(hash) || m_pending.contains(hash)) return true;
+    if (!m_source || !m_source->hasBlob(hash)) return false;
+    // A detached source may no longer have the bytes (see ProjectArchive::detach)
+    const QByteArray bytes = m_source->blob(hash);
+    if (bytes.isEmpty()) return false;
+    m_blobs.insert(hash, bytes);
+    return true;
+}
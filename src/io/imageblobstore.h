@@ -0,0 +1,60 @@
+#ifndef IMAGEBLOBSTORE_H
+#define IMAGEBLOBSTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <memory>
+
+class ProjectArchive;
+
+/**
+ * @brief Collects the image blobs written by one save
+ *
+ * Images are keyed by a SHA-256 of their pixels, so an image placed on
+ * 300 frames is encoded and stored once. Images that came out of the
+ * source archive unchanged are recognised by cacheKey() and their stored
+ * bytes are copied instead of being hashed and re-encoded.
+ *
+ * New images are only hashed while a save walks its frames; the WebP/PNG
+ * encoding is deferred to blobs(), which encodes them all in parallel.
+ */
+class ImageBlobStore
+{
+public:
+    explicit ImageBlobStore(std::shared_ptr<ProjectArchive> source = nullptr);
+
+    // Each returns the blob's hex hash, encoding the image only if needed
+    QByteArray addImage(const QImage &image);
+    QByteArray addPixmap(const QPixmap &pixmap);
+
+    // Pixmaps converted ahead of time on the GUI thread, by cacheKey(). A
+    // store saving on a worker thread takes these instead of any QPixmap.
+    void setPixmapImages(const QHash<qint64, QImage> &images) { m_pixmapImages = images; }
+    bool hasPixmapImage(qint64 cacheKey) const { return m_pixmapImages.contains(cacheKey); }
+    QImage pixmapImage(qint64 cacheKey) const { return m_pixmapImages.value(cacheKey); }
+    QByteArray addPixmapImage(qint64 cacheKey);
+
+    /**
+     * @brief Keep a blob referenced by a frame copied over undecoded
+     * @return false if the source archive does not have it
+     */
+    bool retain(const QByteArray &hash);
+
+    // hash -> encoded (WebP/PNG) bytes; encodes pending images on first call
+    const QHash<QByteArray, QByteArray>& blobs();
+
+    static QByteArray contentHash(const QImage &image);
+
+private:
+    QByteArray add(const QImage &image, qint64 cacheKey);
+
+    std::shared_ptr<ProjectArchive> m_source;
+    QHash<QByteArray, QByteArray> m_blobs;
+    QHash<QByteArray, QImage> m_pending;   // added but not encoded yet
+    QHash<qint64, QByteArray> m_hashByCacheKey;
+    QHash<qint64, QImage> m_pixmapImages;
+};
+
+#endif // IMAGEBLOBSTORE_H
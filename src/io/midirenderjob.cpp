@@ -0,0 +1,240 @@
+#include "midirenderjob.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QProcess>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QThread>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+MidiRenderJob::MidiRenderJob(const QString &midiPath, QObject *parent)
+    : QObject(parent)
+    , m_midiPath(midiPath)
+{
+    m_fluidsynth = findFluidsynth();
+    m_soundfont = findSoundfont(m_fluidsynth);
+    QSettings s("AkisVG", "AkisVG");
+    m_gain = s.value("midi/gain", 1.0).toDouble();
+}
+
+MidiRenderJob::~MidiRenderJob()
+{
+    if (m_worker) {
+        m_cancelled = true;
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+QString MidiRenderJob::findFluidsynth()
+{
+    QString fluidsynth = QStandardPaths::findExecutable("fluidsynth");
+
+#ifdef Q_OS_WIN
+    // On Windows, also check common install locations
+    if (fluidsynth.isEmpty()) {
+        const QStringList winPaths = {
+            "C:/Program Files/FluidSynth/bin/fluidsynth.exe",
+            "C:/Program Files (x86)/FluidSynth/bin/fluidsynth.exe",
+            QDir::homePath() + "/fluidsynth/bin/fluidsynth.exe",
+        };
+        for (const QString &p : winPaths) {
+            if (QFile::exists(p)) { fluidsynth = p; break; }
+        }
+    }
+#endif
+    return fluidsynth;
+}
+
+// The soundfont path is read first from QSettings (user-configured in the
+// Settings panel → Audio → MIDI Synthesizer), then falls back to the
+// standard system locations so it works out-of-the-box on most distros.
+QString MidiRenderJob::findSoundfont(const QString &fluidsynth)
+{
+    {
+        QSettings s("AkisVG", "AkisVG");
+        QString userSf2 = s.value("midi/soundfont").toString();
+        if (!userSf2.isEmpty() && QFile::exists(userSf2))
+            return userSf2;
+    }
+
+    // Common system locations (Arch, Debian/Ubuntu, Fedora, Windows)
+    QStringList sfPaths = {
+        "/usr/share/soundfonts/default.sf2",
+        "/usr/share/soundfonts/FluidR3_GM.sf2",
+        "/usr/share/soundfonts/GeneralUser-GS.sf2",
+        "/usr/share/sounds/sf2/FluidR3_GM.sf2",
+        "/usr/share/sounds/sf2/default-GM.sf2",
+        "/usr/share/sounds/sf2/TimGM6mb.sf2",
+        "/usr/share/sounds/sf2/SGM-v2.01-NicePianosGuitarsBass-V1.3.sf2",
+        // Arch: fluidsynth usually ships FluidR3_GM via extra/soundfont-fluid
+        "/usr/share/soundfonts/fluid-soundfont-gm.sf2",
+    };
+#ifdef Q_OS_WIN
+    // Windows: check next to fluidsynth binary, common install locations
+    QDir fluidsynthDir = QFileInfo(fluidsynth).absoluteDir();
+    sfPaths.prepend(fluidsynthDir.filePath("../share/soundfonts/default.sf2"));
+    sfPaths.prepend(fluidsynthDir.filePath("../share/soundfonts/FluidR3_GM.sf2"));
+    sfPaths.prepend("C:/Program Files/FluidSynth/share/soundfonts/FluidR3_GM.sf2");
+    sfPaths.prepend("C:/soundfonts/FluidR3_GM.sf2");
+    sfPaths.prepend("C:/soundfonts/default.sf2");
+    // Also check user's Documents folder
+    QString docs = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
+    sfPaths.prepend(docs + "/soundfonts/FluidR3_GM.sf2");
+    sfPaths.prepend(docs + "/FluidR3_GM.sf2");
+#else
+    Q_UNUSED(fluidsynth);
+#endif
+    for (const QString &p : sfPaths) {
+        if (QFile::exists(p)) return p;
+    }
+    return QString();
+}
+
+static QByteArray fileHash(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result();
+}
+
+// Soundfonts are often 100+ MB, so each one is hashed once per session
+// (per path, mtime and size). Held while hashing so parallel jobs wait for
+// the first instead of reading the file again.
+static QByteArray soundfontHash(const QString &path)
+{
+    static QMutex mutex;
+    static QHash<QString, QByteArray> hashes;
+    const QFileInfo info(path);
+    const QString key = QString("%1|%2|%3").arg(info.absoluteFilePath())
+                            .arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size());
+    QMutexLocker lock(&mutex);
+    auto it = hashes.constFind(key);
+    if (it != hashes.constEnd()) return it.value();
+    const QByteArray hash = fileHash(path);
+    if (!hash.isEmpty()) hashes.insert(key, hash);
+    return hash;
+}
+
+void MidiRenderJob::start()
+{
+    if (m_worker || m_finished) return;
+    m_worker = QThread::create([this]() { run(); });
+    connect(m_worker, &QThread::finished, this, &MidiRenderJob::finishWorker);
+    m_worker->start(QThread::LowPriority);
+}
+
+void MidiRenderJob::cancel()
+{
+    m_cancelled = true;
+}
+
+void MidiRenderJob::finishWorker()
+{
+    if (!m_worker) return;
+    m_worker->wait();
+    m_worker->deleteLater();
+    m_worker = nullptr;
+    m_finished = true;
+    if (!m_ok && !m_error.isEmpty())
+        qWarning() << "MIDI render:" << m_error;
+    emit finished(m_ok && !m_cancelled);
+}
+
+void MidiRenderJob::run()
+{
+    if (m_fluidsynth.isEmpty()) {
+        m_error = "fluidsynth not found in PATH";
+        return;
+    }
+    if (m_soundfont.isEmpty()) {
+        m_error = "no soundfont found — install soundfont-fluid (Arch) or fluid-soundfont-gm "
+                  "(Debian) or set a custom path in Settings → Audio → MIDI Soundfont";
+        return;
+    }
+
+    const QByteArray midiHash = fileHash(m_midiPath);
+    const QByteArray sf2Hash = soundfontHash(m_soundfont);
+    if (midiHash.isEmpty() || sf2Hash.isEmpty()) {
+        m_error = "could not read " + (midiHash.isEmpty() ? m_midiPath : m_soundfont);
+        return;
+    }
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(midiHash);
+    key.addData(sf2Hash);
+    key.addData(QByteArray::number(m_gain, 'g', 6));
+
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/midi";
+    const QString keyHex = QString::fromLatin1(key.result().toHex());
+    const QString wavPath = cacheDir + "/" + keyHex + ".wav";
+    if (QFile::exists(wavPath)) {
+        m_wavPath = wavPath;
+        m_ok = true;
+        return;
+    }
+    QDir().mkpath(cacheDir);
+
+    // Rendered to a file of its own next to the cache entry and renamed
+    // when complete: a cancelled or failed render never looks like a cache
+    // hit, and clips of the same MIDI file rendering at once never write
+    // to the same file. Removed on every early return.
+    QTemporaryFile part(cacheDir + "/" + keyHex + ".XXXXXX.part");
+    if (!part.open()) {
+        m_error = "could not write to " + cacheDir + ": " + part.errorString();
+        return;
+    }
+    part.close();   // fluidsynth writes it; the name stays ours
+    const QString partPath = part.fileName();
+
+    // fluidsynth -ni -g 1.0 -F output.wav soundfont.sf2 input.mid
+    QStringList args = { "-ni", "-g", QString::number(m_gain), "-T", "wav", "-F", partPath,
+                         m_soundfont, m_midiPath };
+    QProcess proc;
+#ifdef Q_OS_WIN
+    // On Windows, hide the console window that fluidsynth spawns
+    proc.setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments *args) {
+        args->flags |= CREATE_NO_WINDOW;
+    });
+#endif
+    proc.start(m_fluidsynth, args);
+    if (!proc.waitForStarted(5000)) {
+        m_error = "could not start fluidsynth: " + proc.errorString();
+        return;
+    }
+    while (!proc.waitForFinished(100)) {
+        if (m_cancelled) {
+            proc.kill();
+            proc.waitForFinished(-1);
+            return;
+        }
+    }
+    if (proc.exitStatus() != QProcess::NormalExit || proc.exitCode() != 0
+        || part.size() == 0) {
+        m_error = "fluidsynth failed: " + QString::fromLocal8Bit(proc.readAllStandardError());
+        return;
+    }
+    // rename() never replaces a file: if another job got there first, its
+    // render (of the same key) is used and ours is dropped
+    if (part.rename(wavPath)) {
+        part.setAutoRemove(false);
+    } else if (!QFile::exists(wavPath)) {
+        m_error = "could not write " + wavPath;
+        return;
+    }
+
+    qDebug() << "MIDI rendered to" << wavPath << "using" << m_soundfont;
+    m_wavPath = wavPath;
+    m_ok = true;
+}
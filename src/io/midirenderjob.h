@@ -0,0 +1,60 @@
+#ifndef MIDIRENDERJOB_H
+#define MIDIRENDERJOB_H
+
+#include <QObject>
+#include <QString>
+#include <atomic>
+
+class QThread;
+
+/**
+ * @brief Renders one MIDI file to a WAV with FluidSynth in the background
+ *
+ * Rendered files are cached under a key of the MIDI file's content hash,
+ * the soundfont's content hash and the gain, so a clip is only rendered
+ * again when one of those changes. A cache hit finishes without starting
+ * FluidSynth. Each job has its own worker thread, so several clips render
+ * in parallel.
+ */
+class MidiRenderJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    // The soundfont and gain are read from the settings when the job is made
+    explicit MidiRenderJob(const QString &midiPath, QObject *parent = nullptr);
+    ~MidiRenderJob();   // cancels a running job and waits for it
+
+    QString midiPath() const { return m_midiPath; }
+    QString wavPath() const { return m_wavPath; }   // set once finished(true)
+    QString lastError() const { return m_error; }
+
+    void start();
+    void cancel();
+    bool isFinished() const { return m_finished; }
+
+    // Empty if not installed / none found
+    static QString findFluidsynth();
+    static QString findSoundfont(const QString &fluidsynth);
+
+signals:
+    void finished(bool ok);
+
+private:
+    void run();   // worker thread
+    void finishWorker();
+
+    QString m_midiPath;
+    QString m_fluidsynth;
+    QString m_soundfont;
+    double m_gain = 1.0;
+
+    QThread *m_worker = nullptr;
+    std::atomic<bool> m_cancelled{false};
+    bool m_ok = false;                // written by the worker, read after it ends
+    bool m_finished = false;
+    QString m_wavPath;
+    QString m_error;
+};
+
+#endif // MIDIRENDERJOB_H
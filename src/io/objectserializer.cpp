@@ -0,0 +1,430 @@
+#include "objectserializer.h"
+#include "imageblobstore.h"
+#include "projectarchive.h"
+#include "canvas/objects/vectorobject.h"
+#include "canvas/objects/pathobject.h"
+#include "canvas/objects/shapeobject.h"
+#include "canvas/objects/textobject.h"
+#include "canvas/objects/imageobject.h"
+#include "canvas/objects/transformableimageobject.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QBuffer>
+#include <QColor>
+#include <QDebug>
+
+// ── RDP path simplification (mirrors vectorcanvas.cpp) ───────────────────────
+// Applied whenever a path is decoded to clean up any paths saved before the
+// stroke-time simplification was added (e.g. the BackupTestSave.avg project).
+static void rdpRecurseP(const QVector<QPointF> &pts, int lo, int hi,
+                        qreal eps, QVector<bool> &keep)
+{
+    if (hi <= lo + 1) return;
+    const QPointF &a = pts[lo], &b = pts[hi];
+    qreal dx = b.x()-a.x(), dy = b.y()-a.y(), len2 = dx*dx+dy*dy;
+    qreal maxD2 = 0; int maxI = lo;
+    for (int i = lo+1; i < hi; ++i) {
+        qreal d2;
+        if (len2 < 1e-10) { qreal ex=pts[i].x()-a.x(),ey=pts[i].y()-a.y(); d2=ex*ex+ey*ey; }
+        else { qreal c=(pts[i].x()-a.x())*dy-(pts[i].y()-a.y())*dx; d2=(c*c)/len2; }
+        if (d2 > maxD2) { maxD2=d2; maxI=i; }
+    }
+    if (maxD2 > eps*eps) { keep[maxI]=true; rdpRecurseP(pts,lo,maxI,eps,keep); rdpRecurseP(pts,maxI,hi,eps,keep); }
+}
+
+static QPainterPath rdpSimplifyPath(const QPainterPath &src, qreal epsilon = 1.0)
+{
+    const int n = src.elementCount();
+    if (n < 3) return src;
+    QPainterPath result;
+    QVector<QPointF> run;
+    auto flush = [&]() {
+        if (run.size() < 2) { if (!run.isEmpty()) result.lineTo(run[0]); run.clear(); return; }
+        QVector<bool> keep(run.size(), false);
+        keep.front() = keep.back() = true;
+        rdpRecurseP(run, 0, run.size()-1, epsilon, keep);
+        for (int i = 1; i < run.size(); ++i) if (keep[i]) result.lineTo(run[i]);
+        run.clear();
+    };
+    for (int i = 0; i < n; ++i) {
+        auto e = src.elementAt(i);
+        if      (e.type == QPainterPath::MoveToElement)  { flush(); result.moveTo(e.x,e.y); run << QPointF(e.x,e.y); }
+        else if (e.type == QPainterPath::LineToElement)   { run << QPointF(e.x,e.y); }
+        else { flush(); if (e.type==QPainterPath::CurveToElement && i+2<n) { auto c2=src.elementAt(i+1),ep=src.elementAt(i+2); result.cubicTo(e.x,e.y,c2.x,c2.y,ep.x,ep.y); i+=2; } }
+    }
+    flush();
+    return result;
+}
+// ── End RDP ───────────────────────────────────────────────────────────────────
+
+// ============= OBJECTS =============
+
+QJsonObject ObjectSerializer::toJson(VectorObject *obj, ImageBlobStore *blobs)
+{
+    if (!obj) return QJsonObject();
+
+    QJsonObject data;
+
+    // Common properties
+    data["type"] = static_cast<int>(obj->objectType());
+    data["pos_x"] = obj->pos().x();
+    data["pos_y"] = obj->pos().y();
+    data["rotation"] = obj->rotation();
+    data["scale"] = obj->scale();
+    data["strokeColor"] = obj->strokeColor().name(QColor::HexArgb);
+    data["fillColor"] = obj->fillColor().name(QColor::HexArgb);
+    data["strokeWidth"] = obj->strokeWidth();
+    data["opacity"] = obj->objectOpacity();
+    data["zValue"] = obj->zValue();
+
+    // Type-specific properties
+    switch (obj->objectType()) {
+    case VectorObjectType::Path: {
+        PathObject *path = static_cast<PathObject*>(obj);
+        QPainterPath painterPath = path->path();
+
+        // Serialize path elements
+        QJsonArray elementsArray;
+        for (int i = 0; i < painterPath.elementCount(); ++i) {
+            QPainterPath::Element elem = painterPath.elementAt(i);
+            QJsonObject elemObj;
+            elemObj["type"] = elem.type;
+            // Round to 2 decimal places — sub-pixel precision is invisible
+            // but full double (15+ digits) balloons file size enormously
+            elemObj["x"] = qRound(elem.x * 100.0) / 100.0;
+            elemObj["y"] = qRound(elem.y * 100.0) / 100.0;
+            elementsArray.append(elemObj);
+        }
+        data["pathElements"] = elementsArray;
+        data["smoothPaths"] = path->smoothPaths();
+        data["texture"] = static_cast<int>(path->texture());
+        break;
+    }
+
+    case VectorObjectType::Rectangle:
+    case VectorObjectType::Ellipse: {
+        ShapeObject *shape = static_cast<ShapeObject*>(obj);
+        data["width"] = shape->rect().width();
+        data["height"] = shape->rect().height();
+        data["rect_x"] = shape->rect().x();
+        data["rect_y"] = shape->rect().y();
+        break;
+    }
+
+    case VectorObjectType::Text: {
+        TextObject *text = static_cast<TextObject*>(obj);
+        data["text"] = text->text();
+        data["fontFamily"] = text->fontFamily();
+        data["fontSize"] = text->fontSize();
+        // TextObject doesn't store bold/italic currently, just family and size
+        break;
+    }
+
+    case VectorObjectType::Image: {
+        // Handle both ImageObject and TransformableImageObject (which also reports Image type)
+        QImage image;
+        QPixmap pixmap;
+        qint64 pixmapKey = 0;
+        bool converted = false;   // pixmap handed over as QImage (see ProjectSnapshot)
+        qreal imgW = 0, imgH = 0;
+        QPointF imgPos;
+        qreal imgAngle = 0;
+        bool isTransformable = false;
+
+        if (auto *timg = dynamic_cast<TransformableImageObject*>(obj)) {
+            // TransformableImageObject stores its own position, size, angle
+            image = timg->getImage();
+            imgW = timg->imgWidth();
+            imgH = timg->imgHeight();
+            imgPos = timg->position();
+            imgAngle = timg->imgAngle();
+            isTransformable = true;
+        } else if (auto *img = dynamic_cast<ImageObject*>(obj)) {
+            pixmapKey = img->imageKey();
+            converted = blobs && blobs->hasPixmapImage(pixmapKey);
+            if (converted)
+                image = blobs->pixmapImage(pixmapKey);
+            else
+                pixmap = img->image();
+        }
+
+        if (blobs) {
+            // Stored once in the archive's blob section, referenced by hash
+            const bool hasImage = isTransformable || converted;
+            data["imageBlob"] = QString::fromLatin1(isTransformable ? blobs->addImage(image)
+                                                    : converted     ? blobs->addPixmapImage(pixmapKey)
+                                                                    : blobs->addPixmap(pixmap));
+            data["imageWidth"]  = hasImage ? image.width()  : pixmap.width();
+            data["imageHeight"] = hasImage ? image.height() : pixmap.height();
+        } else {
+            if (!isTransformable) image = pixmap.toImage();
+            QByteArray ba;
+            QBuffer buffer(&ba);
+            buffer.open(QIODevice::WriteOnly);
+            // WebP at quality 85 is ~3-5x smaller than PNG for photos/complex images.
+            // Fall back to PNG if WebP is unavailable (older Qt builds).
+            bool savedOk = image.save(&buffer, "WEBP", 85);
+            if (!savedOk) {
+                ba.clear();
+                buffer.seek(0);
+                image.save(&buffer, "PNG");
+            }
+            data["imageData"] = QString(ba.toBase64());
+            data["imageFmt"]  = savedOk ? QString("WEBP") : QString("PNG");
+            data["imageWidth"] = image.width();
+            data["imageHeight"] = image.height();
+        }
+        if (isTransformable) {
+            data["isTransformable"] = true;
+            data["img_w"] = imgW;
+            data["img_h"] = imgH;
+            data["img_pos_x"] = imgPos.x();
+            data["img_pos_y"] = imgPos.y();
+            data["img_angle"] = imgAngle;
+        }
+        break;
+    }
+    }
+
+    return data;
+}
+
+VectorObject* ObjectSerializer::fromJson(const QJsonObject &data, const ProjectArchive *archive)
+{
+    return create(parse(data, archive), archive);
+}
+
+ObjectSerializer::ObjectData ObjectSerializer::parse(const QJsonObject &data,
+                                                     const ProjectArchive *archive)
+{
+    ObjectData parsed;
+    parsed.json = data;
+
+    switch (static_cast<VectorObjectType>(data["type"].toInt())) {
+    case VectorObjectType::Path: {
+        // Restore path elements
+        const QJsonArray elementsArray = data["pathElements"].toArray();
+        QPainterPath painterPath;
+
+        for (const QJsonValue &elemVal : elementsArray) {
+            QJsonObject elemObj = elemVal.toObject();
+            QPainterPath::ElementType type = static_cast<QPainterPath::ElementType>(elemObj["type"].toInt());
+            qreal x = elemObj["x"].toDouble();
+            qreal y = elemObj["y"].toDouble();
+
+            switch (type) {
+            case QPainterPath::MoveToElement:
+                painterPath.moveTo(x, y);
+                break;
+            case QPainterPath::LineToElement:
+                painterPath.lineTo(x, y);
+                break;
+            case QPainterPath::CurveToElement:
+            case QPainterPath::CurveToDataElement:
+                // Handle curves (simplified)
+                painterPath.lineTo(x, y);
+                break;
+            }
+        }
+
+        // Files saved before stroke-time RDP was added can have hundreds of
+        // near-duplicate points per stroke. Simplify them as they are decoded;
+        // the next save writes the simplified path and this becomes a no-op.
+        QPainterPath simplified = rdpSimplifyPath(painterPath, 1.0);
+        if (simplified.elementCount() < painterPath.elementCount())
+            painterPath = simplified;
+
+        parsed.path = painterPath;
+        break;
+    }
+
+    case VectorObjectType::Image: {
+        // Blob references share one decoded image per hash (see ProjectArchive);
+        // inline base64 data uses the saved format tag if present, PNG for legacy files
+        const QByteArray blobHash = data["imageBlob"].toString().toLatin1();
+        if (archive && !blobHash.isEmpty()) {
+            parsed.image = archive->image(blobHash);
+        } else {
+            QByteArray ba = QByteArray::fromBase64(data["imageData"].toString().toLatin1());
+            QString fmt = data["imageFmt"].toString("PNG");
+            parsed.image.loadFromData(ba, fmt.toLatin1().constData());
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    return parsed;
+}
+
+VectorObject* ObjectSerializer::create(const ObjectData &parsed, const ProjectArchive *archive)
+{
+    const QJsonObject &data = parsed.json;
+    if (data.isEmpty()) return nullptr;
+
+    VectorObjectType objType = static_cast<VectorObjectType>(data["type"].toInt());
+    VectorObject *obj = nullptr;
+
+    switch (objType) {
+    case VectorObjectType::Path: {
+        PathObject *path = new PathObject();
+        path->setPath(parsed.path);
+        path->setSmoothPaths(data["smoothPaths"].toBool(true));
+        path->setTexture(static_cast<PathTexture>(data["texture"].toInt()));
+        obj = path;
+        break;
+    }
+
+    case VectorObjectType::Rectangle: {
+        // FIXED: Removed the redundant ShapeType:: scope
+        ShapeObject *shape = new ShapeObject(ShapeObject::Rectangle);
+        qreal w = data["width"].toDouble();
+        qreal h = data["height"].toDouble();
+        qreal x = data["rect_x"].toDouble();
+        qreal y = data["rect_y"].toDouble();
+        shape->setRect(QRectF(x, y, w, h));
+        obj = shape;
+        break;
+    }
+
+    case VectorObjectType::Ellipse: {
+        // FIXED: Removed the redundant ShapeType:: scope
+        ShapeObject *shape = new ShapeObject(ShapeObject::Ellipse);
+        qreal w = data["width"].toDouble();
+        qreal h = data["height"].toDouble();
+        qreal x = data["rect_x"].toDouble();
+        qreal y = data["rect_y"].toDouble();
+        shape->setRect(QRectF(x, y, w, h));
+        obj = shape;
+        break;
+    }
+
+    case VectorObjectType::Text: {
+        TextObject *text = new TextObject();
+        text->setText(data["text"].toString());
+        text->setFontFamily(data["fontFamily"].toString("Arial"));
+        text->setFontSize(data["fontSize"].toInt(12));
+        obj = text;
+        break;
+    }
+
+    case VectorObjectType::Image: {
+        // Pixmaps are GUI-thread objects, so they are made here rather than
+        // in parse(); blob pixmaps are shared through the archive's cache
+        const QByteArray blobHash = data["imageBlob"].toString().toLatin1();
+        const bool fromBlob = archive && !blobHash.isEmpty();
+        const QImage &image = parsed.image;
+
+        if (data["isTransformable"].toBool(false)) {
+            // Reconstruct as TransformableImageObject
+            auto *timg = fromBlob
+                ? new TransformableImageObject(image, archive->pixmap(blobHash))
+                : new TransformableImageObject(image);
+            timg->setImgSize(data["img_w"].toDouble(image.width()),
+                             data["img_h"].toDouble(image.height()));
+            timg->setPosition(QPointF(data["img_pos_x"].toDouble(0),
+                                      data["img_pos_y"].toDouble(0)));
+            timg->setImgAngle(data["img_angle"].toDouble(0));
+            obj = timg;
+        } else {
+            ImageObject *img = new ImageObject();
+            img->setImage(fromBlob ? archive->pixmap(blobHash) : QPixmap::fromImage(image));
+            obj = img;
+        }
+        break;
+    }
+    }
+
+    if (obj) {
+        // Restore common properties
+        obj->setPos(data["pos_x"].toDouble(), data["pos_y"].toDouble());
+        obj->setRotation(data["rotation"].toDouble());
+        obj->setScale(data["scale"].toDouble(1.0));
+        obj->setStrokeColor(QColor(data["strokeColor"].toString("#000000")));
+        obj->setFillColor(QColor(data["fillColor"].toString("#00000000")));
+        obj->setStrokeWidth(data["strokeWidth"].toDouble(1.0));
+        obj->setObjectOpacity(data["opacity"].toDouble(1.0));
+        obj->setZValue(data["zValue"].toDouble(0.0));
+    }
+
+    return obj;
+}
+
+// ============= FRAMES =============
+
+QByteArray ObjectSerializer::encodeFrame(const QList<VectorObject*> &objects,
+                                         ImageBlobStore *blobs,
+                                         QList<QByteArray> *blobRefs,
+                                         int compressionLevel)
+{
+    return compressFrame(frameJson(objects, blobs, blobRefs), compressionLevel);
+}
+
+QJsonObject ObjectSerializer::frameJson(const QList<VectorObject*> &objects,
+                                        ImageBlobStore *blobs,
+                                        QList<QByteArray> *blobRefs)
+{
+    QJsonArray objectsArray;
+    for (VectorObject *obj : objects) {
+        QJsonObject objData = toJson(obj, blobs);
+        if (blobRefs && objData.contains("imageBlob")) {
+            const QByteArray hash = objData["imageBlob"].toString().toLatin1();
+            if (!blobRefs->contains(hash)) blobRefs->append(hash);
+        }
+        objectsArray.append(objData);
+    }
+    QJsonObject frameObj;
+    frameObj["objects"] = objectsArray;
+    return frameObj;
+}
+
+QByteArray ObjectSerializer::compressFrame(const QJsonObject &frame, int compressionLevel,
+                                           qint64 *rawSize)
+{
+    const QByteArray json = QJsonDocument(frame).toJson(QJsonDocument::Compact);
+    if (rawSize) *rawSize = json.size();
+    return qCompress(json, compressionLevel);
+}
+
+QList<VectorObject*> ObjectSerializer::decodeFrame(const QByteArray &chunk,
+                                                  const ProjectArchive *archive)
+{
+    return createFrame(parseFrame(chunk, archive), archive);
+}
+
+QList<ObjectSerializer::ObjectData> ObjectSerializer::parseFrame(const QByteArray &chunk,
+                                                                 const ProjectArchive *archive)
+{
+    QList<ObjectData> frame;
+    QByteArray json = qUncompress(chunk);
+    if (json.isEmpty()) {
+        qWarning() << "Failed to decompress frame chunk";
+        return frame;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(json);
+    if (!doc.isObject()) {
+        qWarning() << "Invalid frame chunk";
+        return frame;
+    }
+
+    const QJsonArray objectsArray = doc.object()["objects"].toArray();
+    frame.reserve(objectsArray.size());
+    for (const QJsonValue &objVal : objectsArray)
+        frame.append(parse(objVal.toObject(), archive));
+    return frame;
+}
+
+QList<VectorObject*> ObjectSerializer::createFrame(const QList<ObjectData> &frame,
+                                                  const ProjectArchive *archive)
+{
+    QList<VectorObject*> objects;
+    objects.reserve(frame.size());
+    for (const ObjectData &data : frame) {
+        if (VectorObject *obj = create(data, archive))
+            objects.append(obj);
+    }
+    return objects;
+}
@@ -0,0 +1,84 @@
+#ifndef OBJECTSERIALIZER_H
+#define OBJECTSERIALIZER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QJsonObject>
+#include <QList>
+#include <QPainterPath>
+
+class VectorObject;
+class ImageBlobStore;
+class ProjectArchive;
+
+/**
+ * @brief JSON (de)serialization of canvas objects and whole frames
+ *
+ * Shared by Project (save / legacy load) and by Layer, which decodes
+ * archived frames on first access. Keeping both paths here guarantees a
+ * frame looks the same whether it was loaded eagerly or lazily.
+ *
+ * Images are written as blob references when an ImageBlobStore is given
+ * and embedded as base64 otherwise; both forms are read back.
+ *
+ * Reading is split in two: parse() does the pure computation (path
+ * reconstruction and simplification, image decoding) and is thread-safe;
+ * create() only builds the QGraphicsItem and must run on the GUI thread.
+ * fromJson()/decodeFrame() do both in one go.
+ */
+class ObjectSerializer
+{
+public:
+    // Plain decoded form of one object, as produced by parse()
+    struct ObjectData {
+        QJsonObject  json;    // scalar properties, read by create()
+        QPainterPath path;    // Path objects: rebuilt and simplified
+        QImage       image;   // Image objects: decoded pixels
+    };
+
+    static QJsonObject toJson(VectorObject *obj, ImageBlobStore *blobs = nullptr);
+    static VectorObject* fromJson(const QJsonObject &data,
+                                  const ProjectArchive *archive = nullptr);
+
+    static ObjectData parse(const QJsonObject &data, const ProjectArchive *archive = nullptr);
+    static VectorObject* create(const ObjectData &data, const ProjectArchive *archive = nullptr);
+
+    /**
+     * @brief Encode a frame's objects as one compressed chunk
+     * @param objects Objects of a single keyframe
+     * @param blobs Receives the frame's images (nullptr = embed inline)
+     * @param blobRefs Receives the hashes of the blobs the frame references
+     * @param compressionLevel qCompress level (1-9)
+     * @return qCompress'd compact JSON of the form {"objects": [...]}
+     */
+    static QByteArray encodeFrame(const QList<VectorObject*> &objects,
+                                  ImageBlobStore *blobs = nullptr,
+                                  QList<QByteArray> *blobRefs = nullptr,
+                                  int compressionLevel = 7);
+
+    // The two halves of encodeFrame(): frameJson() reads the live objects
+    // (GUI thread), compressFrame() is pure CPU work and thread-safe, so a
+    // save can compress many frames at once
+    static QJsonObject frameJson(const QList<VectorObject*> &objects,
+                                 ImageBlobStore *blobs = nullptr,
+                                 QList<QByteArray> *blobRefs = nullptr);
+    static QByteArray compressFrame(const QJsonObject &frame, int compressionLevel = 7,
+                                    qint64 *rawSize = nullptr);
+
+    /**
+     * @brief Decode a chunk produced by encodeFrame()
+     * @param archive Source of referenced image blobs
+     * @return Newly created objects, owned by the caller (empty on error)
+     */
+    static QList<VectorObject*> decodeFrame(const QByteArray &chunk,
+                                            const ProjectArchive *archive = nullptr);
+
+    // The two halves of decodeFrame(): parseFrame() is thread-safe,
+    // createFrame() runs on the GUI thread
+    static QList<ObjectData> parseFrame(const QByteArray &chunk,
+                                        const ProjectArchive *archive = nullptr);
+    static QList<VectorObject*> createFrame(const QList<ObjectData> &frame,
+                                            const ProjectArchive *archive = nullptr);
+};
+
+#endif // OBJECTSERIALIZER_H
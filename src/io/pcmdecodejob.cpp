@@ -0,0 +1,194 @@
+#include "pcmdecodejob.h"
+#include "core/waveformpeaks.h"
+
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
+
+// How often a partial waveform is handed to the timeline while decoding
+static const int PublishIntervalMs = 250;
+
+PcmDecodeJob::PcmDecodeJob(const QString &audioPath, QObject *parent)
+    : QObject(parent)
+    , m_audioPath(audioPath)
+{
+}
+
+PcmDecodeJob::~PcmDecodeJob()
+{
+    if (m_worker) {
+        m_cancelled = true;
+        m_worker->wait();
+        delete m_worker;
+    }
+}
+
+QString PcmDecodeJob::cacheFilePath(const QString &audioPath)
+{
+    const QFileInfo info(audioPath);
+    if (!info.exists()) return QString();
+    const QByteArray key = QString("%1|%2|%3").arg(info.absoluteFilePath())
+                               .arg(info.lastModified().toMSecsSinceEpoch())
+                               .arg(info.size()).toUtf8();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/waveforms/"
+         + QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex() + ".peaks";
+}
+
+void PcmDecodeJob::start()
+{
+    if (m_worker || m_finished) return;
+    m_worker = QThread::create([this]() { run(); });
+    connect(m_worker, &QThread::finished, this, &PcmDecodeJob::finishWorker);
+    m_worker->start(QThread::LowPriority);
+}
+
+void PcmDecodeJob::cancel()
+{
+    m_cancelled = true;
+}
+
+void PcmDecodeJob::finishWorker()
+{
+    if (!m_worker) return;
+    m_worker->wait();
+    m_worker->deleteLater();
+    m_worker = nullptr;
+    m_finished = true;
+    emit finished(m_pcm != nullptr && !m_cancelled);
+}
+
+void PcmDecodeJob::publishPeaks(std::shared_ptr<const WaveformPeaks> peaks)
+{
+    QMetaObject::invokeMethod(this, [this, peaks]() {
+        m_peaks = peaks;
+        emit peaksUpdated();
+    }, Qt::QueuedConnection);
+}
+
+void PcmDecodeJob::publishDuration(qint64 ms)
+{
+    if (ms <= 0) return;
+    QMetaObject::invokeMethod(this, [this, ms]() {
+        if (ms == m_durationMs) return;
+        m_durationMs = ms;
+        emit durationKnown(ms);
+    }, Qt::QueuedConnection);
+}
+
+bool PcmDecodeJob::toFloatSamples(const QAudioBuffer &buffer, QVector<float> *samples)
+{
+    const int count = buffer.frameCount() * qMax(1, buffer.format().channelCount());
+    samples->resize(count);
+    switch (buffer.format().sampleFormat()) {
+    case QAudioFormat::Float:
+        std::copy_n(buffer.constData<float>(), count, samples->data());
+        return true;
+    case QAudioFormat::Int16:
+        for (int i = 0; i < count; ++i)
+            (*samples)[i] = buffer.constData<qint16>()[i] / 32768.0f;
+        return true;
+    case QAudioFormat::Int32:
+        for (int i = 0; i < count; ++i)
+            (*samples)[i] = float(buffer.constData<qint32>()[i] / 2147483648.0);
+        return true;
+    case QAudioFormat::UInt8:
+        for (int i = 0; i < count; ++i)
+            (*samples)[i] = (buffer.constData<quint8>()[i] - 128) / 128.0f;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void PcmDecodeJob::run()
+{
+    // A cached pyramid is shown at once; the samples are still needed for
+    // playback, but no peaks are built from them
+    const QString cachePath = cacheFilePath(m_audioPath);
+    std::shared_ptr<WaveformPeaks> peaks;
+    auto cached = std::make_shared<WaveformPeaks>();
+    if (!cachePath.isEmpty() && cached->load(cachePath)) {
+        publishDuration(cached->durationMs());
+        publishPeaks(cached);
+    } else {
+        peaks = std::make_shared<WaveformPeaks>();
+    }
+
+    // The decoder needs an event loop; this one belongs to the worker
+    QEventLoop loop;
+    QAudioDecoder decoder;
+    decoder.setSource(QUrl::fromLocalFile(m_audioPath));
+
+    auto pcm = std::make_shared<PcmAudio>();
+    QVector<float> samples;
+    QElapsedTimer sincePublish;
+    sincePublish.start();
+    bool failed = false;
+
+    QObject::connect(&decoder, &QAudioDecoder::bufferReady, [&]() {
+        const QAudioBuffer buffer = decoder.read();
+        if (!buffer.isValid()) return;
+        const int channelCount = qMax(1, buffer.format().channelCount());
+        if (pcm->channelCount == 0) {
+            pcm->channelCount = channelCount;
+            pcm->sampleRate = buffer.format().sampleRate();
+            if (peaks) peaks->setFormat(channelCount, pcm->sampleRate);
+        }
+        if (channelCount != pcm->channelCount || !toFloatSamples(buffer, &samples)) return;
+        pcm->samples += samples;
+        if (!peaks) return;
+
+        // The waveform is summarised from the same buffer the mixer gets
+        peaks->addSamples(samples.constData(), buffer.frameCount());
+        if (sincePublish.elapsed() >= PublishIntervalMs) {
+            // A finished copy of what has been decoded so far
+            auto partial = std::make_shared<WaveformPeaks>(*peaks);
+            partial->finish();
+            publishPeaks(partial);
+            sincePublish.restart();
+        }
+    });
+    QObject::connect(&decoder, &QAudioDecoder::durationChanged,
+                     [this](qint64 ms) { publishDuration(ms); });
+    QObject::connect(&decoder, &QAudioDecoder::finished, &loop, &QEventLoop::quit);
+    QObject::connect(&decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
+        [&](QAudioDecoder::Error) {
+            qWarning() << "Audio decode: could not decode" << m_audioPath << decoder.errorString();
+            failed = true;
+            loop.quit();
+        });
+
+    QTimer cancelCheck;
+    QObject::connect(&cancelCheck, &QTimer::timeout, [&]() { if (m_cancelled) loop.quit(); });
+    cancelCheck.start(100);
+
+    decoder.start();
+    loop.exec();
+    decoder.stop();
+
+    if (m_cancelled || failed || pcm->frameCount() == 0 || pcm->sampleRate <= 0) return;
+    pcm->samples.squeeze();
+
+    if (peaks) {
+        peaks->finish();
+        if (!cachePath.isEmpty()) {
+            QDir().mkpath(QFileInfo(cachePath).absolutePath());
+            if (!peaks->save(cachePath))
+                qWarning() << "Audio decode: could not write waveform cache" << cachePath;
+        }
+        publishDuration(peaks->durationMs());
+        publishPeaks(peaks);
+    }
+    m_pcm = pcm;
+}
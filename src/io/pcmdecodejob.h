@@ -0,0 +1,86 @@
+#ifndef PCMDECODEJOB_H
+#define PCMDECODEJOB_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+class QAudioBuffer;
+class QThread;
+class WaveformPeaks;
+
+/**
+ * @brief A whole audio file decoded to interleaved float samples
+ */
+struct PcmAudio {
+    int sampleRate = 0;
+    int channelCount = 0;
+    QVector<float> samples;   // interleaved, in [-1, 1]
+
+    qint64 frameCount() const { return channelCount > 0 ? samples.size() / channelCount : 0; }
+};
+
+/**
+ * @brief Decodes one audio file in the background, for playback and the timeline
+ *
+ * The file is decoded once. The samples are kept at the file's own rate
+ * and channel count for the AudioMixer, which resamples while it mixes,
+ * and the timeline's WaveformPeaks pyramid is built from the same buffers.
+ * The partial pyramid is published a few times a second, so a long track
+ * fills in while the user keeps working. Clips that share a file share the
+ * result, so every file is decoded once per session.
+ *
+ * Finished pyramids are cached on disk under a key of the file's path,
+ * modification time and size; with a cached pyramid the waveform shows at
+ * once and only the samples are decoded.
+ */
+class PcmDecodeJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PcmDecodeJob(const QString &audioPath, QObject *parent = nullptr);
+    ~PcmDecodeJob();   // cancels a running job and waits for it
+
+    QString audioPath() const { return m_audioPath; }
+
+    void start();
+    void cancel();
+    bool isFinished() const { return m_finished; }
+
+    // Set once finished(true) was emitted
+    std::shared_ptr<const PcmAudio> pcm() const { return m_pcm; }
+    // Latest pyramid (partial until finished(true)) and duration (-1 = unknown)
+    std::shared_ptr<const WaveformPeaks> peaks() const { return m_peaks; }
+    qint64 durationMs() const { return m_durationMs; }
+
+    // Where the peaks of this file are cached (empty if it does not exist)
+    static QString cacheFilePath(const QString &audioPath);
+
+    // Decoder buffers come in whatever sample format the backend picked;
+    // false for formats that can not be read
+    static bool toFloatSamples(const QAudioBuffer &buffer, QVector<float> *samples);
+
+signals:
+    void durationKnown(qint64 ms);
+    void peaksUpdated();
+    void finished(bool ok);
+
+private:
+    void run();   // worker thread
+    void publishPeaks(std::shared_ptr<const WaveformPeaks> peaks);
+    void publishDuration(qint64 ms);
+    void finishWorker();
+
+    QString m_audioPath;
+    QThread *m_worker = nullptr;
+    std::atomic<bool> m_cancelled{false};
+    bool m_finished = false;
+    std::shared_ptr<const PcmAudio> m_pcm;   // written by the worker, read after it ends
+    std::shared_ptr<const WaveformPeaks> m_peaks;
+    qint64 m_durationMs = -1;
+};
+
+#endif // PCMDECODEJOB_H
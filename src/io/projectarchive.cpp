@@ -0,0 +1,505 @@
+#include "projectarchive.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+// Make an appended record durable before reporting the save as done
+static bool syncToDisk(QFile &file)
+{
+    if (!file.flush()) return false;
+#ifdef Q_OS_UNIX
+    return ::fsync(file.handle()) == 0;
+#else
+    return true;
+#endif
+}
+
+static quint64 chunkKey(quint32 layer, qint32 frame)
+{
+    return (quint64(layer) << 32) | quint32(frame);
+}
+
+ProjectArchive::ProjectArchive()
+{
+}
+
+ProjectArchive::~ProjectArchive()
+{
+    close();
+}
+
+void ProjectArchive::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+}
+
+void ProjectArchive::detach(const QList<ArchiveChunk> &chunks, const QSet<QByteArray> &blobs)
+{
+    if (!m_file.isOpen()) return;
+
+    QHash<quint64, QByteArray> kept;
+    QSet<QByteArray> keepBlobs = blobs;
+    for (const ArchiveChunk &c : chunks) {
+        kept.insert(c.offset, readRange(c.offset, c.size));
+        for (const QByteArray &hash : c.blobs)
+            keepBlobs.insert(hash);
+    }
+    for (const QByteArray &hash : keepBlobs) {
+        auto it = m_blobs.constFind(hash);
+        if (it != m_blobs.constEnd())
+            kept.insert(it->offset, readRange(it->offset, it->size));
+    }
+
+    QWriteLocker lock(&m_fileLock);
+    m_kept = std::move(kept);
+    close();
+}
+
+bool ProjectArchive::isArchive(const QByteArray &head)
+{
+    return head.startsWith("AVG3");
+}
+
+bool ProjectArchive::open(const QString &filePath)
+{
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_lastError = "Failed to open file for reading: " + filePath;
+        return false;
+    }
+    // A reader that failed to open does not hold on to the file
+    auto fail = [this](const QString &error) {
+        m_lastError = error;
+        close();
+        return false;
+    };
+
+    m_size = m_file.size();
+    if (m_size < HeaderSize)
+        return fail("Truncated project file");
+
+    // Mapping is best-effort: some filesystems refuse it, in which case
+    // chunk() falls back to plain reads.
+    m_map = m_file.map(0, m_size);
+
+    QByteArray head = m_file.read(HeaderSize);
+    QDataStream in(head);
+    in.setVersion(QDataStream::Qt_6_0);
+    char magic[4];
+    quint32 version = 0;
+    quint64 indexOffset = 0, indexSize = 0;
+    in.readRawData(magic, 4);
+    in >> version >> indexOffset >> indexSize;
+
+    if (!isArchive(head) || version > FormatVersion)
+        return fail("Unsupported project file version");
+    if (indexOffset < quint64(HeaderSize) || indexOffset + indexSize > quint64(m_size))
+        return fail("Corrupt project index");
+    if (!readIndex(qUncompress(readRange(indexOffset, indexSize)), version))
+        return fail("Corrupt project index");
+
+    m_snapshotSize = qint64(indexOffset + indexSize);
+    m_validSize = m_snapshotSize;
+    if (version >= 3) replayJournal();
+    return true;
+}
+
+bool ProjectArchive::readIndex(const QByteArray &index, quint32 version)
+{
+    if (index.isEmpty()) return false;
+
+    QDataStream in(index);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    QByteArray headerJson;
+    quint32 count = 0;
+    in >> headerJson >> count;
+
+    QJsonDocument doc = QJsonDocument::fromJson(headerJson);
+    if (!doc.isObject()) return false;
+    m_header = doc.object();
+
+    m_chunks.clear();
+    m_chunks.reserve(int(count));
+    for (quint32 i = 0; i < count; ++i) {
+        ArchiveChunk c;
+        in >> c.layer >> c.frame >> c.offset >> c.size;
+        if (version >= 2) in >> c.blobs;
+        if (in.status() != QDataStream::Ok) return false;
+        if (c.offset < quint64(HeaderSize) || c.offset + c.size > quint64(m_size)) {
+            qWarning() << "Skipping out-of-range chunk for layer" << c.layer << "frame" << c.frame;
+            continue;
+        }
+        m_chunks.append(c);
+    }
+
+    m_blobs.clear();
+    if (version >= 2) {
+        quint32 blobCount = 0;
+        in >> blobCount;
+        for (quint32 i = 0; i < blobCount; ++i) {
+            QByteArray hash;
+            ArchiveBlob b;
+            in >> hash >> b.offset >> b.size;
+            if (in.status() != QDataStream::Ok) return false;
+            if (b.offset < quint64(HeaderSize) || b.offset + b.size > quint64(m_size)) {
+                qWarning() << "Skipping out-of-range image blob" << hash;
+                continue;
+            }
+            m_blobs.insert(hash, b);
+        }
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+// ============= JOURNAL =============
+
+void ProjectArchive::replayJournal()
+{
+    quint64 pos = quint64(m_snapshotSize);
+    while (pos + JournalHeaderSize <= quint64(m_size)) {
+        QByteArray head = readRange(pos, JournalHeaderSize);
+        QDataStream in(head);
+        in.setVersion(QDataStream::Qt_6_0);
+        char magic[4];
+        quint64 payloadSize = 0, metaSize = 0;
+        in.readRawData(magic, 4);
+        in >> payloadSize >> metaSize;
+        QByteArray digest(20, Qt::Uninitialized);
+        in.readRawData(digest.data(), 20);
+
+        const quint64 payloadOffset = pos + JournalHeaderSize;
+        if (!head.startsWith("AVGJ") || metaSize > payloadSize ||
+            payloadSize > quint64(m_size) - payloadOffset)
+            break;
+
+        QByteArray payload = readRange(payloadOffset, payloadSize);
+        if (QCryptographicHash::hash(payload, QCryptographicHash::Sha1) != digest)
+            break;
+        if (!applyJournalRecord(payloadOffset, payload, metaSize))
+            break;
+
+        pos = payloadOffset + payloadSize;
+        m_validSize = qint64(pos);
+    }
+
+    if (m_validSize < m_size)
+        qWarning() << "Ignoring incomplete journal record at offset" << m_validSize;
+}
+
+bool ProjectArchive::applyJournalRecord(quint64 payloadOffset, const QByteArray &payload,
+                                        quint64 metaSize)
+{
+    const quint64 dataSize = quint64(payload.size()) - metaSize;
+    QDataStream in(payload.sliced(qsizetype(dataSize)));
+    in.setVersion(QDataStream::Qt_6_0);
+
+    // Parse the whole record before touching any table
+    QByteArray headerZ;
+    quint32 blobCount = 0;
+    in >> headerZ >> blobCount;
+    QList<QPair<QByteArray, ArchiveBlob>> blobs;
+    for (quint32 i = 0; i < blobCount && in.status() == QDataStream::Ok; ++i) {
+        QByteArray hash;
+        ArchiveBlob b;
+        in >> hash >> b.offset >> b.size;
+        if (b.offset + b.size > dataSize) return false;
+        b.offset += payloadOffset;
+        blobs.append({ hash, b });
+    }
+
+    quint32 chunkCount = 0;
+    in >> chunkCount;
+    QList<ArchiveChunk> chunks;
+    for (quint32 i = 0; i < chunkCount && in.status() == QDataStream::Ok; ++i) {
+        ArchiveChunk c;
+        in >> c.layer >> c.frame >> c.offset >> c.size >> c.blobs;
+        if (c.offset + c.size > dataSize) return false;
+        c.offset += payloadOffset;
+        chunks.append(c);
+    }
+    if (in.status() != QDataStream::Ok) return false;
+
+    QJsonDocument doc = QJsonDocument::fromJson(qUncompress(headerZ));
+    if (!doc.isObject()) return false;
+
+    // Apply: header replaced, frames replaced/removed, blobs added
+    m_header = doc.object();
+    for (const auto &b : blobs)
+        m_blobs.insert(b.first, b.second);
+
+    QHash<quint64, int> slot;
+    for (int i = 0; i < m_chunks.size(); ++i)
+        slot.insert(chunkKey(m_chunks[i].layer, m_chunks[i].frame), i);
+    for (const ArchiveChunk &c : chunks) {
+        auto it = slot.constFind(chunkKey(c.layer, c.frame));
+        if (it != slot.constEnd()) {
+            m_chunks[*it] = c;
+        } else if (c.size > 0) {
+            slot.insert(chunkKey(c.layer, c.frame), m_chunks.size());
+            m_chunks.append(c);
+        }
+    }
+    // Size 0 marks a frame removed since the snapshot
+    m_chunks.erase(std::remove_if(m_chunks.begin(), m_chunks.end(),
+                                  [](const ArchiveChunk &c) { return c.size == 0; }),
+                   m_chunks.end());
+    return true;
+}
+
+bool ProjectArchive::appendJournal(const QJsonObject &header, const QList<PendingChunk> &chunks,
+                                   const QHash<QByteArray, QByteArray> &blobs,
+                                   QString *error) const
+{
+    // Payload: blob bytes, chunk bytes, then the metadata block describing
+    // them with offsets relative to the start of the payload
+    QByteArray payload;
+    QByteArray meta;
+    {
+        QDataStream out(&meta, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << qCompress(QJsonDocument(header).toJson(QJsonDocument::Compact), 7);
+        out << quint32(blobs.size());
+        for (auto it = blobs.constBegin(); it != blobs.constEnd(); ++it) {
+            out << it.key() << quint64(payload.size()) << quint64(it.value().size());
+            payload += it.value();
+        }
+        out << quint32(chunks.size());
+        for (const PendingChunk &c : chunks) {
+            out << c.layer << c.frame << quint64(payload.size()) << quint64(c.data.size()) << c.blobs;
+            payload += c.data;
+        }
+    }
+    payload += meta;
+
+    QByteArray head;
+    {
+        QDataStream out(&head, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out.writeRawData("AVGJ", 4);
+        out << quint64(payload.size()) << quint64(meta.size());
+        const QByteArray digest = QCryptographicHash::hash(payload, QCryptographicHash::Sha1);
+        out.writeRawData(digest.constData(), digest.size());
+    }
+
+    QFile file(m_file.fileName());
+    if (!file.open(QIODevice::ReadWrite)) {
+        if (error) *error = "Failed to open file for writing: " + m_file.fileName();
+        return false;
+    }
+    // Drop a torn record left behind by an earlier crash before appending
+    if (file.size() != m_validSize && !file.resize(m_validSize)) {
+        if (error) *error = "Failed to truncate journal: " + file.errorString();
+        return false;
+    }
+    if (!file.seek(m_validSize) || file.write(head) != head.size() ||
+        file.write(payload) != payload.size() || !syncToDisk(file)) {
+        if (error) *error = "Failed to append journal record: " + file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool ProjectArchive::compact(const QString &filePath, QString *error)
+{
+    QJsonObject header;
+    QList<PendingChunk> chunks;
+    QHash<QByteArray, QByteArray> blobs;
+    {
+        ProjectArchive source;
+        if (!source.open(filePath)) {
+            if (error) *error = source.lastError();
+            return false;
+        }
+        if (source.journalSize() == 0 && source.validSize() == source.m_size)
+            return true;
+
+        header = source.header();
+        for (const ArchiveChunk &c : source.chunks()) {
+            PendingChunk pending;
+            pending.layer = c.layer;
+            pending.frame = c.frame;
+            pending.data  = source.chunk(c);
+            pending.blobs = c.blobs;
+            for (const QByteArray &hash : c.blobs) {
+                if (!blobs.contains(hash) && source.hasBlob(hash))
+                    blobs.insert(hash, source.blob(hash));
+            }
+            chunks.append(pending);
+        }
+    }   // the source is closed before its file is replaced
+    return write(filePath, header, chunks, blobs, error);
+}
+
+void ProjectArchive::inheritCaches(const ProjectArchive &other)
+{
+    QMutexLocker otherLock(&other.m_cacheMutex);
+    QMutexLocker lock(&m_cacheMutex);
+    for (auto it = other.m_images.constBegin(); it != other.m_images.constEnd(); ++it) {
+        if (hasBlob(it.key())) m_images.insert(it.key(), it.value());
+    }
+    for (auto it = other.m_pixmaps.constBegin(); it != other.m_pixmaps.constEnd(); ++it) {
+        if (hasBlob(it.key())) m_pixmaps.insert(it.key(), it.value());
+    }
+    for (auto it = other.m_hashByCacheKey.constBegin(); it != other.m_hashByCacheKey.constEnd(); ++it) {
+        if (hasBlob(it.value())) m_hashByCacheKey.insert(it.key(), it.value());
+    }
+}
+
+QByteArray ProjectArchive::readRange(quint64 offset, quint64 size) const
+{
+    if (offset + size > quint64(m_size)) return QByteArray();
+
+    QReadLocker fileLock(&m_fileLock);
+    if (m_map) {
+        return QByteArray(reinterpret_cast<const char*>(m_map + offset), qsizetype(size));
+    }
+    if (!m_file.isOpen()) {
+        // Detached: only what detach() kept is still there
+        auto it = m_kept.constFind(offset);
+        if (it == m_kept.constEnd() || it->size() != qsizetype(size)) return QByteArray();
+        return *it;
+    }
+
+    QMutexLocker lock(&m_readMutex);
+    QFile &file = const_cast<QFile&>(m_file);
+    if (!file.seek(qint64(offset))) return QByteArray();
+    return file.read(qint64(size));
+}
+
+QByteArray ProjectArchive::chunk(const ArchiveChunk &chunk) const
+{
+    return readRange(chunk.offset, chunk.size);
+}
+
+// ============= IMAGE BLOBS =============
+
+QByteArray ProjectArchive::blob(const QByteArray &hash) const
+{
+    auto it = m_blobs.constFind(hash);
+    if (it == m_blobs.constEnd()) return QByteArray();
+    return readRange(it->offset, it->size);
+}
+
+QImage ProjectArchive::image(const QByteArray &hash) const
+{
+    {
+        QMutexLocker lock(&m_cacheMutex);
+        auto cached = m_images.constFind(hash);
+        if (cached != m_images.constEnd()) return *cached;
+    }
+
+    // Decode outside the lock so different blobs decode concurrently
+    QImage decoded;
+    if (!decoded.loadFromData(blob(hash))) {
+        qWarning() << "Failed to decode image blob" << hash;
+        return QImage();
+    }
+
+    QMutexLocker lock(&m_cacheMutex);
+    // Another thread may have won the race; keep its copy so all users share it
+    auto cached = m_images.constFind(hash);
+    if (cached != m_images.constEnd()) return *cached;
+    m_images.insert(hash, decoded);
+    m_hashByCacheKey.insert(decoded.cacheKey(), hash);
+    return decoded;
+}
+
+QPixmap ProjectArchive::pixmap(const QByteArray &hash) const
+{
+    {
+        QMutexLocker lock(&m_cacheMutex);
+        auto cached = m_pixmaps.constFind(hash);
+        if (cached != m_pixmaps.constEnd()) return *cached;
+    }
+
+    QImage decoded = image(hash);
+    if (decoded.isNull()) return QPixmap();
+    QPixmap pm = QPixmap::fromImage(decoded);
+
+    QMutexLocker lock(&m_cacheMutex);
+    m_pixmaps.insert(hash, pm);
+    m_hashByCacheKey.insert(pm.cacheKey(), hash);
+    return pm;
+}
+
+QByteArray ProjectArchive::hashForCacheKey(qint64 cacheKey) const
+{
+    QMutexLocker lock(&m_cacheMutex);
+    return m_hashByCacheKey.value(cacheKey);
+}
+
+// ============= WRITING =============
+
+bool ProjectArchive::write(const QString &filePath, const QJsonObject &header,
+                           const QList<PendingChunk> &chunks,
+                           const QHash<QByteArray, QByteArray> &blobs,
+                           QString *error)
+{
+    // All offsets are known up front, so the index can be built before
+    // anything is written and the file is produced in a single pass.
+    const QList<QByteArray> blobHashes = blobs.keys();
+
+    quint64 offset = HeaderSize;
+    QList<quint64> blobOffsets;
+    for (const QByteArray &hash : blobHashes) {
+        blobOffsets.append(offset);
+        offset += quint64(blobs.value(hash).size());
+    }
+
+    QByteArray index;
+    {
+        QDataStream out(&index, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << QJsonDocument(header).toJson(QJsonDocument::Compact);
+        out << quint32(chunks.size());
+        for (const PendingChunk &c : chunks) {
+            out << c.layer << c.frame << offset << quint64(c.data.size()) << c.blobs;
+            offset += quint64(c.data.size());
+        }
+        out << quint32(blobHashes.size());
+        for (int i = 0; i < blobHashes.size(); ++i)
+            out << blobHashes[i] << blobOffsets[i] << quint64(blobs.value(blobHashes[i]).size());
+    }
+    index = qCompress(index, 7);
+    const quint64 indexOffset = offset;
+
+    QByteArray head;
+    {
+        QDataStream out(&head, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out.writeRawData("AVG3", 4);
+        out << FormatVersion << indexOffset << quint64(index.size());
+    }
+
+    // QSaveFile writes to a temporary and renames on commit, so a failed or
+    // interrupted save never leaves a half-written project behind.
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) *error = "Failed to open file for writing: " + filePath;
+        return false;
+    }
+    file.write(head);
+    for (const QByteArray &hash : blobHashes)
+        file.write(blobs.value(hash));
+    for (const PendingChunk &c : chunks)
+        file.write(c.data);
+    file.write(index);
+
+    if (!file.commit()) {
+        if (error) *error = "Failed to write project file: " + file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,200 @@
+#ifndef PROJECTARCHIVE_H
+#define PROJECTARCHIVE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QPixmap>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+
+/**
+ * @brief Location of one compressed frame chunk inside an AVG3 file
+ */
+struct ArchiveChunk {
+    quint32 layer  = 0;   // index into the header's "layers" array
+    qint32  frame  = 0;   // keyframe number
+    quint64 offset = 0;   // absolute byte offset in the file
+    quint64 size   = 0;   // compressed size in bytes
+    QList<QByteArray> blobs;  // image blobs referenced by the frame (hex hashes)
+};
+
+/**
+ * @brief Location of one encoded image inside an AVG3 file
+ */
+struct ArchiveBlob {
+    quint64 offset = 0;
+    quint64 size   = 0;
+};
+
+/**
+ * @brief Reader/writer for the chunked AVG3 project container
+ *
+ * Layout:
+ *   [0, 24)      "AVG3", quint32 version, quint64 indexOffset, quint64 indexSize
+ *   [24, ...)    image blobs, each stored once and keyed by content hash
+ *   [..., index) frame chunks, one per keyframe (ObjectSerializer::encodeFrame)
+ *   [index, ...) qCompress'd index: header JSON, chunk table, blob table
+ *   [..., end)   journal records appended by incremental saves, each
+ *                "AVGJ", quint64 payloadSize, quint64 metaSize, SHA-1,
+ *                then new blobs + changed frame chunks + a metadata block
+ *
+ * Journal records are replayed on open() over the snapshot's tables. A
+ * record whose length or checksum does not match (a crash mid-append) ends
+ * the replay, so the last good state is always recoverable.
+ *
+ * Opening a project only reads the index; the file stays memory-mapped
+ * and Layer pulls individual frame chunks out of it on first access.
+ * The index is immutable after open() and the reader is safe to share
+ * between layers. Decoded blobs are cached so every object referencing
+ * the same image shares one QImage/QPixmap.
+ *
+ * Before the file is replaced (a snapshot save to the same path,
+ * compaction) detach() moves the reader off it, keeping only the chunks
+ * and blobs that are still needed: Windows refuses to rename over a file
+ * that is open or mapped.
+ */
+class ProjectArchive
+{
+public:
+    // A chunk about to be written (data is already compressed)
+    struct PendingChunk {
+        quint32    layer = 0;
+        qint32     frame = 0;
+        QByteArray data;
+        QList<QByteArray> blobs;
+    };
+
+    ProjectArchive();
+    ~ProjectArchive();
+
+    /**
+     * @brief True if the first bytes of a file carry the AVG3 magic
+     */
+    static bool isArchive(const QByteArray &head);
+
+    /**
+     * @brief Map the file and read its index
+     * @return false on I/O error or a malformed index (see lastError())
+     */
+    bool open(const QString &filePath);
+
+    QString filePath() const { return m_file.fileName(); }
+
+    /**
+     * @brief Keep the bytes still needed in memory and close the file
+     * @param chunks Chunks that will still be read (frames not decoded yet)
+     * @param blobs Further blobs to keep; those of @p chunks are kept anyway
+     *
+     * The file can then be replaced while those chunks and blobs are still
+     * read from this reader. Anything else reads as empty from here on.
+     */
+    void detach(const QList<ArchiveChunk> &chunks, const QSet<QByteArray> &blobs = {});
+
+    QString lastError() const { return m_lastError; }
+
+    // Project + layer metadata (everything except frame contents)
+    QJsonObject header() const { return m_header; }
+    const QList<ArchiveChunk>& chunks() const { return m_chunks; }
+
+    /**
+     * @brief Copy of a chunk's compressed bytes (empty if out of range)
+     */
+    QByteArray chunk(const ArchiveChunk &chunk) const;
+
+    // ── Image blobs ───────────────────────────────────────────────────────────
+    bool hasBlob(const QByteArray &hash) const { return m_blobs.contains(hash); }
+    const QHash<QByteArray, ArchiveBlob>& blobTable() const { return m_blobs; }
+    // Encoded (WebP/PNG) bytes of a blob
+    QByteArray blob(const QByteArray &hash) const;
+    // Decoded blob, shared by all callers (thread-safe)
+    QImage image(const QByteArray &hash) const;
+    // Pixmap of a blob, shared by all callers (GUI thread only)
+    QPixmap pixmap(const QByteArray &hash) const;
+    // Hash of a blob handed out by image()/pixmap(), looked up by cacheKey();
+    // lets a re-save reuse the stored bytes instead of re-encoding
+    QByteArray hashForCacheKey(qint64 cacheKey) const;
+
+    // ── Journal ───────────────────────────────────────────────────────────────
+    // Bytes up to the end of the last intact record; anything past this is
+    // a torn record and is cut off by the next append
+    qint64 validSize() const { return m_validSize; }
+    qint64 snapshotSize() const { return m_snapshotSize; }
+    qint64 journalSize() const { return m_validSize - m_snapshotSize; }
+    // True once the journal is big enough (8 MB, or half the snapshot) that
+    // folding it into a new snapshot with compact() pays off
+    bool journalNeedsCompaction() const {
+        return journalSize() > qMax<qint64>(CompactJournalBytes, m_snapshotSize / 2);
+    }
+
+    /**
+     * @brief Append one journal record to this archive's file
+     * @param header Current project/layer metadata (replaces the stored one)
+     * @param chunks Changed frames; empty data marks a frame that was removed
+     * @param blobs Image blobs the file does not contain yet
+     *
+     * The reader itself is not updated; open the file again to see the record.
+     */
+    bool appendJournal(const QJsonObject &header, const QList<PendingChunk> &chunks,
+                       const QHash<QByteArray, QByteArray> &blobs,
+                       QString *error = nullptr) const;
+
+    /**
+     * @brief Fold a file's journal into a fresh snapshot
+     *
+     * Works purely on the file's bytes, so it is safe to run on a worker
+     * thread as long as nothing appends to the file meanwhile. Blobs no
+     * longer referenced by any frame are dropped.
+     */
+    static bool compact(const QString &filePath, QString *error = nullptr);
+
+    // Take over decoded blobs from an older reader of the same project
+    void inheritCaches(const ProjectArchive &other);
+
+    /**
+     * @brief Write a complete archive atomically (via QSaveFile)
+     * @param blobs Encoded image blobs keyed by content hash
+     */
+    static bool write(const QString &filePath, const QJsonObject &header,
+                      const QList<PendingChunk> &chunks,
+                      const QHash<QByteArray, QByteArray> &blobs,
+                      QString *error = nullptr);
+
+private:
+    static constexpr int HeaderSize = 24;
+    static constexpr int JournalHeaderSize = 40;
+    static constexpr quint32 FormatVersion = 3;   // 2: image blob table, 3: journal
+    static constexpr qint64 CompactJournalBytes = 8 * 1024 * 1024;
+
+    bool readIndex(const QByteArray &index, quint32 version);
+    void replayJournal();
+    bool applyJournalRecord(quint64 payloadOffset, const QByteArray &payload, quint64 metaSize);
+    QByteArray readRange(quint64 offset, quint64 size) const;
+    void close();
+
+    QFile m_file;
+    uchar *m_map = nullptr;     // null if mapping failed; falls back to read()
+    QHash<quint64, QByteArray> m_kept;   // offset -> bytes kept by detach()
+    mutable QReadWriteLock m_fileLock;   // detach() against readers
+    qint64 m_size = 0;
+    qint64 m_snapshotSize = 0;
+    qint64 m_validSize = 0;
+    mutable QMutex m_readMutex; // serializes seek+read on the fallback path
+    QJsonObject m_header;
+    QList<ArchiveChunk> m_chunks;
+    QHash<QByteArray, ArchiveBlob> m_blobs;
+    QString m_lastError;
+
+    // Decoded blob caches
+    mutable QMutex m_cacheMutex;
+    mutable QHash<QByteArray, QImage>  m_images;
+    mutable QHash<QByteArray, QPixmap> m_pixmaps;
+    mutable QHash<qint64, QByteArray>  m_hashByCacheKey;
+};
+
+#endif // PROJECTARCHIVE_H
@@ -0,0 +1,471 @@
+#include "projectinspector.h"
+#include "projectarchive.h"
+#include "objectserializer.h"
+#include "canvas/objects/vectorobject.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocale>
+#include <QMap>
+#include <QTextStream>
+#include <cstring>
+
+// Rough cost of one loaded canvas item (QGraphicsItem, its private data
+// and our own members) on top of its geometry or pixels
+static constexpr qint64 ItemOverheadBytes = 512;
+
+static double msSince(const QElapsedTimer &timer)
+{
+    return timer.nsecsElapsed() / 1e6;
+}
+
+bool ProjectInspector::isRequested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--inspect") == 0 || std::strncmp(argv[i], "--inspect=", 10) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Statistics for one keyframe's objects. Images stored as blobs are only
+// counted in imageRefs; their pixels are costed once per blob by the caller.
+static QJsonObject frameStats(int frame, const QJsonArray &objects,
+                              QHash<QByteArray, int> *imageRefs)
+{
+    int paths = 0, shapes = 0, texts = 0, images = 0, groups = 0;
+    qint64 storedElements = 0, loadedElements = 0;
+    qint64 memory = 0;
+
+    // Same pure-computation step a load runs on its worker threads
+    QElapsedTimer timer;
+    timer.start();
+    for (const QJsonValue &value : objects) {
+        const QJsonObject json = value.toObject();
+        const ObjectSerializer::ObjectData data = ObjectSerializer::parse(json);
+        memory += ItemOverheadBytes;
+        switch (static_cast<VectorObjectType>(json["type"].toInt())) {
+        case VectorObjectType::Path:
+            ++paths;
+            storedElements += json["pathElements"].toArray().size();
+            loadedElements += data.path.elementCount();
+            memory += data.path.elementCount() * qint64(sizeof(QPainterPath::Element));
+            break;
+        case VectorObjectType::Rectangle:
+        case VectorObjectType::Ellipse:
+            ++shapes;
+            break;
+        case VectorObjectType::Text:
+            ++texts;
+            memory += json["text"].toString().size() * qint64(sizeof(QChar));
+            break;
+        case VectorObjectType::Image:
+            ++images;
+            if (json.contains("imageBlob"))
+                ++(*imageRefs)[json["imageBlob"].toString().toLatin1()];
+            else
+                memory += data.image.sizeInBytes();   // embedded inline, one copy per object
+            break;
+        case VectorObjectType::Group:
+            ++groups;
+            break;
+        }
+    }
+
+    QJsonObject stats;
+    stats["frame"]              = frame;
+    stats["objects"]            = objects.size();
+    stats["paths"]              = paths;
+    stats["shapes"]             = shapes;
+    stats["texts"]              = texts;
+    stats["images"]             = images;
+    stats["groups"]             = groups;
+    stats["pathElements"]       = storedElements;
+    stats["pathElementsLoaded"] = loadedElements;
+    stats["memoryBytes"]        = memory;
+    stats["parseMs"]            = msSince(timer);
+    return stats;
+}
+
+// Layer metadata plus its frames, with per-layer totals
+static QJsonObject layerStats(int index, const QJsonObject &layerObj, const QJsonArray &frames)
+{
+    QJsonObject layer;
+    layer["index"]   = index;
+    layer["name"]    = layerObj["name"].toString("Layer");
+    layer["type"]    = layerObj["type"].toString("Art");
+    layer["visible"] = layerObj["visible"].toBool(true);
+
+    QJsonArray holds;
+    for (const QJsonValue &ext : layerObj["frameExtensions"].toArray()) {
+        const QJsonObject extObj = ext.toObject();
+        holds.append(QJsonArray{ extObj["keyFrame"].toInt(), extObj["extendToFrame"].toInt() });
+    }
+    layer["holds"] = holds;
+
+    QJsonArray tweens;
+    for (const QJsonValue &range : layerObj["interpRanges"].toArray()) {
+        const QJsonObject rangeObj = range.toObject();
+        QJsonObject tween;
+        tween["start"]  = rangeObj["startFrame"].toInt();
+        tween["end"]    = rangeObj["endFrame"].toInt();
+        tween["easing"] = rangeObj["easing"].toString("linear");
+        tweens.append(tween);
+    }
+    layer["tweens"] = tweens;
+
+    qint64 objects = 0, paths = 0, images = 0, elements = 0, memory = 0, chunkBytes = 0;
+    for (const QJsonValue &value : frames) {
+        const QJsonObject frame = value.toObject();
+        objects    += frame["objects"].toInteger();
+        paths      += frame["paths"].toInteger();
+        images     += frame["images"].toInteger();
+        elements   += frame["pathElements"].toInteger();
+        memory     += frame["memoryBytes"].toInteger();
+        chunkBytes += frame["chunkBytes"].toInteger();
+    }
+    layer["keyFrames"]    = frames.size();
+    layer["objects"]      = objects;
+    layer["paths"]        = paths;
+    layer["images"]       = images;
+    layer["pathElements"] = elements;
+    layer["memoryBytes"]  = memory;
+    layer["chunkBytes"]   = chunkBytes;
+    layer["frames"]       = frames;
+    return layer;
+}
+
+// Project fields and totals shared by both formats
+static void finishReport(QJsonObject &report, const QJsonObject &header,
+                         const QJsonArray &layers, const QJsonArray &images)
+{
+    report["name"]        = header["name"].toString();
+    report["width"]       = header["width"].toInt();
+    report["height"]      = header["height"].toInt();
+    report["fps"]         = header["fps"].toInt();
+    report["totalFrames"] = header["totalFrames"].toInt();
+    report["layers"]      = layers;
+    report["images"]      = images;
+
+    qint64 keyFrames = 0, objects = 0, paths = 0, elements = 0, memory = 0;
+    double inflateMs = 0, jsonMs = 0, parseMs = 0, imageMs = 0;
+    for (const QJsonValue &value : layers) {
+        const QJsonObject layer = value.toObject();
+        keyFrames += layer["keyFrames"].toInteger();
+        objects   += layer["objects"].toInteger();
+        paths     += layer["paths"].toInteger();
+        elements  += layer["pathElements"].toInteger();
+        memory    += layer["memoryBytes"].toInteger();
+        for (const QJsonValue &frame : layer["frames"].toArray()) {
+            inflateMs += frame["inflateMs"].toDouble();
+            jsonMs    += frame["jsonMs"].toDouble();
+            parseMs   += frame["parseMs"].toDouble();
+        }
+    }
+    for (const QJsonValue &value : images) {
+        memory  += value["memoryBytes"].toInteger();
+        imageMs += value["decodeMs"].toDouble();
+    }
+    // Legacy files are inflated and parsed as a whole
+    inflateMs += report["inflateMs"].toDouble();
+    jsonMs    += report["jsonMs"].toDouble();
+
+    QJsonObject totals;
+    totals["keyFrames"]     = keyFrames;
+    totals["objects"]       = objects;
+    totals["paths"]         = paths;
+    totals["pathElements"]  = elements;
+    totals["imageBlobs"]    = images.size();
+    totals["memoryBytes"]   = memory;
+    totals["inflateMs"]     = inflateMs;
+    totals["jsonMs"]        = jsonMs;
+    totals["parseMs"]       = parseMs;
+    totals["imageDecodeMs"] = imageMs;
+    report["totals"] = totals;
+}
+
+bool ProjectInspector::inspect(const QString &filePath)
+{
+    m_report = QJsonObject();
+    m_lastError.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_lastError = "Failed to open file for reading: " + filePath;
+        return false;
+    }
+    const bool archive = ProjectArchive::isArchive(file.peek(4));
+    file.close();
+
+    m_report["file"]      = QFileInfo(filePath).absoluteFilePath();
+    m_report["fileBytes"] = QFileInfo(filePath).size();
+    return archive ? inspectArchive(filePath) : inspectLegacy(filePath);
+}
+
+bool ProjectInspector::inspectArchive(const QString &filePath)
+{
+    ProjectArchive archive;
+    if (!archive.open(filePath)) {
+        m_lastError = archive.lastError();
+        return false;
+    }
+    m_report["format"]        = "AVG3";
+    m_report["snapshotBytes"] = archive.snapshotSize();
+    m_report["journalBytes"]  = archive.journalSize();
+
+    const QJsonObject header = archive.header();
+    const QJsonArray layersArray = header["layers"].toArray();
+
+    // Chunks are visited one at a time; only the current one is inflated
+    QMap<quint32, QMap<int, QJsonObject>> framesByLayer;
+    QHash<QByteArray, int> imageRefs;
+    for (const ArchiveChunk &chunk : archive.chunks()) {
+        QElapsedTimer timer;
+        timer.start();
+        const QByteArray compressed = archive.chunk(chunk);
+        const QByteArray raw = qUncompress(compressed);
+        const double inflateMs = msSince(timer);
+
+        timer.restart();
+        const QJsonDocument doc = QJsonDocument::fromJson(raw);
+        const double jsonMs = msSince(timer);
+
+        QJsonObject frame = frameStats(chunk.frame, doc.object()["objects"].toArray(), &imageRefs);
+        frame["chunkBytes"] = qint64(chunk.size);
+        frame["rawBytes"]   = raw.size();
+        frame["inflateMs"]  = inflateMs;
+        frame["jsonMs"]     = jsonMs;
+        if (raw.isEmpty() || !doc.isObject())
+            frame["error"] = "corrupt chunk";
+        framesByLayer[chunk.layer].insert(chunk.frame, frame);
+    }
+
+    QJsonArray layers;
+    for (int i = 0; i < layersArray.size(); ++i) {
+        QJsonArray frames;
+        for (const QJsonObject &frame : framesByLayer.value(quint32(i)))
+            frames.append(frame);
+        layers.append(layerStats(i, layersArray[i].toObject(), frames));
+    }
+
+    // Every blob is decoded once, as a load would, then dropped again.
+    // Blobs no frame refers to any more are listed with 0 references;
+    // the next compaction removes them.
+    QJsonArray images;
+    const QHash<QByteArray, ArchiveBlob> &blobs = archive.blobTable();
+    for (auto it = blobs.constBegin(); it != blobs.constEnd(); ++it) {
+        QByteArray encoded = archive.blob(it.key());
+        QBuffer buffer(&encoded);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader reader(&buffer);
+        const QByteArray format = reader.format();
+
+        QElapsedTimer timer;
+        timer.start();
+        const QImage decoded = reader.read();
+        const double decodeMs = msSince(timer);
+
+        QJsonObject image;
+        image["hash"]         = QString::fromLatin1(it.key());
+        image["format"]       = QString::fromLatin1(format);
+        image["width"]        = decoded.width();
+        image["height"]       = decoded.height();
+        image["encodedBytes"] = qint64(it->size);
+        image["memoryBytes"]  = decoded.sizeInBytes();
+        image["references"]   = imageRefs.value(it.key());
+        image["decodeMs"]     = decodeMs;
+        images.append(image);
+    }
+
+    finishReport(m_report, header, layers, images);
+    return true;
+}
+
+bool ProjectInspector::inspectLegacy(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_lastError = "Failed to open file for reading: " + filePath;
+        return false;
+    }
+    const QByteArray raw = file.readAll();
+    file.close();
+
+    // One document holding every frame: nothing to stream, so the file
+    // level inflate/parse times are reported instead of per-frame ones
+    QElapsedTimer timer;
+    timer.start();
+    const bool compressed = raw.startsWith("AVG2");
+    const QByteArray data = compressed ? qUncompress(raw.mid(4)) : raw;
+    m_report["format"]    = compressed ? "AVG2" : "JSON";
+    m_report["inflateMs"] = compressed ? msSince(timer) : 0.0;
+    if (data.isEmpty()) {
+        m_lastError = "Failed to decompress project file: " + filePath;
+        return false;
+    }
+
+    timer.restart();
+    const QJsonDocument doc = QJsonDocument::fromJson(data);
+    m_report["jsonMs"] = msSince(timer);
+    if (doc.isNull() || !doc.isObject()) {
+        m_lastError = "Invalid project file format";
+        return false;
+    }
+
+    const QJsonObject header = doc.object();
+    const QJsonArray layersArray = header["layers"].toArray();
+    QHash<QByteArray, int> imageRefs;
+    QJsonArray layers;
+    for (int i = 0; i < layersArray.size(); ++i) {
+        const QJsonObject layerObj = layersArray[i].toObject();
+        QMap<int, QJsonObject> byFrame;
+        for (const QJsonValue &frameVal : layerObj["frames"].toArray()) {
+            const QJsonObject frameObj = frameVal.toObject();
+            const int number = frameObj["number"].toInt(1);
+            byFrame.insert(number, frameStats(number, frameObj["objects"].toArray(), &imageRefs));
+        }
+        QJsonArray frames;
+        for (const QJsonObject &frame : byFrame)
+            frames.append(frame);
+        layers.append(layerStats(i, layerObj, frames));
+    }
+
+    finishReport(m_report, header, layers, QJsonArray());
+    return true;
+}
+
+// ── Text report ───────────────────────────────────────────────────────────────
+
+static QString bytes(qint64 size)
+{
+    return QLocale().formattedDataSize(size);
+}
+
+static QString ms(double value)
+{
+    return QString::number(value, 'f', value < 10 ? 2 : 1) + " ms";
+}
+
+static QString ranges(const QJsonArray &array)
+{
+    QStringList parts;
+    for (const QJsonValue &value : array) {
+        if (value.isArray())
+            parts << QString("%1-%2").arg(value[0].toInt()).arg(value[1].toInt());
+        else
+            parts << QString("%1-%2 (%3)").arg(value["start"].toInt())
+                         .arg(value["end"].toInt()).arg(value["easing"].toString());
+    }
+    return parts.isEmpty() ? QString("none") : parts.join(", ");
+}
+
+QString ProjectInspector::toText() const
+{
+    QString text;
+    QTextStream out(&text);
+    const QJsonObject &r = m_report;
+    const QJsonObject totals = r["totals"].toObject();
+
+    out << r["file"].toString() << "\n";
+    out << QString("  %1, %2 × %3 @ %4 fps, %5 frames, %6")
+               .arg(r["format"].toString()).arg(r["width"].toInt()).arg(r["height"].toInt())
+               .arg(r["fps"].toInt()).arg(r["totalFrames"].toInt())
+               .arg(bytes(r["fileBytes"].toInteger())) << "\n";
+    if (r.contains("journalBytes"))
+        out << QString("  snapshot %1, journal %2")
+                   .arg(bytes(r["snapshotBytes"].toInteger()))
+                   .arg(bytes(r["journalBytes"].toInteger())) << "\n";
+    out << QString("  %1 keyframes, %2 objects, %3 paths, %4 path elements, %5 image blobs")
+               .arg(totals["keyFrames"].toInteger()).arg(totals["objects"].toInteger())
+               .arg(totals["paths"].toInteger()).arg(totals["pathElements"].toInteger())
+               .arg(totals["imageBlobs"].toInteger()) << "\n";
+    out << QString("  ~%1 in memory when fully loaded").arg(bytes(totals["memoryBytes"].toInteger())) << "\n";
+    out << QString("  inflate %1, JSON %2, object parse %3, image decode %4")
+               .arg(ms(totals["inflateMs"].toDouble()), ms(totals["jsonMs"].toDouble()),
+                    ms(totals["parseMs"].toDouble()), ms(totals["imageDecodeMs"].toDouble()))
+        << "\n";
+
+    for (const QJsonValue &value : r["layers"].toArray()) {
+        const QJsonObject layer = value.toObject();
+        out << "\n" << QString("Layer %1 \"%2\" (%3%4): %5 keyframes, %6 objects, %7 path elements, ~%8")
+                   .arg(layer["index"].toInt()).arg(layer["name"].toString(), layer["type"].toString(),
+                        layer["visible"].toBool() ? QString() : QString(", hidden"))
+                   .arg(layer["keyFrames"].toInteger()).arg(layer["objects"].toInteger())
+                   .arg(layer["pathElements"].toInteger())
+                   .arg(bytes(layer["memoryBytes"].toInteger())) << "\n";
+        out << "  holds:  " << ranges(layer["holds"].toArray()) << "\n";
+        out << "  tweens: " << ranges(layer["tweens"].toArray()) << "\n";
+
+        const QJsonArray frames = layer["frames"].toArray();
+        if (frames.isEmpty()) continue;
+        out << QString("  %1 %2 %3 %4 %5 %6 %7 %8 %9")
+                   .arg("frame", 7).arg("objects", 8).arg("paths", 6).arg("elements", 9)
+                   .arg("images", 7).arg("chunk", 10).arg("inflate", 10).arg("json", 10)
+                   .arg("parse", 10) << "\n";
+        for (const QJsonValue &frameVal : frames) {
+            const QJsonObject frame = frameVal.toObject();
+            out << QString("  %1 %2 %3 %4 %5 %6 %7 %8 %9")
+                       .arg(frame["frame"].toInt(), 7).arg(frame["objects"].toInt(), 8)
+                       .arg(frame["paths"].toInt(), 6).arg(frame["pathElements"].toInteger(), 9)
+                       .arg(frame["images"].toInt(), 7)
+                       .arg(frame.contains("chunkBytes") ? bytes(frame["chunkBytes"].toInteger())
+                                                         : QString("-"), 10)
+                       .arg(frame.contains("inflateMs") ? ms(frame["inflateMs"].toDouble())
+                                                        : QString("-"), 10)
+                       .arg(frame.contains("jsonMs") ? ms(frame["jsonMs"].toDouble())
+                                                     : QString("-"), 10)
+                       .arg(ms(frame["parseMs"].toDouble()), 10);
+            if (frame.contains("error"))
+                out << "  " << frame["error"].toString();
+            out << "\n";
+        }
+    }
+
+    const QJsonArray images = r["images"].toArray();
+    if (!images.isEmpty()) {
+        out << "\nImages:\n";
+        for (const QJsonValue &value : images) {
+            const QJsonObject image = value.toObject();
+            out << QString("  %1  %2 %3 × %4, %5 stored, ~%6 decoded, %7 refs, decode %8")
+                       .arg(image["hash"].toString().left(12), image["format"].toString())
+                       .arg(image["width"].toInt()).arg(image["height"].toInt())
+                       .arg(bytes(image["encodedBytes"].toInteger()))
+                       .arg(bytes(image["memoryBytes"].toInteger()))
+                       .arg(image["references"].toInt())
+                       .arg(ms(image["decodeMs"].toDouble())) << "\n";
+        }
+    }
+    return text;
+}
+
+int ProjectInspector::run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Print statistics about an AkisVG project file.");
+    parser.addHelpOption();
+    const QCommandLineOption inspectOption("inspect", "Project file to inspect.", "project");
+    const QCommandLineOption jsonOption("json", "Print the report as JSON.");
+    parser.addOptions({inspectOption, jsonOption});
+    parser.process(arguments);
+
+    ProjectInspector inspector;
+    if (!inspector.inspect(parser.value(inspectOption))) {
+        QTextStream(stderr) << inspector.lastError() << Qt::endl;
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    if (parser.isSet(jsonOption))
+        out << QJsonDocument(inspector.report()).toJson(QJsonDocument::Indented);
+    else
+        out << inspector.toText();
+    out.flush();
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef PROJECTINSPECTOR_H
+#define PROJECTINSPECTOR_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Statistics about a project file, gathered without loading it
+ *
+ *   AkisVG --inspect shot.avg [--json]
+ *
+ * Reports per-layer and per-keyframe object counts, path element totals,
+ * embedded image sizes, hold and tween ranges, an estimate of what the
+ * loaded project would occupy in memory, and how long each frame takes to
+ * inflate, parse and turn into object data.
+ *
+ * AVG3 files are streamed one chunk at a time straight from the mapped
+ * file and no canvas objects are created, so even a project that is too
+ * big to open can be inspected. Older single-document files have to be
+ * parsed whole.
+ */
+class ProjectInspector
+{
+public:
+    /**
+     * @brief True if the command line asks for --inspect
+     *
+     * Checked in main() before any application object exists; inspection
+     * only needs a QCoreApplication.
+     */
+    static bool isRequested(int argc, char *argv[]);
+
+    /**
+     * @brief Parse the arguments, print the report and return the exit code
+     */
+    static int run(const QStringList &arguments);
+
+    /**
+     * @brief Gather statistics for one file
+     * @return false if the file can not be read (see lastError())
+     */
+    bool inspect(const QString &filePath);
+
+    QString lastError() const { return m_lastError; }
+
+    // The full report; toText() formats the same data for a terminal
+    QJsonObject report() const { return m_report; }
+    QString toText() const;
+
+private:
+    bool inspectArchive(const QString &filePath);
+    bool inspectLegacy(const QString &filePath);
+
+    QJsonObject m_report;
+    QString m_lastError;
+};
+
+#endif // PROJECTINSPECTOR_H
@@ -0,0 +1,48 @@
+#include "projectsnapshot.h"
+#include "objectserializer.h"
+#include "imageblobstore.h"
+#include "canvas/objects/vectorobject.h"
+#include "utils/parallel.h"
+
+#include <QDebug>
+
+ProjectSnapshot::~ProjectSnapshot()
+{
+    for (const FrameCopy &copy : frames)
+        qDeleteAll(copy.objects);
+}
+
+QList<ProjectArchive::PendingChunk> ProjectSnapshot::encode(ImageBlobStore &blobs) const
+{
+    // JSON first (it feeds the blob store, which is not thread-safe), then
+    // every frame's zlib stream in parallel
+    blobs.setPixmapImages(pixmapImages);
+    QList<ProjectArchive::PendingChunk> chunks;
+    QList<QJsonObject> json;
+    chunks.reserve(frames.size());
+    json.reserve(frames.size());
+    for (const FrameCopy &copy : frames) {
+        ProjectArchive::PendingChunk chunk;
+        chunk.layer = copy.layer;
+        chunk.frame = copy.frame;
+        QJsonObject frameJson;
+        if (copy.archived) {
+            chunk.data  = copy.chunk;
+            chunk.blobs = copy.blobs;
+            for (const QByteArray &hash : chunk.blobs) {
+                if (!blobs.retain(hash))
+                    qWarning() << "Image blob missing from source archive:" << hash;
+            }
+        } else if (!copy.removed) {
+            frameJson = ObjectSerializer::frameJson(copy.objects, &blobs, &chunk.blobs);
+        }
+        chunks.append(chunk);
+        json.append(frameJson);
+    }
+
+    parallelFor(chunks.size(), [&](int i) {
+        if (!json.at(i).isEmpty())
+            chunks[i].data = ObjectSerializer::compressFrame(json.at(i), compressionLevel);
+    });
+    return chunks;
+}
@@ -0,0 +1,60 @@
+#ifndef PROJECTSNAPSHOT_H
+#define PROJECTSNAPSHOT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QJsonObject>
+#include <QList>
+#include <memory>
+#include "io/projectarchive.h"
+
+class VectorObject;
+class ImageBlobStore;
+
+/**
+ * @brief Frozen copy of a project, taken for saving on a worker thread
+ *
+ * Built on the GUI thread by Project::snapshot(). Objects are clone()d,
+ * which copies their implicitly shared Qt handles (QPainterPath, QPen,
+ * QImage, ...) rather than the data behind them, and frames that were
+ * never decoded are carried as their compressed chunk. QPixmap is GUI-thread
+ * only, so image pixmaps are converted to QImage while the snapshot is taken
+ * and encode() reads those instead. Nothing in the snapshot is reachable
+ * from the scene, so encode() may run on any thread while editing continues.
+ */
+class ProjectSnapshot
+{
+public:
+    struct FrameCopy {
+        quint32 layer   = 0;
+        qint32  frame   = 0;
+        bool    removed  = false;       // the keyframe no longer exists
+        bool    archived = false;       // never decoded; chunk/blobs are set
+        QList<VectorObject*> objects;   // clones, owned by the snapshot
+        QByteArray chunk;
+        QList<QByteArray> blobs;
+    };
+
+    ProjectSnapshot() = default;
+    ~ProjectSnapshot();
+    ProjectSnapshot(const ProjectSnapshot &) = delete;
+    ProjectSnapshot &operator=(const ProjectSnapshot &) = delete;
+
+    QJsonObject header;                       // Project::headerJson()
+    std::shared_ptr<ProjectArchive> source;   // holds the archived frames' blobs
+    QList<FrameCopy> frames;
+    QHash<qint64, QImage> pixmapImages;       // image objects' pixmaps, by cacheKey()
+    int compressionLevel = 6;                 // Project::compressionLevel()
+
+    /**
+     * @brief Serialize and compress the copied frames
+     * @param blobs Receives the images the frames reference; should be
+     *              constructed with @ref source so archived blobs resolve
+     *
+     * Frames are compressed in parallel (see parallelFor()).
+     */
+    QList<ProjectArchive::PendingChunk> encode(ImageBlobStore &blobs) const;
+};
+
+#endif // PROJECTSNAPSHOT_H
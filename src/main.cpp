@@ -1,10 +1,28 @@
 #include "mainwindow.h"
 #include "ui/startupdialog.h"
+#include "io/headlessrenderer.h"
+#include "io/projectinspector.h"
 #include <QApplication>
+#include <QCoreApplication>
 #include <QStyleFactory>
 
 int main(int argc, char *argv[])
 {
+    // Inspection only reads the file; no GUI is created at all
+    if (ProjectInspector::isRequested(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        app.setOrganizationName("AkisVG");
+        app.setApplicationName("AkisVG");
+        app.setApplicationVersion("1.0.0");
+        return ProjectInspector::run(app.arguments());
+    }
+
+    // Command-line rendering needs no display; pick the offscreen platform
+    // unless the caller chose one
+    const bool headless = HeadlessRenderer::isRequested(argc, argv);
+    if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     // DPI scaling
 #ifdef Q_OS_WIN
     QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
@@ -23,6 +41,9 @@ int main(int argc, char *argv[])
     app.setApplicationName("AkisVG");
     app.setApplicationVersion("1.0.0");
 
+    if (headless)
+        return HeadlessRenderer::run(app.arguments());
+
     // Apply Fusion style on all platforms — this ensures consistent widget
     app.setStyle(QStyleFactory::create("Fusion"));
 
@@ -20,6 +20,9 @@
 #include "tools/magicwandtool.h"
 #include "canvas/objects/transformableimageobject.h"
 #include "io/gifexporter.h"
+#include "io/exportqueue.h"
+#include "io/autosaver.h"
+#include "ui/exportdialog.h"
 #include "panels/settingspanel.h"
 #include "tools/eyedroppertool.h"
 #include "utils/thememanager.h"
@@ -37,6 +40,7 @@
 #include <QFileInfo>
 #include <QCloseEvent>
 #include <QSettings>
+#include <QLocale>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -47,6 +51,8 @@
 #include <QDateTime>
 #include <QProcess>
 #include <QProgressDialog>
+#include <QProgressBar>
+#include <QToolButton>
 #include <QBuffer>
 #include <QPainter>
 #include <QSvgGenerator>
@@ -234,6 +240,7 @@ MainWindow::MainWindow(QWidget *parent)
     });
     // Undo and Redo Stack
     connect(m_undoStack, &QUndoStack::indexChanged, this, [this]() {
+        // Commands mark the frames they touch dirty themselves
         m_canvas->refreshFrame();
         if (m_layerPanel) {
             m_layerPanel->rebuildLayerList();
@@ -245,6 +252,23 @@ MainWindow::MainWindow(QWidget *parent)
         }
     });
 
+    // Background autosave; the interval is set in Project Settings
+    m_autosaver = new Autosaver(m_project, this);
+    connect(m_projectSettings, &ProjectSettings::autosaveIntervalChanged,
+            m_autosaver, &Autosaver::setIntervalMinutes);
+    connect(m_autosaver, &Autosaver::autosaved, this,
+            [this](const QString &, qint64 bytes, qint64 blockedMs, qint64 totalMs) {
+        statusBar()->showMessage(tr("Autosaved %1 in %2 ms (UI paused %3 ms)")
+                                     .arg(QLocale().formattedDataSize(bytes))
+                                     .arg(totalMs).arg(blockedMs), 4000);
+    });
+    connect(m_autosaver, &Autosaver::autosaveFailed, this, [this](const QString &error) {
+        statusBar()->showMessage(tr("Autosave failed: %1").arg(error), 5000);
+    });
+
+    // Exports render from a snapshot in the background
+    setupExportQueue();
+
     // Connect color picker texture to current tool
     connect(m_colorPicker, &ColorPicker::textureChanged,
             this, [this](int textureType) {
@@ -540,6 +564,9 @@ void MainWindow::createMenus()
     exportVideoAct->setShortcut(QKeySequence("Ctrl+Shift+E"));
     connect(exportVideoAct, &QAction::triggered, this, &MainWindow::exportToMp4);
 
+    QAction *exportPngAct = m_fileMenu->addAction("Export PNG &Sequence...");
+    connect(exportPngAct, &QAction::triggered, this, &MainWindow::exportPngSequence);
+
     QAction *exportGifKeyframesAct = m_fileMenu->addAction("Export to GIF (Keyframes)...");
     connect(exportGifKeyframesAct, &QAction::triggered, this, &MainWindow::exportGifKeyframes);
 
@@ -654,6 +681,15 @@ void MainWindow::createMenus()
         m_canvas->refreshFrame();   // redraw immediately, no geometry change = no jump
     });
 
+    QAction *thumbnailsAct = m_viewMenu->addAction("Show Timeline Thumbnails");
+    thumbnailsAct->setCheckable(true);
+    thumbnailsAct->setChecked(QSettings("AkisVG", "AkisVG").value("timeline/thumbnails", false).toBool());
+    m_timeline->setThumbnailsVisible(thumbnailsAct->isChecked());
+    connect(thumbnailsAct, &QAction::toggled, this, [this](bool visible) {
+        QSettings("AkisVG", "AkisVG").setValue("timeline/thumbnails", visible);
+        m_timeline->setThumbnailsVisible(visible);
+    });
+
     m_viewMenu->addSeparator();
 
     // Help Menu
@@ -957,6 +993,7 @@ void MainWindow::newProject()
     m_canvas->refreshFrame();
     m_isModified = false;
     m_currentFile.clear();
+    m_autosaver->setProjectPath(m_currentFile);
     updateWindowTitle();
     statusBar()->showMessage("New project created", 3000);
 }
@@ -975,6 +1012,7 @@ void MainWindow::openProject()
     if (!fileName.isEmpty()) {
         if (m_project->loadFromFile(fileName)) {
             m_currentFile = fileName;
+            m_autosaver->setProjectPath(m_currentFile);
             m_isModified = false;
             updateWindowTitle();
             m_canvas->clearDisplay();
@@ -1004,6 +1042,7 @@ void MainWindow::saveProjectAs()
             fileName += ".avg";
         }
         m_currentFile = fileName;
+        m_autosaver->setProjectPath(m_currentFile);
         saveProject();
     }
 }
@@ -1112,6 +1151,7 @@ void MainWindow::openProjectFile(const QString &path)
 
     if (m_project->loadFromFile(path)) {
         m_currentFile = path;
+        m_autosaver->setProjectPath(m_currentFile);
         m_isModified  = false;
         updateWindowTitle();
         m_canvas->clearDisplay();
@@ -1150,6 +1190,16 @@ void MainWindow::about()
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
+    if (m_exportQueue && m_exportQueue->isBusy()) {
+        if (QMessageBox::question(this, "Exports Running",
+                                  "Exports are still running. Cancel them and quit?")
+                != QMessageBox::Yes) {
+            event->ignore();
+            return;
+        }
+        m_exportQueue->cancelAll();
+    }
+
     if (m_isModified) {
         QMessageBox::StandardButton reply = QMessageBox::question(this,
                                                                   "Unsaved Changes",
@@ -1237,128 +1287,130 @@ void MainWindow::updateWindowTitle()
     setWindowTitle(title);
 }
 
+void MainWindow::setupExportQueue()
+{
+    m_exportQueue = new ExportQueue(m_project, this);
+
+    m_exportProgress = new QProgressBar(this);
+    m_exportProgress->setMaximumWidth(220);
+    m_exportProgress->setTextVisible(true);
+    m_exportCancel = new QToolButton(this);
+    m_exportCancel->setText("✕");
+    m_exportCancel->setToolTip("Cancel exports");
+    m_exportCancel->setAutoRaise(true);
+    statusBar()->addPermanentWidget(m_exportProgress);
+    statusBar()->addPermanentWidget(m_exportCancel);
+    connect(m_exportCancel, &QToolButton::clicked, m_exportQueue, &ExportQueue::cancelAll);
+
+    connect(m_exportQueue, &ExportQueue::queueChanged, this, &MainWindow::updateExportStatus);
+    connect(m_exportQueue, &ExportQueue::jobProgress, this, [this](ExportJob *, int done, int total) {
+        m_exportProgress->setMaximum(qMax(1, total));
+        m_exportProgress->setValue(done);
+    });
+    connect(m_exportQueue, &ExportQueue::jobFinished, this, [this](ExportJob *job, bool ok) {
+        if (ok) {
+            statusBar()->showMessage(QString("Exported %1").arg(job->displayName()), 5000);
+        } else if (job->isCancelled()) {
+            statusBar()->showMessage(QString("Export of %1 cancelled").arg(job->displayName()), 5000);
+        } else {
+            QMessageBox::critical(this, "Export Error",
+                                  QString("Exporting %1 failed:\n\n%2")
+                                      .arg(job->displayName(), job->lastError()));
+        }
+    });
+    updateExportStatus();
+}
+
+void MainWindow::updateExportStatus()
+{
+    ExportJob *job = m_exportQueue->currentJob();
+    m_exportProgress->setVisible(job != nullptr);
+    m_exportCancel->setVisible(job != nullptr);
+    if (!job) return;
+
+    const int pending = m_exportQueue->pendingCount();
+    m_exportProgress->setFormat(pending > 0
+        ? QString("%1 %p% (+%2 queued)").arg(job->displayName()).arg(pending)
+        : QString("%1 %p%").arg(job->displayName()));
+    m_exportProgress->setMaximum(qMax(1, int(job->settings().frames.size())));
+    m_exportProgress->setValue(0);
+}
+
 void MainWindow::exportToMp4()
 {
+    // Export only up to the last frame that has actual content
+    const int lastUsedFrame = qMax(1, m_project->highestUsedFrame());
+
+    ExportDialog dialog(ExportDialog::ExportType::Video, this);
+    dialog.setDefaultResolution(m_project->width(), m_project->height());
+    dialog.setDefaultFPS(m_project->fps());
+    dialog.setFrameRange(1, lastUsedFrame);
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    const QString format = dialog.format();
     QString fileName = QFileDialog::getSaveFileName(
         this, "Export to Video", "",
-        "MP4 Video (*.mp4);;MKV Video (*.mkv);;All Files (*)");
+        QString("%1 Video (*.%2);;All Files (*)").arg(format.toUpper(), format));
 
     if (fileName.isEmpty())
         return;
+    if (!fileName.endsWith("." + format, Qt::CaseInsensitive))
+        fileName += "." + format;
+
+    const int startFrame = dialog.exportAllFrames() ? 1 : dialog.startFrame();
+    const int endFrame   = dialog.exportAllFrames() ? lastUsedFrame
+                                                    : qMax(startFrame, dialog.endFrame());
+
+    ExportJob::Settings settings;
+    settings.kind = ExportJob::Kind::Video;
+    settings.outputPath = fileName;
+    for (int frame = startFrame; frame <= endFrame; ++frame)
+        settings.frames.append(frame);
+    // Frames are painted straight at the chosen size; yuv420p needs even
+    // dimensions
+    settings.outputSize = QSize(dialog.width() & ~1, dialog.height() & ~1);
+    settings.supersampling = dialog.supersampling();
+    settings.draft = dialog.draftMode();
+    settings.fps = dialog.fps();
+    if (format == "webm")
+        settings.videoArgs << "-c:v" << "libvpx-vp9" << "-b:v" << "0" << "-crf" << "32";
+    else
+        settings.videoArgs << "-c:v" << "libx264" << "-preset" << (format == "mkv" ? "medium" : "slow")
+                           << "-crf" << "18";
+    settings.videoArgs << "-pix_fmt" << "yuv420p";
+
+    // Rendering and encoding run in the background; editing can continue
+    m_exportQueue->enqueue(settings);
+}
 
-    QString format = "mp4";
-    if (fileName.endsWith(".mkv", Qt::CaseInsensitive))
-        format = "mkv";
-    else if (!fileName.endsWith(".mp4", Qt::CaseInsensitive))
-        fileName += ".mp4";
+void MainWindow::exportPngSequence()
+{
+    const int lastUsedFrame = qMax(1, m_project->highestUsedFrame());
 
-    // Export only up to the last frame that has actual content
-    int startFrame = 1;
-    int endFrame   = qMax(1, m_project->highestUsedFrame());
-    int fps        = m_project->fps();
-
-    //  Locate ffmpeg binary (QProcess::start(singleString) does NOT invoke
-    //    a shell on Linux, so we must pass program + args separately)
-    QString ffmpegBin = QStandardPaths::findExecutable("ffmpeg");
-    if (ffmpegBin.isEmpty()) {
-        for (const char *p : {"/usr/bin/ffmpeg", "/usr/local/bin/ffmpeg", "/bin/ffmpeg"})
-            if (QFile::exists(p)) { ffmpegBin = p; break; }
-    }
-    if (ffmpegBin.isEmpty()) {
-        QMessageBox::critical(this, "Export Error",
-                              "ffmpeg was not found.\n\nInstall it with:  sudo pacman -S ffmpeg");
+    ExportDialog dialog(ExportDialog::ExportType::ImageSequence, this);
+    dialog.setDefaultResolution(m_project->width(), m_project->height());
+    dialog.setFrameRange(1, lastUsedFrame);
+    if (dialog.exec() != QDialog::Accepted)
         return;
-    }
-
-    QProgressDialog progress("Exporting frames…", "Cancel", 0, endFrame, this);
-    progress.setWindowModality(Qt::WindowModal);
-    progress.setMinimumDuration(0);
-    progress.setValue(0);
-
-    QString tempDir = QDir::temp().filePath("akisvg_export_" +
-                                            QString::number(QDateTime::currentMSecsSinceEpoch()));
-    QDir().mkpath(tempDir);
-
-    int savedFrame = m_project->currentFrame();
-
-    for (int frame = startFrame; frame <= endFrame; ++frame) {
-        if (progress.wasCanceled()) {
-            QDir(tempDir).removeRecursively();
-            m_project->setCurrentFrame(savedFrame);
-            m_canvas->refreshFrame();
-            return;
-        }
 
-        m_project->setCurrentFrame(frame);
-        m_canvas->refreshFrame();
-
-        QImage image(m_project->width(), m_project->height(), QImage::Format_ARGB32);
-        image.fill(Qt::white);
-        QPainter painter(&image);
-        painter.setRenderHint(QPainter::Antialiasing);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform);
-        m_canvas->render(&painter,
-                         QRectF(0, 0, m_project->width(), m_project->height()),
-                         QRectF(0, 0, m_project->width(), m_project->height()));
-        painter.end();
-
-        image.save(tempDir + QString("/frame_%1.png").arg(frame, 6, 10, QChar('0')), "PNG");
-        progress.setValue(frame);
-        QApplication::processEvents();
-    }
-
-    // Build argument list NOT a shell string
-    QStringList args;
-    args << "-y"
-         << "-framerate"    << QString::number(fps)
-         << "-start_number" << QString::number(startFrame)
-         << "-i"            << (tempDir + "/frame_%06d.png")
-         << "-c:v"          << "libx264"
-         << "-preset"       << (format == "mkv" ? "medium" : "slow")
-         << "-crf"          << "18"
-         << "-pix_fmt"      << "yuv420p"
-         << fileName;
-
-    progress.setLabelText(QString("Encoding %1…").arg(format.toUpper()));
-    progress.setRange(0, 0);
-    QApplication::processEvents();
-
-    QProcess ffmpeg;
-    ffmpeg.setProgram(ffmpegBin);
-    ffmpeg.setArguments(args);
-    ffmpeg.setProcessChannelMode(QProcess::MergedChannels);
-    ffmpeg.start();
-
-    if (!ffmpeg.waitForStarted(5000)) {
-        QMessageBox::critical(this, "Export Error",
-                              QString("Failed to launch ffmpeg:\n%1\n\n%2")
-                                  .arg(ffmpegBin, ffmpeg.errorString()));
-        QDir(tempDir).removeRecursively();
-        m_project->setCurrentFrame(savedFrame);
-        m_canvas->refreshFrame();
+    const QString dir = QFileDialog::getExistingDirectory(this, "Export PNG Sequence");
+    if (dir.isEmpty())
         return;
-    }
-
-    while (!ffmpeg.waitForFinished(200)) {
-        QApplication::processEvents();
-        if (progress.wasCanceled()) { ffmpeg.kill(); break; }
-    }
-
-    QDir(tempDir).removeRecursively();
-    m_project->setCurrentFrame(savedFrame);
-    m_canvas->refreshFrame();
 
-    if (ffmpeg.exitCode() == 0) {
-        statusBar()->showMessage(
-            QString("%1 exported: %2").arg(format.toUpper(), QFileInfo(fileName).fileName()), 5000);
-        QMessageBox::information(this, "Export Complete",
-                                 QString("Exported to:\n%1\n\n%2  |  %3 frames  |  %4 fps")
-                                     .arg(fileName, format.toUpper()).arg(endFrame).arg(fps));
-    } else {
-        QMessageBox::critical(this, "Export Error",
-                              QString("ffmpeg exited %1.\n\n%2")
-                                  .arg(ffmpeg.exitCode()).arg(QString(ffmpeg.readAll()).right(2000)));
-    }
+    const int startFrame = dialog.exportAllFrames() ? 1 : dialog.startFrame();
+    const int endFrame   = dialog.exportAllFrames() ? lastUsedFrame
+                                                    : qMax(startFrame, dialog.endFrame());
+
+    ExportJob::Settings settings;
+    settings.kind = ExportJob::Kind::PngSequence;
+    settings.outputPath = dir;
+    for (int frame = startFrame; frame <= endFrame; ++frame)
+        settings.frames.append(frame);
+    settings.outputSize = QSize(dialog.width(), dialog.height());
+    settings.supersampling = dialog.supersampling();
+    settings.draft = dialog.draftMode();
+    m_exportQueue->enqueue(settings);
 }
 
 void MainWindow::exportGifKeyframes() {
@@ -1368,34 +1420,18 @@ void MainWindow::exportGifKeyframes() {
     if (filePath.isEmpty()) return;
 
     GifExporter exporter(m_project);
-    exporter.setFrameDelay(1000 / m_project->fps());
-    exporter.setLoop(true);
-
-    QProgressDialog progress("Exporting GIF (Keyframes Only)...", "Cancel", 0, 100, this);
-    progress.setWindowModality(Qt::WindowModal);
-    progress.setMinimumDuration(0);
-
-    connect(&exporter, &GifExporter::exportStarted, [&progress](int totalFrames) {
-        progress.setMaximum(totalFrames);
-        progress.setValue(0);
-    });
-
-    connect(&exporter, &GifExporter::frameExported, [&progress](int current, int /*total*/) {
-        progress.setValue(current);
-    });
-
-    bool success = exporter.exportToGif(filePath, GifExporter::ExportMode::KeyframesOnly);
-
-    progress.close();
-
-    if (success) {
-        QMessageBox::information(this, "Export Successful",
-                                 QString("GIF exported successfully to:\n%1").arg(filePath));
-        statusBar()->showMessage("GIF exported successfully", 5000);
-    } else {
-        QMessageBox::warning(this, "Export Failed",
-                             QString("Failed to export GIF:\n%1").arg(exporter.lastError()));
+    ExportJob::Settings settings;
+    settings.kind = ExportJob::Kind::Gif;
+    settings.outputPath = filePath;
+    settings.frames = exporter.getFramesToExport(GifExporter::ExportMode::KeyframesOnly,
+                                                 1, m_project->totalFrames());
+    settings.gifFrameDelayMs = 1000 / m_project->fps();
+    settings.gif.loopCount = 0;   // loop forever
+    if (settings.frames.isEmpty()) {
+        QMessageBox::warning(this, "Export Failed", "No frames to export");
+        return;
     }
+    m_exportQueue->enqueue(settings);
 }
 
 void MainWindow::exportGifAllFrames() {
@@ -1404,35 +1440,14 @@ void MainWindow::exportGifAllFrames() {
 
     if (filePath.isEmpty()) return;
 
-    GifExporter exporter(m_project);
-    exporter.setFrameDelay(1000 / m_project->fps());
-    exporter.setLoop(true);
-
-    QProgressDialog progress("Exporting GIF (All Frames)...", "Cancel", 0, 100, this);
-    progress.setWindowModality(Qt::WindowModal);
-    progress.setMinimumDuration(0);
-
-    connect(&exporter, &GifExporter::exportStarted, [&progress](int totalFrames) {
-        progress.setMaximum(totalFrames);
-        progress.setValue(0);
-    });
-
-    connect(&exporter, &GifExporter::frameExported, [&progress](int current, int /*total*/) { // FIXED
-        progress.setValue(current);
-    });
-
-    bool success = exporter.exportToGif(filePath, GifExporter::ExportMode::EveryFrame);
-
-    progress.close();
-
-    if (success) {
-        QMessageBox::information(this, "Export Successful",
-                                 QString("GIF exported successfully to:\n%1").arg(filePath));
-        statusBar()->showMessage("GIF exported successfully", 5000);
-    } else {
-        QMessageBox::warning(this, "Export Failed",
-                             QString("Failed to export GIF:\n%1").arg(exporter.lastError()));
-    }
+    ExportJob::Settings settings;
+    settings.kind = ExportJob::Kind::Gif;
+    settings.outputPath = filePath;
+    for (int frame = 1; frame <= m_project->totalFrames(); ++frame)
+        settings.frames.append(frame);
+    settings.gifFrameDelayMs = 1000 / m_project->fps();
+    settings.gif.loopCount = 0;   // loop forever
+    m_exportQueue->enqueue(settings);
 }
 
 void MainWindow::importAudio()
@@ -1813,7 +1828,9 @@ void MainWindow::onLassoFill(const QPolygonF &poly, const QColor &color)
             m_undoStack->beginMacro("Lasso Fill");
             macro = true;
         }
-        m_undoStack->push(new FillColorCommand(src, color));
+        int frame = -1;
+        Layer *layer = m_project->layerOfObject(src, &frame);
+        m_undoStack->push(new FillColorCommand(src, layer, frame, color));
     }
     if (macro) {
         m_undoStack->endMacro();
@@ -1893,7 +1910,10 @@ void MainWindow::onLassoCut(const QPolygonF &poly)
             if (hasInside && hasOutside) {
                 ensureCutMacro();
                 QPainterPath beforePath = path->path();
-                m_undoStack->push(new PathObjectPathCommand(path, beforePath, outsidePart));
+                int keyFrame = -1;
+                Layer *owner = m_project->layerOfObject(path, &keyFrame);
+                m_undoStack->push(new PathObjectPathCommand(path, owner, keyFrame,
+                                                            beforePath, outsidePart));
 
                 PathObject *insideObj = new PathObject();
                 insideObj->setPath(insidePart);
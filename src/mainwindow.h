@@ -22,6 +22,10 @@ class ProjectSettings;
 class SplineOverlay;
 class ObjectGroup;
 class EyedropperTool;
+class Autosaver;
+class ExportQueue;
+class QProgressBar;
+class QToolButton;
 // ── NEW TOOL INCLUDES ────────────────────────────────────────────────────────
 class LassoTool;
 class MagicWandTool;
@@ -60,6 +64,7 @@ private slots:
 
     // Export functions
     void exportToMp4();
+    void exportPngSequence();
     void exportGifKeyframes();
     void exportGifAllFrames();
 
@@ -94,6 +99,14 @@ private:
     ProjectSettings *m_projectSettings;
     SplineOverlay *m_splineOverlay = nullptr;
     EyedropperTool *m_eyedropperTool;
+    Autosaver *m_autosaver = nullptr;
+
+    // Background exports and their status bar readout
+    ExportQueue *m_exportQueue = nullptr;
+    QProgressBar *m_exportProgress = nullptr;
+    QToolButton *m_exportCancel = nullptr;
+    void setupExportQueue();
+    void updateExportStatus();
 
     // ── NEW TOOLS ────────────────────────────────────────────────────────────
     LassoTool     *m_lassoTool     = nullptr;
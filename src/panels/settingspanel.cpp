@@ -400,6 +400,76 @@ void ProjectSettings::setupUI()
 
     contentLayout->addWidget(audioGroup);
 
+    // === SAVING ===
+    QGroupBox *savingGroup = new QGroupBox("Saving");
+    savingGroup->setStyleSheet(playbackGroup->styleSheet());
+
+    QVBoxLayout *savingLayout = new QVBoxLayout(savingGroup);
+
+    QHBoxLayout *autosaveLayout = new QHBoxLayout();
+    QLabel *autosaveLabel = new QLabel("Autosave Every:");
+    autosaveLabel->setStyleSheet("color: #ccc; font-weight: normal;");
+    m_autosaveSpin = new QSpinBox();
+    m_autosaveSpin->setRange(0, 120);
+    m_autosaveSpin->setSuffix(" min");
+    m_autosaveSpin->setSpecialValueText("Off");
+    {
+        QSettings s("AkisVG", "AkisVG");
+        m_autosaveSpin->setValue(s.value("autosave/intervalMinutes", 5).toInt());
+    }
+    m_autosaveSpin->setStyleSheet(
+        "QSpinBox { background-color: #1e1e1e; color: white; border: 1px solid #555; "
+        "border-radius: 3px; padding: 4px; min-width: 60px; }"
+        "QSpinBox:hover { border-color: #c0392b; }");
+    connect(m_autosaveSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, [this](int minutes) {
+        QSettings s("AkisVG", "AkisVG");
+        s.setValue("autosave/intervalMinutes", minutes);
+        emit autosaveIntervalChanged(minutes);
+    });
+    autosaveLayout->addWidget(autosaveLabel);
+    autosaveLayout->addWidget(m_autosaveSpin);
+    autosaveLayout->addStretch();
+    savingLayout->addLayout(autosaveLayout);
+
+    // Compression effort for saved frames; an app-wide preference
+    QHBoxLayout *compressionLayout = new QHBoxLayout();
+    QLabel *compressionLabel = new QLabel("Compression:");
+    compressionLabel->setStyleSheet("color: #ccc; font-weight: normal;");
+    m_compressionCombo = new QComboBox();
+    m_compressionCombo->addItem("Fast",     static_cast<int>(Project::SaveCompression::Fast));
+    m_compressionCombo->addItem("Balanced", static_cast<int>(Project::SaveCompression::Balanced));
+    m_compressionCombo->addItem("Small",    static_cast<int>(Project::SaveCompression::Small));
+    m_compressionCombo->setToolTip("Fast saves quickest, Small produces the smallest files");
+    m_compressionCombo->setStyleSheet(m_fpsCombo->styleSheet());
+    {
+        QSettings s("AkisVG", "AkisVG");
+        const int saved = s.value("save/compression",
+                                  static_cast<int>(Project::SaveCompression::Balanced)).toInt();
+        m_compressionCombo->setCurrentIndex(qMax(0, m_compressionCombo->findData(saved)));
+        m_project->setSaveCompression(static_cast<Project::SaveCompression>(
+            m_compressionCombo->currentData().toInt()));
+    }
+    connect(m_compressionCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, [this](int index) {
+        const int value = m_compressionCombo->itemData(index).toInt();
+        m_project->setSaveCompression(static_cast<Project::SaveCompression>(value));
+        QSettings s("AkisVG", "AkisVG");
+        s.setValue("save/compression", value);
+        emit settingsChanged();
+    });
+    compressionLayout->addWidget(compressionLabel);
+    compressionLayout->addWidget(m_compressionCombo);
+    compressionLayout->addStretch();
+    savingLayout->addLayout(compressionLayout);
+
+    QLabel *autosaveHint = new QLabel("Runs in the background; only changed frames are written.");
+    autosaveHint->setStyleSheet("color: #555; font-size: 10px;");
+    autosaveHint->setWordWrap(true);
+    savingLayout->addWidget(autosaveHint);
+
+    contentLayout->addWidget(savingGroup);
+
 
     // === APPEARANCE GROUP ===
     QGroupBox *appearanceGroup = new QGroupBox("Appearance");
@@ -23,6 +23,7 @@ public:
 signals:
     void settingsChanged();
     void themeChanged(int themeIndex);
+    void autosaveIntervalChanged(int minutes);   // 0 = off
 
 private slots:
     void onFpsChanged(int index);
@@ -54,6 +55,8 @@ private:
     QCheckBox *m_blueThemeCheck; // kept for ABI compat, unused
     QComboBox *m_themeCombo;
     QLineEdit *m_sf2Edit = nullptr;  // MIDI soundfont path
+    QSpinBox *m_autosaveSpin = nullptr;
+    QComboBox *m_compressionCombo = nullptr;
 };
 
 #endif // PROJECTSETTINGS_H
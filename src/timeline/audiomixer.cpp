@@ -0,0 +1,257 @@
+#include "audiomixer.h"
+#include "io/pcmdecodejob.h"
+
+#include <QAudioDevice>
+#include <QAudioSink>
+#include <QIODevice>
+#include <QMediaDevices>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+
+// Audio buffered in the sink; also the delay before a seek is heard
+static const int SinkBufferMs = 60;
+// Scrubbing trades robustness for latency: a grain starts within this
+static const int ScrubBufferMs = 15;
+// Fade at both ends of a grain, so cutting it off does not click
+static const int GrainFadeMs = 4;
+// The scrub sink is closed after this long without a grain
+static const int ScrubIdleMs = 1000;
+
+// Hands the mix to the sink; all the work happens in AudioMixer::read()
+class AudioMixer::Source : public QIODevice
+{
+public:
+    explicit Source(AudioMixer *mixer) : QIODevice(mixer), m_mixer(mixer) {}
+
+    bool isSequential() const override { return true; }
+    // The mix never runs dry: past the last clip it is silence
+    qint64 bytesAvailable() const override { return (1 << 20) + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override { return m_mixer->read(data, maxSize); }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    AudioMixer *m_mixer;
+};
+
+AudioMixer::AudioMixer(QObject *parent)
+    : QObject(parent)
+    , m_source(new Source(this))
+    , m_scrubIdle(new QTimer(this))
+{
+    m_source->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    m_scrubIdle->setSingleShot(true);
+    m_scrubIdle->setInterval(ScrubIdleMs);
+    connect(m_scrubIdle, &QTimer::timeout, this, [this]() {
+        if (m_scrubbing) stop();
+    });
+}
+
+AudioMixer::~AudioMixer()
+{
+    stop();
+}
+
+void AudioMixer::setClips(const QList<Clip> &clips)
+{
+    QMutexLocker lock(&m_mutex);
+    m_clips = clips;
+}
+
+void AudioMixer::setMasterVolume(float volume)
+{
+    QMutexLocker lock(&m_mutex);
+    m_masterVolume = volume;
+}
+
+void AudioMixer::start(qint64 timelineMs)
+{
+    if (isRunning()) return;
+    stop();   // a scrub sink, with its small buffer
+
+    openSink(SinkBufferMs);
+    {
+        QMutexLocker lock(&m_mutex);
+        m_cursor = timelineMs * m_format.sampleRate() / 1000;
+        m_seekFrame = m_cursor;
+    }
+    m_sink->start(m_source);
+}
+
+void AudioMixer::openSink(int bufferMs)
+{
+    // Float stereo when the device takes it; otherwise whatever it prefers
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    QAudioFormat format = device.preferredFormat();
+    QAudioFormat stereo = format;
+    stereo.setChannelCount(2);
+    stereo.setSampleFormat(QAudioFormat::Float);
+    if (device.isFormatSupported(stereo))
+        format = stereo;
+    if (format.sampleRate() <= 0)
+        format.setSampleRate(48000);
+
+    {
+        QMutexLocker lock(&m_mutex);
+        m_format = format;
+    }
+    m_sink = new QAudioSink(device, format, this);
+    m_sink->setBufferSize(format.bytesForDuration(bufferMs * 1000));
+}
+
+void AudioMixer::stop()
+{
+    m_scrubIdle->stop();
+    if (!m_sink) return;
+    m_sink->stop();
+    delete m_sink;
+    m_sink = nullptr;
+    m_scrubbing = false;
+}
+
+void AudioMixer::scrub(qint64 timelineMs, qint64 durationMs)
+{
+    if (isRunning() || durationMs <= 0) return;
+    if (!m_sink) {
+        m_scrubbing = true;
+        openSink(ScrubBufferMs);
+        {
+            QMutexLocker lock(&m_mutex);
+            m_grain.clear();
+            m_grainPos = 0;
+        }
+        m_sink->start(m_source);
+    }
+    m_scrubIdle->start();
+
+    QMutexLocker lock(&m_mutex);
+    const int rate = m_format.sampleRate();
+    const int frameCount = int(durationMs * rate / 1000);
+    m_grain.resize(frameCount * 2);
+    mix(m_grain.data(), frameCount, timelineMs * rate / 1000);
+
+    // Raised-cosine edges; the middle of the grain is left as it is
+    const int fade = qMin(frameCount / 2, GrainFadeMs * rate / 1000);
+    for (int i = 0; i < fade; ++i) {
+        const float gain = 0.5f - 0.5f * std::cos(float(M_PI) * (i + 0.5f) / fade);
+        for (int c = 0; c < 2; ++c) {
+            m_grain[i * 2 + c] *= gain;
+            m_grain[(frameCount - 1 - i) * 2 + c] *= gain;
+        }
+    }
+    m_grainPos = 0;
+}
+
+void AudioMixer::seek(qint64 timelineMs)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_format.sampleRate() <= 0) return;
+    m_cursor = timelineMs * m_format.sampleRate() / 1000;
+    m_seekFrame = m_cursor;
+}
+
+qint64 AudioMixer::positionMs() const
+{
+    if (!isRunning()) return -1;
+    // What the sink holds has been mixed but not heard yet
+    const int bytesPerFrame = qMax(1, m_format.bytesPerFrame());
+    const qint64 queued = qMax<qint64>(0, m_sink->bufferSize() - m_sink->bytesFree()) / bytesPerFrame;
+
+    QMutexLocker lock(&m_mutex);
+    const qint64 frame = qMax(m_seekFrame, m_cursor - queued);
+    return frame * 1000 / qMax(1, m_format.sampleRate());
+}
+
+qint64 AudioMixer::read(char *data, qint64 maxSize)
+{
+    QMutexLocker lock(&m_mutex);
+    const int bytesPerFrame = m_format.bytesPerFrame();
+    const int frameCount = bytesPerFrame > 0 ? int(maxSize / bytesPerFrame) : 0;
+    if (frameCount <= 0) return 0;
+
+    m_mixBuffer.resize(frameCount * 2);
+    if (m_scrubbing) {
+        // The rest of the current grain, then silence
+        const int grainFrames = m_grain.size() / 2;
+        const int count = qBound(0, grainFrames - m_grainPos, frameCount);
+        std::copy_n(m_grain.constData() + m_grainPos * 2, count * 2, m_mixBuffer.data());
+        std::fill(m_mixBuffer.begin() + count * 2, m_mixBuffer.end(), 0.0f);
+        m_grainPos += count;
+    } else {
+        mix(m_mixBuffer.data(), frameCount, m_cursor);
+        m_cursor += frameCount;
+    }
+
+    // Stereo mix to the device's channel layout and sample format
+    const int channels = m_format.channelCount();
+    const int bytesPerSample = m_format.bytesPerSample();
+    char *out = data;
+    for (int i = 0; i < frameCount; ++i) {
+        const float left = m_mixBuffer[i * 2];
+        const float right = m_mixBuffer[i * 2 + 1];
+        for (int c = 0; c < channels; ++c) {
+            float v = channels == 1 ? (left + right) * 0.5f : c == 0 ? left : c == 1 ? right : 0.0f;
+            v = std::clamp(v, -1.0f, 1.0f);
+            switch (m_format.sampleFormat()) {
+            case QAudioFormat::Float:
+                *reinterpret_cast<float *>(out) = v;
+                break;
+            case QAudioFormat::Int16:
+                *reinterpret_cast<qint16 *>(out) = qint16(v * 32767.0f);
+                break;
+            case QAudioFormat::Int32:
+                *reinterpret_cast<qint32 *>(out) = qint32(v * 2147483647.0);
+                break;
+            case QAudioFormat::UInt8:
+                *reinterpret_cast<quint8 *>(out) = quint8(128 + int(v * 127.0f));
+                break;
+            default:
+                std::fill_n(out, bytesPerSample, 0);
+                break;
+            }
+            out += bytesPerSample;
+        }
+    }
+    return qint64(frameCount) * bytesPerFrame;
+}
+
+void AudioMixer::mix(float *stereo, int frameCount, qint64 firstFrame) const
+{
+    std::fill_n(stereo, frameCount * 2, 0.0f);
+    const int rate = m_format.sampleRate();
+
+    for (const Clip &clip : m_clips) {
+        if (!clip.pcm || clip.pcm->frameCount() == 0) continue;
+        const PcmAudio &pcm = *clip.pcm;
+
+        // Output frames covered by the clip; source frames are read at
+        // pcm.sampleRate / rate per output frame and interpolated
+        const double step = double(pcm.sampleRate) / rate;
+        const qint64 clipStart = clip.startMs * rate / 1000;
+        qint64 clipFrames = qint64(pcm.frameCount() / step);
+        if (clip.lengthMs >= 0)
+            clipFrames = qMin(clipFrames, clip.lengthMs * rate / 1000);
+        const qint64 from = qMax(firstFrame, clipStart);
+        const qint64 to = qMin(firstFrame + frameCount, clipStart + clipFrames);
+        if (from >= to) continue;
+
+        const float gain = clip.volume * m_masterVolume;
+        const int channels = pcm.channelCount;
+        const qint64 last = pcm.frameCount() - 1;
+        const float *samples = pcm.samples.constData();
+        for (qint64 f = from; f < to; ++f) {
+            const double pos = (f - clipStart) * step;
+            const qint64 i = qMin(qint64(pos), last);
+            const float frac = float(pos - i);
+            const float *a = samples + i * channels;
+            const float *b = samples + qMin(i + 1, last) * channels;
+            const float left = a[0] + (b[0] - a[0]) * frac;
+            const float right = channels > 1 ? a[1] + (b[1] - a[1]) * frac : left;
+            float *out = stereo + (f - firstFrame) * 2;
+            out[0] += left * gain;
+            out[1] += right * gain;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef AUDIOMIXER_H
+#define AUDIOMIXER_H
+
+#include <QAudioFormat>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+#include <memory>
+
+struct PcmAudio;
+class QAudioSink;
+class QIODevice;
+class QTimer;
+
+/**
+ * @brief Mixes every audible clip of the project into one output stream
+ *
+ * Clips are decoded to PCM once (PcmDecodeJob) and handed over with their
+ * place on the timeline and volume. A single QAudioSink pulls from the
+ * mixer, which resamples and sums the clips at the output rate, so all
+ * clips stay sample-accurate to each other and a seek only moves the read
+ * position.
+ *
+ * The mixer's position is also the playback clock: positionMs() is what
+ * has actually reached the speakers, the samples still buffered in the
+ * sink subtracted.
+ *
+ * While stopped, scrub() plays one short grain of the mix. The sink then
+ * stays open with a small buffer until scrubbing pauses, so each grain is
+ * heard within a few milliseconds of the frame change.
+ */
+class AudioMixer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Clip {
+        std::shared_ptr<const PcmAudio> pcm;
+        qint64 startMs = 0;     // timeline position of the first sample (frame 1 = 0)
+        qint64 lengthMs = -1;   // -1 = to the end of the audio
+        float volume = 1.0f;
+    };
+
+    explicit AudioMixer(QObject *parent = nullptr);
+    ~AudioMixer();
+
+    void setClips(const QList<Clip> &clips);
+    void setMasterVolume(float volume);
+
+    void start(qint64 timelineMs);
+    void stop();
+    bool isRunning() const { return m_sink != nullptr && !m_scrubbing; }
+    void seek(qint64 timelineMs);
+
+    // Plays the mix of [timelineMs, timelineMs + durationMs) with faded
+    // edges, cutting off the previous grain; ignored while running
+    void scrub(qint64 timelineMs, qint64 durationMs);
+
+    // Timeline position being heard, -1 when stopped
+    qint64 positionMs() const;
+
+private:
+    class Source;
+
+    void openSink(int bufferMs);
+    qint64 read(char *data, qint64 maxSize);   // pulled by the sink
+    void mix(float *stereo, int frameCount, qint64 firstFrame) const;
+
+    QAudioFormat m_format;
+    QAudioSink *m_sink = nullptr;
+    Source *m_source = nullptr;
+    bool m_scrubbing = false;   // the sink plays grains, not the timeline
+    QTimer *m_scrubIdle;        // closes the sink once scrubbing pauses
+
+    mutable QMutex m_mutex;     // guards everything below
+    QList<Clip> m_clips;
+    float m_masterVolume = 1.0f;
+    qint64 m_cursor = 0;        // next output frame to mix, frame 0 = timeline start
+    qint64 m_seekFrame = 0;     // the position is never reported before this
+    QVector<float> m_mixBuffer;
+    QVector<float> m_grain;     // stereo, windowed
+    int m_grainPos = 0;         // frames of the grain already played
+};
+
+#endif // AUDIOMIXER_H
@@ -0,0 +1,132 @@
+#include "playbackengine.h"
+#include "core/project.h"
+
+#include <QTimerEvent>
+
+PlaybackEngine::PlaybackEngine(Project *project, QObject *parent)
+    : QObject(parent)
+    , m_project(project)
+{
+    connect(m_project, &Project::currentFrameChanged, this, &PlaybackEngine::onFrameChanged);
+}
+
+void PlaybackEngine::start()
+{
+    if (isRunning()) return;
+    m_wall.start();
+    m_shown = 0;
+    m_dropped = 0;
+    m_statsWallMs = 0;
+    m_statsShown = 0;
+    m_fps = 0;
+    m_presentMs = 0;
+    anchorAt(m_project->currentFrame());
+    // Ticks only sample the clock; the clock decides which frame is due
+    m_timerId = startTimer(TickMs, Qt::PreciseTimer);
+}
+
+void PlaybackEngine::stop()
+{
+    if (!isRunning()) return;
+    killTimer(m_timerId);
+    m_timerId = -1;
+    const qint64 elapsed = m_wall.elapsed();
+    m_fps = elapsed > 0 ? m_shown * 1000.0 / elapsed : 0.0;
+    emit statsChanged(m_fps, m_dropped);
+}
+
+double PlaybackEngine::achievedFps() const
+{
+    return m_fps;
+}
+
+void PlaybackEngine::anchorAt(int frame)
+{
+    const int fps = qMax(1, m_project->fps());
+    m_frame = frame;
+    m_anchorClockMs = qint64(frame - 1) * 1000 / fps;
+    m_anchorWallMs = m_wall.elapsed();
+    m_clockMs = m_anchorClockMs;
+    m_lastAudioMs = -1;
+}
+
+void PlaybackEngine::onFrameChanged(int frame)
+{
+    // Someone else moved the playhead (a click, a key): play on from there
+    if (isRunning() && !m_settingFrame && frame != m_frame) {
+        anchorAt(frame);
+        emit seeked(frame);
+    }
+}
+
+qint64 PlaybackEngine::clockMs()
+{
+    const qint64 now = m_wall.elapsed();
+    const qint64 audio = m_audioClock ? m_audioClock() : -1;
+
+    qint64 clock;
+    if (audio >= 0) {
+        // Audio positions arrive in steps; run on from the latest one, but
+        // not so far that a stalled output leaves the picture ahead
+        if (audio != m_lastAudioMs) {
+            m_lastAudioMs = audio;
+            m_anchorClockMs = audio;
+            m_anchorWallMs = now;
+        }
+        clock = m_anchorClockMs + qMin<qint64>(now - m_anchorWallMs, MaxExtrapolationMs);
+    } else {
+        if (m_lastAudioMs >= 0) {
+            // The audio stopped (clip ended): carry on from where it was
+            m_lastAudioMs = -1;
+            m_anchorClockMs = m_clockMs;
+            m_anchorWallMs = now;
+        }
+        clock = m_anchorClockMs + (now - m_anchorWallMs);
+    }
+
+    m_clockMs = qMax(m_clockMs, clock);
+    return m_clockMs;
+}
+
+void PlaybackEngine::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timerId) {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    const int fps = qMax(1, m_project->fps());
+    // Aim at the frame that will be due once it is on screen
+    const qint64 dueMs = clockMs() + qRound64(m_presentMs);
+    const int target = 1 + int(dueMs * fps / 1000);
+
+    if (target > m_project->highestUsedFrame()) {
+        stop();
+        emit finished();
+        return;
+    }
+
+    if (target > m_frame) {
+        // Frames between the last one shown and the due one are skipped
+        m_dropped += target - m_frame - 1;
+        m_frame = target;
+
+        QElapsedTimer cost;
+        cost.start();
+        m_settingFrame = true;
+        m_project->setCurrentFrame(target);
+        m_settingFrame = false;
+        // The canvas rebuilds its scene synchronously; smooth it so a
+        // single slow frame does not make the next ones jump
+        m_presentMs = m_presentMs * 0.8 + cost.nsecsElapsed() / 1e6 * 0.2;
+        ++m_shown;
+    }
+
+    const qint64 now = m_wall.elapsed();
+    if (now - m_statsWallMs >= StatsIntervalMs) {
+        m_fps = (m_shown - m_statsShown) * 1000.0 / (now - m_statsWallMs);
+        m_statsWallMs = now;
+        m_statsShown = m_shown;
+        emit statsChanged(m_fps, m_dropped);
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef PLAYBACKENGINE_H
+#define PLAYBACKENGINE_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <functional>
+
+class Project;
+
+/**
+ * @brief Advances the current frame during playback, following the audio
+ *
+ * The master clock is the audio output position whenever an audio clock is
+ * set and reports one; otherwise a wall clock stands in. Between audio
+ * position updates the clock runs on from the last reading, and it never
+ * goes backwards. On every tick the frame due at (clock + time it takes to
+ * show a frame) is shown; frames the canvas cannot deliver in time are
+ * skipped and counted rather than shown late.
+ */
+class PlaybackEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Milliseconds since frame 1 that the audio output has reached, or -1
+    // when no audio is playing
+    using AudioClock = std::function<qint64()>;
+
+    explicit PlaybackEngine(Project *project, QObject *parent = nullptr);
+
+    void setAudioClock(AudioClock clock) { m_audioClock = std::move(clock); }
+
+    void start();   // from the project's current frame
+    void stop();
+    bool isRunning() const { return m_timerId != -1; }
+
+    // Of the current (or last) run
+    int framesShown() const { return m_shown; }
+    int framesDropped() const { return m_dropped; }
+    double achievedFps() const;
+
+signals:
+    // About once a second while playing, and when playback stops
+    void statsChanged(double achievedFps, int framesDropped);
+    // The clock passed the last used frame
+    void finished();
+    // The playhead was moved by someone else; playback goes on from there
+    void seeked(int frame);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    void onFrameChanged(int frame);
+    void anchorAt(int frame);
+    qint64 clockMs();
+
+    static constexpr int TickMs = 5;
+    static constexpr int MaxExtrapolationMs = 250;   // audio stalled: visuals wait
+    static constexpr int StatsIntervalMs = 1000;
+
+    Project *m_project;
+    AudioClock m_audioClock;
+    int m_timerId = -1;
+    QElapsedTimer m_wall;
+
+    qint64 m_anchorClockMs = 0;   // clock value at m_anchorWallMs
+    qint64 m_anchorWallMs = 0;
+    qint64 m_lastAudioMs = -1;    // -1 = running on the wall clock
+    qint64 m_clockMs = 0;         // last value handed out
+
+    int m_frame = 1;              // last frame this engine showed
+    bool m_settingFrame = false;
+    double m_presentMs = 0;       // smoothed cost of showing a frame
+    int m_shown = 0;
+    int m_dropped = 0;
+    qint64 m_statsWallMs = 0;
+    int m_statsShown = 0;
+    double m_fps = 0;
+};
+
+#endif // PLAYBACKENGINE_H
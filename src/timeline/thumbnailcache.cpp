@@ -0,0 +1,117 @@
+#include "thumbnailcache.h"
+#include "core/layer.h"
+#include "core/project.h"
+#include "canvas/objects/vectorobject.h"
+#include "io/framerenderer.h"
+
+#include <QPainter>
+
+bool ThumbnailKey::operator==(const ThumbnailKey &other) const
+{
+    return layer == other.layer && frame == other.frame
+        && revision == other.revision && height == other.height;
+}
+
+size_t qHash(const ThumbnailKey &key, size_t seed)
+{
+    return qHashMulti(seed, key.layer, key.frame, key.revision, key.height);
+}
+
+ThumbnailCache::ThumbnailCache(Project *project, QObject *parent)
+    : QObject(parent)
+    , m_project(project)
+{
+    m_cache.setMaxCost(CacheKB);
+    // Background work: never more threads than it takes to keep up with
+    // scrolling, so exports and the canvas keep the cores
+    m_pool.setMaxThreadCount(MaxRunning);
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    m_pool.waitForDone();
+    for (const QList<VectorObject*> &clones : std::as_const(m_running))
+        qDeleteAll(clones);
+}
+
+void ThumbnailCache::clear()
+{
+    m_cache.clear();
+    m_pending.clear();
+    m_pendingIndex.clear();
+}
+
+QImage ThumbnailCache::thumbnail(Layer *layer, int keyFrame, int height)
+{
+    const ThumbnailKey key{layer, keyFrame, layer->frameRevision(keyFrame), height};
+    if (const QImage *image = m_cache.object(key))
+        return *image;
+
+    // Asked for again: to the front of the queue
+    auto queued = m_pendingIndex.constFind(key);
+    if (queued != m_pendingIndex.constEnd()) {
+        m_pending.splice(m_pending.begin(), m_pending, queued.value());
+    } else {
+        m_pending.push_front(key);
+        m_pendingIndex.insert(key, m_pending.begin());
+        if (m_pending.size() > size_t(MaxPending)) {
+            m_pendingIndex.remove(m_pending.back());
+            m_pending.pop_back();
+        }
+    }
+    renderNext();
+    return QImage();
+}
+
+void ThumbnailCache::renderNext()
+{
+    while (m_running.size() < MaxRunning && !m_pending.empty()) {
+        const ThumbnailKey key = m_pending.front();
+        m_pending.pop_front();
+        m_pendingIndex.remove(key);
+        // The layer may be gone, or the frame edited or emptied meanwhile
+        if (!m_project->layers().contains(key.layer)
+            || key.layer->frameRevision(key.frame) != key.revision
+            || !key.layer->isKeyFrame(key.frame)
+            || !key.layer->isFrameLoaded(key.frame))
+            continue;
+
+        // Painting works on clones, so the drawing can change while it runs
+        QList<VectorObject*> clones;
+        for (VectorObject *obj : key.layer->objectsAtFrame(key.frame)) {
+            VectorObject *clone = obj->clone();
+            clone->prepareForPaint();
+            clones.append(clone);
+        }
+
+        const int job = m_nextJob++;
+        m_running.insert(job, clones);
+        const QSize sceneSize(qMax(1, m_project->width()), qMax(1, m_project->height()));
+        m_pool.start([this, job, key, clones, sceneSize]() {
+            const qreal scale = qreal(key.height) / sceneSize.height();
+            QImage image(qMax(1, qRound(sceneSize.width() * scale)), key.height,
+                         QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::white);
+            QPainter painter(&image);
+            painter.setRenderHint(QPainter::Antialiasing);
+            painter.scale(scale, scale);
+            VectorObject::setDraftPaint(true);
+            for (VectorObject *obj : clones)
+                FrameRenderer::paintObject(&painter, obj);
+            VectorObject::setDraftPaint(false);
+            painter.end();
+            QMetaObject::invokeMethod(this, [this, job, key, image]() {
+                deliver(job, key, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void ThumbnailCache::deliver(int job, const ThumbnailKey &key, const QImage &image)
+{
+    // Clones are released here, on the GUI thread
+    qDeleteAll(m_running.take(job));
+    m_cache.insert(key, new QImage(image), qMax(1, int(image.sizeInBytes() / 1024)));
+    emit thumbnailReady(key.layer, key.frame);
+    renderNext();
+}
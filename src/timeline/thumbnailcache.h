@@ -0,0 +1,76 @@
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+#include <list>
+
+class Layer;
+class Project;
+class VectorObject;
+
+// One keyframe's drawing at one thumbnail height
+struct ThumbnailKey {
+    Layer *layer;
+    int frame;
+    quint64 revision;       // Layer::frameRevision(), so edits miss the cache
+    int height;             // device pixels
+    bool operator==(const ThumbnailKey &other) const;
+};
+size_t qHash(const ThumbnailKey &key, size_t seed = 0);
+
+/**
+ * @brief Small pictures of keyframes for the timeline, rendered in the background
+ *
+ * thumbnail() returns what is cached and queues the rest. Queued keyframes
+ * are cloned on the GUI thread and painted from the clones on a small
+ * thread pool, straight from the Layer model: the canvas is never asked
+ * to refresh. The most recently requested keyframes (the cells on screen)
+ * are rendered first, and the finished images sit in a bounded LRU cache.
+ *
+ * Keyframes still archived in the project file are skipped until
+ * something else has loaded them, so a thumbnail never decodes on the GUI
+ * thread.
+ */
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailCache(Project *project, QObject *parent = nullptr);
+    ~ThumbnailCache();   // waits for running renders
+
+    // The drawing of a keyframe scaled to the given height (device
+    // pixels), or a null image while it is being rendered
+    QImage thumbnail(Layer *layer, int keyFrame, int height);
+
+    // Forgets everything, e.g. when layers were added or removed
+    void clear();
+
+signals:
+    void thumbnailReady(Layer *layer, int keyFrame);
+
+private:
+    void renderNext();
+    void deliver(int job, const ThumbnailKey &key, const QImage &image);
+
+    static constexpr int CacheKB = 16 * 1024;
+    static constexpr int MaxPending = 512;
+    static constexpr int MaxRunning = 2;
+
+    Project *m_project;
+    QCache<ThumbnailKey, QImage> m_cache;     // cost in KB
+    // Most wanted first; a key asked for again is moved to the front in
+    // constant time, as every visible cell asks on every repaint
+    std::list<ThumbnailKey> m_pending;
+    QHash<ThumbnailKey, std::list<ThumbnailKey>::iterator> m_pendingIndex;
+    QThreadPool m_pool;
+    QHash<int, QList<VectorObject*>> m_running;   // clones being painted, by job
+    int m_nextJob = 0;
+};
+
+#endif // THUMBNAILCACHE_H
@@ -0,0 +1,60 @@
+#include "timelinerows.h"
+#include "core/project.h"
+#include "core/layer.h"
+
+#include <algorithm>
+
+TimelineRows::TimelineRows(Project *project, QObject *parent)
+    : QObject(parent)
+    , m_project(project)
+{
+    connect(project, &Project::layersChanged, this, &TimelineRows::rebuild);
+    rebuild();
+}
+
+int TimelineRows::rowAt(int y) const
+{
+    if (y < HeaderHeight || y >= m_totalHeight) return -1;
+    auto it = std::upper_bound(m_rows.cbegin(), m_rows.cend(), y,
+        [](int value, const Row &row) { return value < row.top; });
+    return int(it - m_rows.cbegin()) - 1;
+}
+
+void TimelineRows::setCollapsed(const QList<Layer*> &layers, bool collapsed)
+{
+    for (Layer *layer : layers) {
+        if (collapsed) m_collapsed.insert(layer);
+        else m_collapsed.remove(layer);
+    }
+    rebuild();
+}
+
+void TimelineRows::rebuild()
+{
+    const QList<Layer*> layers = m_project->layers();
+    // Layers that were removed are forgotten
+    for (auto it = m_collapsed.begin(); it != m_collapsed.end();) {
+        if (layers.contains(*it)) ++it;
+        else it = m_collapsed.erase(it);
+    }
+
+    m_rows.clear();
+    int top = HeaderHeight;
+    for (int i = layers.size() - 1; i >= 0; --i) {
+        Layer *layer = layers[i];
+        const bool collapsed = m_collapsed.contains(layer);
+        if (collapsed && !m_rows.isEmpty() && m_rows.last().collapsed) {
+            m_rows.last().layers.append(layer);
+            continue;
+        }
+        Row row;
+        row.layers.append(layer);
+        row.collapsed = collapsed;
+        row.top = top;
+        row.height = collapsed ? CollapsedRowHeight : RowHeight;
+        top += row.height;
+        m_rows.append(row);
+    }
+    m_totalHeight = top;
+    emit changed();
+}
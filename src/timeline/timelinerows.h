@@ -0,0 +1,61 @@
+#ifndef TIMELINEROWS_H
+#define TIMELINEROWS_H
+
+#include <QList>
+#include <QObject>
+#include <QSet>
+
+class Layer;
+class Project;
+
+/**
+ * @brief The timeline's rows: which layers they show and where they sit
+ *
+ * Layers are listed top layer first, one row each. A layer can be
+ * collapsed, and adjacent collapsed layers share a single short row, so a
+ * stack of finished layers takes the room of one. Row tops are kept as
+ * running sums: the row under a point is a binary search over the rows,
+ * independent of the project's length.
+ *
+ * The layer list and the frame grid lay out from the same TimelineRows,
+ * which keeps the two aligned.
+ */
+class TimelineRows : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Row {
+        QList<Layer*> layers;   // one layer, or a run of collapsed layers, top first
+        bool collapsed = false;
+        int top = 0;
+        int height = 0;
+    };
+
+    static constexpr int HeaderHeight = 32;
+    static constexpr int RowHeight = 36;
+    static constexpr int CollapsedRowHeight = 14;
+
+    explicit TimelineRows(Project *project, QObject *parent = nullptr);
+
+    const QList<Row> &rows() const { return m_rows; }
+    int totalHeight() const { return m_totalHeight; }   // header included
+    // Index of the row at y, -1 over the header or below the last row
+    int rowAt(int y) const;
+
+    bool isCollapsed(Layer *layer) const { return m_collapsed.contains(layer); }
+    void setCollapsed(const QList<Layer*> &layers, bool collapsed);
+
+signals:
+    void changed();
+
+private:
+    void rebuild();
+
+    Project *m_project;
+    QSet<Layer*> m_collapsed;
+    QList<Row> m_rows;
+    int m_totalHeight = HeaderHeight;
+};
+
+#endif // TIMELINEROWS_H
@@ -1,7 +1,13 @@
 #include "timelinewidget.h"
+#include "playbackengine.h"
+#include "audiomixer.h"
+#include "thumbnailcache.h"
 #include "core/project.h"
 #include "core/commands.h"
 #include "core/layer.h"
+#include "core/waveformpeaks.h"
+#include "io/midirenderjob.h"
+#include "io/pcmdecodejob.h"
 #include "utils/thememanager.h"
 
 #include <QEventLoop> // Added because github hates me
@@ -9,12 +15,14 @@
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QLabel>
-#include <QElapsedTimer>
 #include <QTimerEvent>
 #include <QSplitter>
 #include <QScrollArea>
 #include <QPainter>
 #include <QMouseEvent>
+#include <QWheelEvent>
+#include <QResizeEvent>
+#include <QSignalBlocker>
 #include <QMenu>
 #include <QScrollBar>
 #include <QAction>
@@ -22,72 +30,98 @@
 #include <QColorDialog>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QMediaPlayer>
-#include <QAudioOutput>
-#include <QAudioDecoder>
 #include <QSlider>
 #include <QTimer>
 #include <cmath>
-#include <QProcess>
-#include <QStandardPaths>
-#include <QSettings>
+#include <algorithm>
 #include <QFileInfo>
 #include <QDir>
 #include <QFile>
 #include <QSvgRenderer>
-#ifdef Q_OS_WIN
-#include <windows.h>
-#endif
 
 // --- Internal Helper: LayerListWidget ---
 class LayerListWidget : public QWidget {
 public:
-    LayerListWidget(Project *project, QWidget *parent = nullptr)
-        : QWidget(parent), m_project(project) {
+    LayerListWidget(Project *project, TimelineRows *rows, QWidget *parent = nullptr)
+        : QWidget(parent), m_project(project), m_rows(rows) {
         setMinimumWidth(200);
         setMaximumWidth(300);
         // Use sizeHint() for preferred size — do NOT call setMinimumHeight()
         // since that forces the parent dock widget to expand unboundedly.
         setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
 
-        connect(project, &Project::layersChanged, this, [this]() {
+        connect(rows, &TimelineRows::changed, this, [this]() {
             updateGeometry();
             update();
         });
+        connect(project, &Project::currentLayerChanged, this, QOverload<>::of(&QWidget::update));
     }
 
     QSize sizeHint() const override {
-        const int rowHeight = 36;
-        const int headerHeight = 32;
-        return QSize(220, headerHeight + m_project->layerCount() * rowHeight);
+        return QSize(220, m_rows->totalHeight());
     }
 
 protected:
     void paintEvent(QPaintEvent *event) override {
-        Q_UNUSED(event);
+        const QRect exposed = event->rect();
         QPainter painter(this);
-        painter.fillRect(rect(), theme().bg1Color());
+        painter.fillRect(exposed, theme().bg1Color());
 
         // Header
-        painter.fillRect(0, 0, width(), 32, theme().bg2Color());
+        const int headerHeight = TimelineRows::HeaderHeight;
+        painter.fillRect(0, 0, width(), headerHeight, theme().bg2Color());
         painter.setPen(Qt::white);
         painter.setFont(QFont("Arial", 9, QFont::Bold));
-        painter.drawText(rect().adjusted(12, 0, 0, -height() + 32), Qt::AlignLeft | Qt::AlignVCenter, "LAYERS");
-
-        int y = 32;
-        int rowHeight = 36;
-        auto layers = m_project->layers();
-
-        for (int i = layers.size() - 1; i >= 0; --i) {
-            Layer *layer = layers[i];
-            bool isCurrent = (m_project->currentLayer() == layer);
+        painter.drawText(rect().adjusted(12, 0, 0, -height() + headerHeight), Qt::AlignLeft | Qt::AlignVCenter, "LAYERS");
+
+        // Only the exposed rows are painted
+        const QList<TimelineRows::Row> &rows = m_rows->rows();
+        const int firstRow = qMax(0, m_rows->rowAt(qMax(exposed.top(), headerHeight)));
+        for (int r = firstRow; r < rows.size() && rows[r].top <= exposed.bottom(); ++r) {
+            const TimelineRows::Row &row = rows[r];
+            const int y = row.top;
+            const int rowHeight = row.height;
+            Layer *layer = row.layers.first();
+            bool isCurrent = row.layers.contains(m_project->currentLayer());
 
             QColor accent = theme().accentColor();
-            QColor bgColor = isCurrent ? QColor(accent.red(), accent.green(), accent.blue(), 35) : theme().bg1Color();
+            QColor bgColor = isCurrent ? QColor(accent.red(), accent.green(), accent.blue(), 35)
+                                       : row.collapsed ? theme().bg2Color() : theme().bg1Color();
             painter.fillRect(0, y, width(), rowHeight, bgColor);
 
+            // Disclosure arrow: collapses the layer, or expands the run
+            painter.setRenderHint(QPainter::Antialiasing);
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(QColor(150, 150, 150));
+            const int cy = y + rowHeight / 2;
+            QPolygon arrow;
+            if (row.collapsed)
+                arrow << QPoint(4, cy - 4) << QPoint(9, cy) << QPoint(4, cy + 4);
+            else
+                arrow << QPoint(3, cy - 2) << QPoint(11, cy - 2) << QPoint(7, cy + 3);
+            painter.drawPolygon(arrow);
+            painter.setRenderHint(QPainter::Antialiasing, false);
+
+            if (row.collapsed) {
+                // One thin colour strip per layer of the run
+                for (int i = 0; i < row.layers.size() && i < 8; ++i)
+                    painter.fillRect(14 + i * 4, y + 3, 3, rowHeight - 6, row.layers[i]->color());
+                painter.setPen(QColor(170, 170, 170));
+                painter.setFont(QFont("Arial", 8));
+                const QString text = row.layers.size() == 1
+                    ? layer->name()
+                    : QString("%1 + %2 more").arg(layer->name()).arg(row.layers.size() - 1);
+                const int textLeft = 18 + qMin(int(row.layers.size()), 8) * 4;
+                painter.drawText(QRect(textLeft, y, width() - textLeft - 8, rowHeight),
+                                 Qt::AlignLeft | Qt::AlignVCenter,
+                                 painter.fontMetrics().elidedText(text, Qt::ElideRight, width() - textLeft - 8));
+                painter.setPen(theme().bg0Color());
+                painter.drawLine(0, y + rowHeight - 1, width(), y + rowHeight - 1);
+                continue;
+            }
+
             // Color strip
-            painter.fillRect(8, y + 8, 4, rowHeight - 16, layer->color());
+            painter.fillRect(14, y + 8, 4, rowHeight - 16, layer->color());
 
             painter.setPen(layer->isVisible() ? QColor(220, 220, 220) : QColor(100, 100, 100));
             painter.setFont(QFont("Arial", 10));
@@ -102,100 +136,138 @@ protected:
                 layerText = " " + layerText;
             }
 
-            painter.drawText(QRect(20, y, width() - 80, rowHeight),
+            painter.drawText(QRect(26, y, width() - 86, rowHeight),
                              Qt::AlignLeft | Qt::AlignVCenter, layerText);
 
-            // Render visibility icon using SVG assets (white-tinted)
-            {
-                QString visRes = layer->isVisible() ? ":/icons/unhide.svg" : ":/icons/hide.svg";
-                QSvgRenderer visRenderer(visRes);
-                if (visRenderer.isValid()) {
-                    QPixmap visPx(16, 16);
-                    visPx.fill(Qt::transparent);
-                    QPainter svgP(&visPx);
-                    visRenderer.render(&svgP);
-                    svgP.setCompositionMode(QPainter::CompositionMode_SourceIn);
-                    QColor iconCol = layer->isVisible() ? QColor(200,200,200) : QColor(80,80,80);
-                    svgP.fillRect(visPx.rect(), iconCol);
-                    svgP.end();
-                    painter.drawPixmap(width() - 62, y + (rowHeight - 16) / 2, visPx);
-                }
-            }
-
-            // Render lock icon using SVG assets
-            {
-                QString lockRes = layer->isLocked() ? ":/icons/lock.svg" : ":/icons/unlock.svg";
-                QSvgRenderer lockRenderer(lockRes);
-                if (lockRenderer.isValid()) {
-                    QPixmap lockPx(14, 14);
-                    lockPx.fill(Qt::transparent);
-                    QPainter svgP(&lockPx);
-                    lockRenderer.render(&svgP);
-                    svgP.setCompositionMode(QPainter::CompositionMode_SourceIn);
-                    QColor lockCol = layer->isLocked() ? QColor(220, 160, 60) : QColor(60,60,60);
-                    svgP.fillRect(lockPx.rect(), lockCol);
-                    svgP.end();
-                    painter.drawPixmap(width() - 34, y + (rowHeight - 14) / 2, lockPx);
-                }
-            }
+            // Visibility and lock icons (white-tinted SVG assets)
+            painter.drawPixmap(width() - 62, y + (rowHeight - 16) / 2,
+                               icon(layer->isVisible() ? ":/icons/unhide.svg" : ":/icons/hide.svg", 16,
+                                    layer->isVisible() ? QColor(200,200,200) : QColor(80,80,80)));
+            painter.drawPixmap(width() - 34, y + (rowHeight - 14) / 2,
+                               icon(layer->isLocked() ? ":/icons/lock.svg" : ":/icons/unlock.svg", 14,
+                                    layer->isLocked() ? QColor(220, 160, 60) : QColor(60,60,60)));
 
             painter.setPen(theme().bg0Color());
             painter.drawLine(0, y + rowHeight - 1, width(), y + rowHeight - 1);
-            y += rowHeight;
         }
     }
 
     void mousePressEvent(QMouseEvent *event) override {
-        int y = event->pos().y();
-        if (y < 32) return;
-
-        int rowHeight = 36;
-        int index = (y - 32) / rowHeight;
-        int layerIndex = m_project->layers().size() - 1 - index;
+        const int r = m_rows->rowAt(event->pos().y());
+        if (r < 0) return;
+        const TimelineRows::Row &row = m_rows->rows()[r];
+
+        // A collapsed run has no controls of its own: a click opens it
+        if (row.collapsed || event->pos().x() < 14) {
+            const QList<Layer*> layers = row.layers;
+            m_rows->setCollapsed(layers, !row.collapsed);
+            return;
+        }
 
-        if (layerIndex >= 0 && layerIndex < m_project->layers().size()) {
-            if (event->pos().x() > width() - 65 && event->pos().x() < width() - 40) {
-                Layer *layer = m_project->layers()[layerIndex];
-                layer->setVisible(!layer->isVisible());
-                update();
-            } else {
-                m_project->setCurrentLayer(layerIndex);
-                update();
-            }
+        Layer *layer = row.layers.first();
+        if (event->pos().x() > width() - 65 && event->pos().x() < width() - 40) {
+            layer->setVisible(!layer->isVisible());
+            update();
+        } else {
+            m_project->setCurrentLayer(m_project->layers().indexOf(layer));
+            update();
         }
     }
 
 private:
+    // SVG icons are rasterised and tinted once, not on every repaint
+    QPixmap icon(const QString &resource, int size, const QColor &color) {
+        const QString key = QString("%1|%2|%3").arg(resource).arg(size).arg(color.name());
+        auto it = m_icons.constFind(key);
+        if (it != m_icons.constEnd())
+            return *it;
+
+        QPixmap px(size, size);
+        px.fill(Qt::transparent);
+        QSvgRenderer renderer(resource);
+        if (renderer.isValid()) {
+            QPainter svgP(&px);
+            renderer.render(&svgP);
+            svgP.setCompositionMode(QPainter::CompositionMode_SourceIn);
+            svgP.fillRect(px.rect(), color);
+        }
+        m_icons.insert(key, px);
+        return px;
+    }
+
     Project *m_project;
+    TimelineRows *m_rows;
+    QHash<QString, QPixmap> m_icons;
 };
 
 // --- FrameGridWidget Implementation ---
 
-FrameGridWidget::FrameGridWidget(Project *project, QWidget *parent)
+// The grid is painted from cached tiles: the ruler and each row are cut
+// into TilePx-wide pixmaps that are only redrawn when a layer of that row
+// changes (or the zoom does). Things that move while scrubbing
+// (current-frame column, onion skin, selection, playhead) are drawn over
+// the tiles every time.
+static constexpr int TilePx = 512;
+static constexpr int TileCacheKB = 48 * 1024;
+// Horizontal zoom as frames per pixel (frames / pixels): whole pixels per
+// frame when zoomed in, whole frames per pixel when zoomed out, so mapping
+// between frames and pixels is exact integer arithmetic
+struct ZoomLevel { int frames; int pixels; };
+static constexpr ZoomLevel ZoomLevels[] = {
+    {64, 1}, {32, 1}, {16, 1}, {8, 1}, {4, 1}, {2, 1}, {1, 1}, {1, 2}, {1, 3},
+    {1, 4}, {1, 6}, {1, 8}, {1, 12}, {1, 16}, {1, 24}, {1, 32}, {1, 48}
+};
+static constexpr int ZoomLevelCount = int(sizeof(ZoomLevels) / sizeof(ZoomLevels[0]));
+static constexpr int DefaultZoom = 13;   // 16 px per frame
+// Below this cell width keyframes lose their dots, colours and labels
+static constexpr int DetailCellPx = 12;
+// Piano-roll notes are pre-rendered per clip in strips of this width
+static constexpr int MidiStripSegmentPx = 1024;
+static constexpr int MidiStripCacheKB = 16 * 1024;
+
+FrameGridWidget::FrameGridWidget(Project *project, TimelineRows *rows, QWidget *parent)
     : QWidget(parent)
     , m_project(project)
+    , m_rows(rows)
     , m_onionFrames(2)
     , m_isDragging(false)
     , m_onionSkinEnabled(false)
+    , m_zoom(DefaultZoom)
 {
     setMinimumHeight(200);
-    connect(project, &Project::currentFrameChanged, this, QOverload<>::of(&QWidget::update));
-    connect(project, &Project::layersChanged,  this, QOverload<>::of(&QWidget::update));
-    connect(project, &Project::modified,       this, [this]() { updateGeometry(); adjustSize(); update(); });
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    m_tiles.setMaxCost(TileCacheKB);
+    m_midiStrips.setMaxCost(MidiStripCacheKB);
+    m_shownFrame = project->currentFrame();
+    // Scrubbing repaints just the old and new playhead columns
+    connect(project, &Project::currentFrameChanged, this, &FrameGridWidget::onCurrentFrameChanged);
+    connect(project, &Project::currentLayerChanged, this, QOverload<>::of(&QWidget::update));
+    connect(project, &Project::layersChanged,  this, &FrameGridWidget::invalidateTiles);
+    connect(project, &Project::modified,       this, [this]() { updateScrollBar(); update(); });
+    connect(rows, &TimelineRows::changed, this, [this]() { updateGeometry(); update(); });
 
     // Connect to each layer's modified signal so that frame extensions,
     // interpolations, and any other layer-level changes immediately repaint
-    // and resize the scroll area (Layer::modified ≠ Project::modified).
+    // and rescale the scroll bar (Layer::modified ≠ Project::modified).
     auto connectLayers = [this]() {
         for (Layer *layer : m_project->layers()) {
             // disconnect first to avoid double-connections on layersChanged
             disconnect(layer, &Layer::modified, this, nullptr);
-            connect(layer, &Layer::modified, this, [this]() {
-                updateGeometry();   // scroll area picks up new totalFrames()
-                adjustSize();       // actually resize the widget (needed when widgetResizable=false)
+            connect(layer, &Layer::modified, this, [this, layer]() {
+                // Only this layer's row tiles are redrawn
+                m_layerGeneration[layer] = ++m_generationCounter;
+                updateScrollBar();  // the bar picks up new totalFrames()
                 update();           // repaint the grid
+                loadMissingAudio(); // clips added elsewhere (File > Import Audio)
+            });
+            disconnect(layer, &Layer::audioPeaksChanged, this, nullptr);
+            connect(layer, &Layer::audioPeaksChanged, this, [this, layer]() {
+                m_layerGeneration[layer] = ++m_generationCounter;
+                update();
             });
         }
+        loadMissingAudio();
     };
     connectLayers();
     // Re-run whenever the layer list changes (add/remove/reorder)
@@ -203,12 +275,127 @@ FrameGridWidget::FrameGridWidget(Project *project, QWidget *parent)
 }
 
 QSize FrameGridWidget::sizeHint() const {
-    const int cellWidth    = 16;
-    const int rowHeight    = 36;
-    const int headerHeight = 32;
-    int h = headerHeight + m_project->layerCount() * rowHeight;
-    int w = m_project->totalFrames() * cellWidth;
-    return QSize(qMax(w, 400), qMax(h, headerHeight + rowHeight));
+    return QSize(400, qMax(m_rows->totalHeight(), TimelineRows::HeaderHeight + TimelineRows::RowHeight));
+}
+
+int FrameGridWidget::frameX(int frame) const {
+    const ZoomLevel &zoom = ZoomLevels[m_zoom];
+    return int(qint64(frame - 1) * zoom.pixels / zoom.frames);
+}
+
+int FrameGridWidget::frameAt(int x) const {
+    const ZoomLevel &zoom = ZoomLevels[m_zoom];
+    // Rounds towards minus infinity, so x < 0 is frame 0 or before
+    const qint64 scaled = qint64(x) * zoom.frames;
+    return int(scaled >= 0 ? scaled / zoom.pixels : (scaled - zoom.pixels + 1) / zoom.pixels) + 1;
+}
+
+double FrameGridWidget::pixelsPerFrame() const {
+    return double(ZoomLevels[m_zoom].pixels) / ZoomLevels[m_zoom].frames;
+}
+
+int FrameGridWidget::contentWidth() const {
+    return frameX(m_project->totalFrames() + 1);
+}
+
+void FrameGridWidget::setHorizontalScrollBar(QScrollBar *bar) {
+    m_hBar = bar;
+    connect(bar, &QScrollBar::valueChanged, this, &FrameGridWidget::setScrollX);
+    updateScrollBar();
+}
+
+void FrameGridWidget::updateScrollBar() {
+    if (m_hBar) {
+        // A shorter range must not move the view behind our back
+        const QSignalBlocker blocker(m_hBar);
+        m_hBar->setRange(0, qMax(0, contentWidth() - width()));
+        m_hBar->setPageStep(qMax(1, width()));
+        m_hBar->setSingleStep(qMax(16, qRound(pixelsPerFrame())));
+    }
+    setScrollX(m_scrollX);
+}
+
+void FrameGridWidget::setScrollX(int x) {
+    x = qBound(0, x, qMax(0, contentWidth() - width()));
+    if (m_hBar && m_hBar->value() != x)
+        m_hBar->setValue(x);   // comes back here with the same x
+    if (x == m_scrollX) return;
+    m_scrollX = x;
+    update();
+}
+
+void FrameGridWidget::setZoom(int level, int anchorX) {
+    level = qBound(0, level, ZoomLevelCount - 1);
+    if (level == m_zoom) return;
+    // The frame under anchorX (widget x) stays where it is
+    const double anchorFrame = (m_scrollX + anchorX) / pixelsPerFrame();
+    m_zoom = level;
+    m_scrollX = qRound(anchorFrame * pixelsPerFrame()) - anchorX;
+    updateScrollBar();   // clamps the new position
+    update();
+}
+
+void FrameGridWidget::wheelEvent(QWheelEvent *event) {
+    const QPoint delta = event->angleDelta();
+    if (event->modifiers() & Qt::ControlModifier) {
+        if (delta.y() != 0)
+            setZoom(m_zoom + (delta.y() > 0 ? 1 : -1), qRound(event->position().x()));
+        event->accept();
+    } else if ((event->modifiers() & Qt::ShiftModifier) || delta.x() != 0) {
+        // A notch scrolls a tenth of the view
+        const int notch = delta.x() != 0 ? delta.x() : delta.y();
+        setScrollX(m_scrollX - notch * qMax(1, width() / 10) / 120);
+        event->accept();
+    } else {
+        event->ignore();   // the outer scroll area scrolls the rows
+    }
+}
+
+void FrameGridWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    updateScrollBar();
+}
+
+void FrameGridWidget::setThumbnailsVisible(bool visible) {
+    if (visible == (m_thumbnails != nullptr)) return;
+    if (visible) {
+        m_thumbnails = new ThumbnailCache(m_project, this);
+        // Finished thumbnails are drawn over the cached tiles
+        connect(m_thumbnails, &ThumbnailCache::thumbnailReady, this, QOverload<>::of(&QWidget::update));
+        connect(m_project, &Project::layersChanged, m_thumbnails, &ThumbnailCache::clear);
+    } else {
+        delete m_thumbnails;
+        m_thumbnails = nullptr;
+    }
+    update();
+}
+
+void FrameGridWidget::paintThumbnails(QPainter &painter, Layer *layer, int y, int firstFrame, int lastFrame) {
+    const int rowHeight = TimelineRows::RowHeight;
+    const int thumbHeight = rowHeight - 10;
+    const int deviceHeight = qRound(thumbHeight * devicePixelRatioF());
+
+    // Each drawing is shown once, at its keyframe, across the cells that
+    // hold it; tween in-betweens keep their plain cells
+    for (int frame = firstFrame; frame <= lastFrame;) {
+        const int keyFrame = layer->isInterpolated(frame) ? -1 : layer->getKeyFrameFor(frame);
+        if (keyFrame == -1) {
+            ++frame;
+            continue;
+        }
+        const int holdEnd = qMax(keyFrame, layer->getExtensionEnd(keyFrame));
+        const QImage image = m_thumbnails->thumbnail(layer, keyFrame, deviceHeight);
+        if (!image.isNull()) {
+            const QRect cells(frameX(keyFrame) + 1, y + 5,
+                              frameX(holdEnd + 1) - frameX(keyFrame) - 2, thumbHeight);
+            const QSizeF size = image.size() / devicePixelRatioF();
+            painter.save();
+            painter.setClipRect(cells);
+            painter.drawImage(QRectF(cells.topLeft(), size), image);
+            painter.restore();
+        }
+        frame = holdEnd + 1;
+    }
 }
 
 void FrameGridWidget::setOnionSkin(bool enabled, int frames) {
@@ -217,186 +404,579 @@ void FrameGridWidget::setOnionSkin(bool enabled, int frames) {
     update();
 }
 
-void FrameGridWidget::paintEvent(QPaintEvent *event) {
-    Q_UNUSED(event);
-    QPainter painter(this);
+bool GridTileKey::operator==(const GridTileKey &other) const
+{
+    return layer == other.layer && span == other.span && tile == other.tile
+        && generation == other.generation && current == other.current;
+}
+
+size_t qHash(const GridTileKey &key, size_t seed)
+{
+    return qHashMulti(seed, key.layer, key.span, key.tile, key.generation, key.current);
+}
+
+bool FrameSelection::contains(int frame) const
+{
+    auto it = m_ranges.upperBound(frame);
+    return it != m_ranges.cbegin() && std::prev(it).value() >= frame;
+}
+
+void FrameSelection::select(int first, int last)
+{
+    // Ranges that overlap or touch [first, last] are merged into it
+    auto it = m_ranges.upperBound(first);
+    if (it != m_ranges.begin() && std::prev(it).value() >= first - 1)
+        --it;
+    while (it != m_ranges.end() && it.key() <= last + 1) {
+        first = qMin(first, it.key());
+        last = qMax(last, it.value());
+        it = m_ranges.erase(it);
+    }
+    m_ranges.insert(first, last);
+}
+
+void FrameSelection::toggle(int frame)
+{
+    auto it = m_ranges.upperBound(frame);
+    if (it == m_ranges.begin() || std::prev(it).value() < frame) {
+        select(frame, frame);
+        return;
+    }
+    // Split the range around the frame
+    --it;
+    const int first = it.key();
+    const int last = it.value();
+    m_ranges.erase(it);
+    if (first < frame) m_ranges.insert(first, frame - 1);
+    if (frame < last) m_ranges.insert(frame + 1, last);
+}
+
+void FrameSelection::shift(int delta)
+{
+    QMap<int, int> shifted;
+    for (auto it = m_ranges.cbegin(); it != m_ranges.cend(); ++it)
+        shifted.insert(it.key() + delta, it.value() + delta);
+    m_ranges = shifted;
+}
+
+QSet<int> FrameSelection::frames() const
+{
+    QSet<int> frames;
+    for (auto it = m_ranges.cbegin(); it != m_ranges.cend(); ++it) {
+        for (int f = it.key(); f <= it.value(); ++f)
+            frames.insert(f);
+    }
+    return frames;
+}
+
+void FrameGridWidget::invalidateTiles() {
+    m_tiles.clear();
+    m_layerGeneration.clear();
+    update();
+}
+
+void FrameGridWidget::updateFrameColumns(int first, int last) {
+    // The playhead triangle reaches a few pixels past its cell
+    const int left = frameX(first) - m_scrollX;
+    update(QRect(left - 6, 0, frameX(last + 1) - frameX(first) + 12, height()));
+}
+
+void FrameGridWidget::onCurrentFrameChanged(int frame) {
+    const int reach = m_onionSkinEnabled ? m_onionFrames : 0;
+    updateFrameColumns(m_shownFrame - reach, m_shownFrame + reach);
+    updateFrameColumns(frame - reach, frame + reach);
+    m_shownFrame = frame;
+
+    // A playhead leaving the view (playback, frame stepping) takes the view
+    // along, a page at a time
+    const int x = frameX(frame);
+    if (x < m_scrollX || x >= m_scrollX + width())
+        setScrollX(x - width() / 10);
+}
+
+QPixmap FrameGridWidget::tile(const TimelineRows::Row *row, int index) {
+    // A collapsed run is as new as its most recently changed layer
+    quint64 generation = 0;
+    if (row) {
+        for (Layer *layer : row->layers)
+            generation = qMax(generation, m_layerGeneration.value(layer));
+    }
+    const GridTileKey key{ row ? row->layers.first() : nullptr,
+                           row && row->collapsed ? int(row->layers.size()) : 0,
+                           index, generation,
+                           row && row->layers.contains(m_project->currentLayer()) };
+    if (const QPixmap *cached = m_tiles.object(key))
+        return *cached;
+
+    const qreal dpr = devicePixelRatioF();
+    const QSize size(TilePx, row ? row->height : TimelineRows::HeaderHeight);
+    QPixmap *pixmap = new QPixmap(size * dpr);
+    pixmap->setDevicePixelRatio(dpr);
+
+    QPainter painter(pixmap);
     painter.setRenderHint(QPainter::Antialiasing);
-    painter.fillRect(rect(), theme().bg0Color());
+    const int firstFrame = frameAt(index * TilePx);
+    const int lastFrame = frameAt((index + 1) * TilePx - 1);
+    // Tile painters work in content coordinates, clipped to the tile
+    painter.translate(-index * TilePx, 0);
+    if (row && row->collapsed)
+        paintCollapsedRowTile(painter, row->layers, firstFrame, lastFrame, key.current);
+    else if (row)
+        paintRowTile(painter, row->layers.first(), firstFrame, lastFrame, key.current);
+    else
+        paintRulerTile(painter, firstFrame, lastFrame);
+    painter.end();
+
+    const QPixmap result = *pixmap;
+    m_tiles.insert(key, pixmap, qMax(1, int(size.width() * size.height() * dpr * dpr * 4 / 1024)));
+    return result;
+}
 
-    const int cellWidth = 16;
-    const int rowHeight = 36;
-    const int headerHeight = 32;
+// Smallest step of 1, 2, 5, 10, 20, 50, ... frames that is at least
+// minPx pixels wide, so ticks and labels thin out as the view zooms out
+static int rulerStep(double pixelsPerFrame, int minPx)
+{
+    for (int step = 1;; step *= 10) {
+        for (int m : {1, 2, 5}) {
+            if (step * m * pixelsPerFrame >= minPx || step * m >= 100000000)
+                return step * m;
+        }
+    }
+}
 
-    // Header / ruler
-    painter.fillRect(0, 0, width(), headerHeight, theme().bg2Color());
+void FrameGridWidget::paintRulerTile(QPainter &painter, int firstFrame, int lastFrame) {
+    const int headerHeight = TimelineRows::HeaderHeight;
+    const int tickStep = rulerStep(pixelsPerFrame(), 4);
+    const int labelStep = rulerStep(pixelsPerFrame(), 48);
+    const int last = qMin(lastFrame, m_project->totalFrames());
 
-    for (int frame = 1; frame <= m_project->totalFrames() && (frame - 1) * cellWidth < width(); ++frame) {
-        int x = (frame - 1) * cellWidth;
+    painter.fillRect(frameX(firstFrame), 0, frameX(lastFrame + 1) - frameX(firstFrame), headerHeight,
+                     theme().bg2Color());
+    for (int frame = (firstFrame + tickStep - 1) / tickStep * tickStep; frame <= last; frame += tickStep) {
+        int x = frameX(frame);
         painter.setPen(theme().bg1Color());
-        painter.drawLine(x, 0, x, height());
-
-        if (frame % 5 == 0) {
-            painter.setPen(QColor(180, 180, 180));
-            painter.setFont(QFont("Arial", 8));
-            painter.drawText(QRect(x + 2, 0, cellWidth * 5, headerHeight - 4),
-                             Qt::AlignLeft | Qt::AlignBottom, QString::number(frame));
-            painter.setPen(QPen(QColor(130, 130, 130), 1));
-            painter.drawLine(x, headerHeight - 8, x, headerHeight);
-        } else {
-            painter.setPen(QPen(QColor(70, 70, 70), 1));
-            painter.drawLine(x, headerHeight - 4, x, headerHeight);
+        painter.drawLine(x, 0, x, headerHeight);
+        painter.setPen(QPen(QColor(70, 70, 70), 1));
+        painter.drawLine(x, headerHeight - 4, x, headerHeight);
+    }
+
+    // Numbers overhang into the next tile, so the previous label is drawn too
+    painter.setFont(QFont("Arial", 8));
+    const int firstLabel = qMax(labelStep, (firstFrame - labelStep) / labelStep * labelStep);
+    for (int frame = firstLabel; frame <= last; frame += labelStep) {
+        int x = frameX(frame);
+        painter.setPen(QColor(180, 180, 180));
+        painter.drawText(QRect(x + 2, 0, frameX(frame + labelStep) - x, headerHeight - 4),
+                         Qt::AlignLeft | Qt::AlignBottom, QString::number(frame));
+        painter.setPen(QPen(QColor(130, 130, 130), 1));
+        painter.drawLine(x, headerHeight - 8, x, headerHeight);
+    }
+}
+
+QPixmap FrameGridWidget::midiStripSegment(const AudioData &audio, int widthPx, int height, int segment) {
+    // Keyed by the clip's notes, its pixel size (zoom and duration) and the
+    // segment, so moving the clip or retiling does not redraw the notes
+    const qreal dpr = devicePixelRatioF();
+    const QString key = QString("%1|%2|%3|%4|%5|%6|%7").arg(audio.filePath)
+                            .arg(audio.midiNotes.size()).arg(audio.midiTotalBeats)
+                            .arg(widthPx).arg(height).arg(dpr).arg(segment);
+    if (const QPixmap *cached = m_midiStrips.object(key))
+        return *cached;
+
+    QPixmap *strip = new QPixmap(QSize(MidiStripSegmentPx, qMax(1, height)) * dpr);
+    strip->setDevicePixelRatio(dpr);
+    strip->fill(Qt::transparent);
+
+    QPainter painter(strip);
+    const int pitchRange = qMax(1, audio.midiMaxPitch - audio.midiMinPitch);
+    const double totalBeats = audio.midiTotalBeats > 0 ? audio.midiTotalBeats : 1.0;
+    const double pxPerBeat = widthPx / totalBeats;
+    const int segmentLeft = segment * MidiStripSegmentPx;
+    const int nh = qMax(1, height / qMax(1, pitchRange + 1));
+
+    // Notes are sorted by start: skip to the first one that can still
+    // reach this segment, stop at the first that starts after it
+    const double firstBeat = segmentLeft / pxPerBeat - audio.midiMaxNoteBeats;
+    const double lastBeat = (segmentLeft + MidiStripSegmentPx) / pxPerBeat;
+    auto it = std::lower_bound(audio.midiNotes.cbegin(), audio.midiNotes.cend(), firstBeat,
+        [](const MidiNote &n, double beat) { return n.startBeat < beat; });
+    for (; it != audio.midiNotes.cend() && it->startBeat <= lastBeat; ++it) {
+        const MidiNote &n = *it;
+        // X position: beat → pixel within the clip, then within the segment
+        int nx = (int)(n.startBeat * pxPerBeat) - segmentLeft;
+        int nw = qMax(2, (int)(n.durationBeat * pxPerBeat));
+        // Y position: higher pitch = higher on screen
+        int ny = height - 1 - (int)(((double)(n.pitch - audio.midiMinPitch) / pitchRange) * (height - 2));
+
+        // Color by channel
+        static const QColor chanColors[] = {
+            {220,180,255},{180,220,255},{255,220,180},{180,255,220},
+            {255,180,220},{220,255,180},{200,200,255},{255,200,200}
+        };
+        QColor nc = chanColors[n.channel % 8];
+        nc.setAlpha(160 + n.velocity);
+        painter.fillRect(nx, ny, nw, nh, nc);
+    }
+    painter.end();
+
+    const QPixmap result = *strip;
+    m_midiStrips.insert(key, strip, qMax(1, int(MidiStripSegmentPx * height * dpr * dpr * 4 / 1024)));
+    return result;
+}
+
+void FrameGridWidget::paintRowTile(QPainter &painter, Layer *layer, int firstFrame, int lastFrame,
+                                   bool current) {
+    // Zoomed out, a frame may be narrower than a pixel: cells are drawn
+    // at least one pixel wide
+    const int cellWidth = qMax(1, int(pixelsPerFrame()));
+    const bool detailed = cellWidth >= DetailCellPx;
+    const int rowHeight = TimelineRows::RowHeight;
+    const int y = 0;
+    const int tileLeft = frameX(firstFrame);
+    const int tileRight = frameX(lastFrame + 1);
+
+    painter.fillRect(tileLeft, y, tileRight - tileLeft, rowHeight, theme().bg1Color());
+
+    // Highlight active layer row
+    if (current) {
+        QColor acc = theme().accentColor();
+        painter.fillRect(tileLeft, y, tileRight - tileLeft, rowHeight,
+                         QColor(acc.red(), acc.green(), acc.blue(), 20));
+    }
+
+    // AUDIO LAYER RENDERING — multi-clip
+    if (layer->layerType() == LayerType::Audio && layer->hasAudio()) {
+        const auto &clips = layer->audioClips();
+        // Stagger clip rows so overlapping clips are visible
+        int clipRowH = qMax(8, (rowHeight - 8) / qMax(1, clips.size()));
+
+        for (int ci = 0; ci < clips.size(); ++ci) {
+            const AudioData &audio = clips[ci];
+
+            // For -1 duration show an "infinite" bar (until end of timeline)
+            int effDuration = audio.durationFrames > 0
+                ? audio.durationFrames
+                : (m_project->totalFrames() - audio.startFrame + 1);
+
+            int startX = frameX(audio.startFrame);
+            int widthPx = qMax(cellWidth, frameX(audio.startFrame + effDuration) - startX);
+            if (startX >= tileRight || startX + widthPx <= tileLeft)
+                continue;
+            int clipY = y + 4 + ci * (clipRowH + 2);
+            // Pixel range of the clip inside this tile
+            const int fromPx = qMax(0, tileLeft - startX);
+            const int toPx = qMin(widthPx, tileRight - startX);
+
+            QRect audioRect(startX, clipY, widthPx, clipRowH);
+
+            QColor clipColor = audio.isMidi
+                ? QColor(138, 43, 226)          // purple for MIDI
+                : (audio.muted ? QColor(90,90,90) : QColor(39, 174, 96));
+            // MIDI still rendering: dimmed until its WAV is ready
+            const bool pending = isRenderPending(audio);
+            if (pending) clipColor = clipColor.darker(160);
+
+            painter.setBrush(clipColor);
+            painter.setPen(clipColor.darker(150));
+            painter.drawRoundedRect(audioRect, 3, 3);
+
+            // Waveform / MIDI indicator
+            int centerY = clipY + clipRowH / 2;
+            if (audio.isMidi && !audio.midiNotes.isEmpty()) {
+                // Piano-roll: pre-rendered note strips, only the segments
+                // this tile overlaps
+                const int firstSegment = fromPx / MidiStripSegmentPx;
+                const int lastSegment = (toPx - 1) / MidiStripSegmentPx;
+                for (int seg = firstSegment; seg <= lastSegment; ++seg) {
+                    painter.drawPixmap(startX + seg * MidiStripSegmentPx, clipY + 3,
+                                       midiStripSegment(audio, widthPx, clipRowH - 6, seg));
+                }
+            } else if (audio.isMidi) {
+                // No parsed notes yet — simple placeholder bars
+                painter.setPen(QColor(220, 180, 255, 120));
+                for (int wx = startX + 4 + qMax(0, (fromPx - 4) / 10 * 10);
+                     wx < startX + widthPx - 4 && wx < tileRight; wx += 10)
+                    painter.fillRect(wx, clipY+3, 4, clipRowH-6, QColor(220,180,255,100));
+            } else if (audio.peaks) {
+                // One min/max line per pixel, RMS drawn darker inside it,
+                // read from the pyramid level matching the zoom
+                const WaveformPeaks &peaks = *audio.peaks;
+                const int fps = m_project->fps() > 0 ? m_project->fps() : 24;
+                const double samplesPerPixel = double(peaks.sampleRate()) / (fps * pixelsPerFrame());
+                const int level = peaks.levelFor(samplesPerPixel);
+                const int halfHeight = clipRowH / 2 - 2;
+                const QColor peakColor(20, 60, 20, 200);
+                const QColor rmsColor(10, 35, 10, 230);
+                for (int px = fromPx; px < toPx; px++) {
+                    const qint64 first = qint64(px * samplesPerPixel);
+                    if (first >= peaks.frameCount()) break;
+                    const qint64 last = qint64((px + 1) * samplesPerPixel);
+                    const PeakBucket p = peaks.peak(level, -1, first, last);
+                    const int top = centerY - qRound(qBound(-1.0f, p.max, 1.0f) * halfHeight);
+                    const int bottom = centerY - qRound(qBound(-1.0f, p.min, 1.0f) * halfHeight);
+                    painter.setPen(peakColor);
+                    painter.drawLine(startX + px, top, startX + px, bottom);
+                    const int rms = qRound(qMin(p.rms, 1.0f) * halfHeight);
+                    painter.setPen(rmsColor);
+                    painter.drawLine(startX + px, centerY - rms, startX + px, centerY + rms);
+                }
+            } else {
+                painter.setPen(QColor(20, 60, 20, 150));
+                for (int wx = startX + fromPx / 2 * 2; wx < startX + toPx; wx += 2) {
+                    int wh = 2 + (int)(std::sin(wx * 0.1) * std::cos(wx * 0.05) * (clipRowH/4));
+                    painter.drawLine(wx, centerY - wh, wx, centerY + wh);
+                }
+            }
+
+            // Clip label
+            painter.setPen(Qt::white);
+            QFont lf; lf.setPointSize(6); painter.setFont(lf);
+            QString label = QFileInfo(audio.filePath).baseName();
+            if (audio.isMidi) label = "🎹 " + label;
+            if (pending) label += "  (rendering…)";
+            else if (audio.isMidi && m_midiFailed.contains(audio.filePath)) label += "  (silent)";
+            painter.drawText(audioRect.adjusted(4, 0, -2, 0),
+                             Qt::AlignVCenter | Qt::AlignLeft,
+                             painter.fontMetrics().elidedText(label, Qt::ElideRight, widthPx - 8));
         }
+        return;
     }
 
-    // Shift/Ctrl multi-selection highlight (header row)
-    painter.setPen(Qt::NoPen);
-    for (int f : std::as_const(m_selectedFrames)) {
-        int sx = (f - 1) * cellWidth;
+    // === FRAME RENDERING WITH INTERPOLATION AS CONTINUOUS BAR ===
+    // Walks the keyframes rather than every frame; a bar that starts in an
+    // earlier tile is still drawn (clipped) here
+    QList<int> keyFrames = layer->allFrameNumbers();
+    std::sort(keyFrames.begin(), keyFrames.end());
+    int coveredUntil = 0;   // keyframes inside a drawn bar are part of it
+    for (int frame : std::as_const(keyFrames)) {
+        if (frame > lastFrame || frame > m_project->totalFrames()) break;
+        if (frame <= coveredUntil) continue;
+
+        int x = frameX(frame);
+        QRect cellRect(x, y, cellWidth, rowHeight);
+
+        // Check for interpolation first
+        FrameInterpolation interp = layer->getInterpolationFor(frame);
+        if (interp.startFrame == frame && interp.endFrame > frame) {
+            coveredUntil = interp.endFrame;
+            if (interp.endFrame < firstFrame) continue;
+
+            // === INTERPOLATION BAR (Purple continuous bar) ===
+            int interpWidth = qMax(cellWidth, frameX(interp.endFrame + 1) - x);
+            QRect interpRect(x, y + 8, interpWidth, rowHeight - 16);
+
+            QColor purple(138, 43, 226);
+            painter.setBrush(purple);
+            painter.setPen(QPen(purple.darker(130), 1));
+            painter.drawRoundedRect(interpRect, 6, 6);
+            if (interpWidth < 2 * DetailCellPx) continue;
+
+            // Start keyframe dot
+            painter.setBrush(Qt::white);
+            painter.setPen(Qt::NoPen);
+            painter.drawEllipse(x + 4, y + rowHeight / 2 - 3, 6, 6);
+
+            // End keyframe dot
+            painter.drawEllipse(x + interpWidth - 10, y + rowHeight / 2 - 3, 6, 6);
+            continue;
+        }
 
-        if (m_frameDragActive) {
-            int offset = m_dragCurrentX - m_dragStartX;
-            sx = sx + offset;
-        } else if (m_frameDragBuffer != 0) {
-            sx = (m_frameDragBuffer - 1) * cellWidth;
+        // Check if this keyframe has extension
+        int extendEnd = layer->getExtensionEnd(frame);
+        if (extendEnd > frame) {
+            coveredUntil = extendEnd;
+            if (extendEnd < firstFrame) continue;
+
+            // === EXTENDED FRAME (Orange bar) ===
+            int extendWidth = qMax(cellWidth, frameX(extendEnd + 1) - x);
+            QRect extendRect(x, y + 8, extendWidth, rowHeight - 16);
+
+            QColor orange(255, 165, 0);
+            painter.setBrush(orange);
+            painter.setPen(QPen(orange.darker(130), 1));
+            painter.drawRoundedRect(extendRect, 6, 6);
+            if (extendWidth < 2 * DetailCellPx) continue;
+
+            // Start dot
+            painter.setBrush(Qt::white);
+            painter.setPen(Qt::NoPen);
+            painter.drawEllipse(x + 4, y + rowHeight / 2 - 3, 6, 6);
+
+            // End dot
+            painter.setBrush(QColor(230, 120, 20));
+            painter.drawEllipse(x + extendWidth - 10, y + rowHeight / 2 - 3, 6, 6);
+            continue;
+        }
+
+        if (frame < firstFrame) continue;
+
+        // Too narrow for the details: a plain bar
+        if (!detailed) {
+            painter.fillRect(x, y + 8, cellWidth, rowHeight - 16,
+                             layer->isMotionPathFrame(frame) ? QColor(139, 92, 246) : theme().accentColor());
+            continue;
+        }
+
+        // === STANDARD KEYFRAME (Red/accent) or MOTION PATH (Purple) ===
+        if (layer->isMotionPathFrame(frame)) {
+            // Motion-path generated frame — render purple
+            QColor motionPurple(139, 92, 246);
+            painter.setBrush(motionPurple);
+            painter.setPen(motionPurple.lighter(130));
+            painter.drawRoundedRect(cellRect.adjusted(2, 8, -2, -8), 4, 4);
+
+            painter.setBrush(Qt::white);
+            painter.setPen(Qt::NoPen);
+            painter.drawEllipse(x + cellWidth / 2 - 2, y + rowHeight / 2 - 2, 4, 4);
+        } else {
+            // Standard keyframe
+            QColor keyRed = theme().accentColor();
+            painter.setBrush(keyRed);
+            painter.setPen(keyRed.lighter(130));
+            painter.drawRoundedRect(cellRect.adjusted(2, 8, -2, -8), 4, 4);
+
+            painter.setBrush(Qt::white);
+            painter.setPen(Qt::NoPen);
+            painter.drawEllipse(x + cellWidth / 2 - 2, y + rowHeight / 2 - 2, 4, 4);
         }
 
-        painter.fillRect(sx, 1, cellWidth - 1, headerHeight - 2, QColor(0, 120, 215, 150));
+        // ── Per-frame colour dot (top-right corner of cell) ───────
+        QColor fc = layer->frameColor(frame);
+        if (fc.isValid()) {
+            painter.setBrush(fc);
+            painter.setPen(QPen(fc.darker(160), 0.5));
+            painter.drawEllipse(x + cellWidth - 9, y + 3, 6, 6);
+        }
+
+        // ── Per-frame label text (bottom of cell) ─────────────────
+        QString fl = layer->frameLabel(frame);
+        if (!fl.isEmpty()) {
+            painter.setPen(QColor(220, 220, 220, 210));
+            painter.setFont(QFont("Arial", 7));
+            painter.drawText(QRect(x + 2, y + rowHeight - 11, cellWidth - 4, 10),
+                             Qt::AlignLeft | Qt::AlignVCenter, fl);
+        }
     }
+}
 
-    // Preview of frames being dragged
-    if (!m_selectedFrames.isEmpty() && m_frameDragActive) {
-        int dragOffsetPx = m_dragCurrentX - m_dragStartX;
-        bool isOutOfBounds = false;
+void FrameGridWidget::paintCollapsedRowTile(QPainter &painter, const QList<Layer*> &layers,
+                                            int firstFrame, int lastFrame, bool current) {
+    const int rowHeight = TimelineRows::CollapsedRowHeight;
+    const int tileLeft = frameX(firstFrame);
+    const int tileRight = frameX(lastFrame + 1);
+
+    painter.fillRect(tileLeft, 0, tileRight - tileLeft, rowHeight, theme().bg2Color());
+    if (current) {
+        QColor acc = theme().accentColor();
+        painter.fillRect(tileLeft, 0, tileRight - tileLeft, rowHeight,
+                         QColor(acc.red(), acc.green(), acc.blue(), 20));
+    }
 
-        // Check if any frame would be out of bounds
-        for (int f : m_selectedFrames) {
-            int newFrame = f + (dragOffsetPx / cellWidth);
-            if (newFrame < 1 || newFrame > m_project->totalFrames()) {
-                isOutOfBounds = true;
-                break;
+    // A summary of the run: every drawing (keyframe through its hold or
+    // tween) and every audio clip as a thin bar in its layer's colour
+    auto drawSpan = [&](int first, int last, const QColor &color) {
+        if (last < firstFrame || first > lastFrame) return;
+        const int x = frameX(first);
+        painter.fillRect(x, 3, qMax(1, frameX(last + 1) - x - 1), rowHeight - 6, color);
+    };
+    for (Layer *layer : layers) {
+        QColor color = layer->color();
+        color.setAlpha(170);
+
+        if (layer->layerType() == LayerType::Audio) {
+            for (const AudioData &clip : layer->audioClips()) {
+                const int end = clip.durationFrames > 0 ? clip.startFrame + clip.durationFrames - 1
+                                                        : m_project->totalFrames();
+                drawSpan(clip.startFrame, end, color);
             }
+            continue;
         }
 
-        // Draw preview of dragged frames
-        for (int f : m_selectedFrames) {
-            int sx = (f - 1) * cellWidth + dragOffsetPx;
-            QColor previewColor = isOutOfBounds ? QColor(215, 0, 0, 100) : QColor(0, 120, 215, 100);
-            painter.fillRect(sx, headerHeight, cellWidth, height() - headerHeight, previewColor);
+        QList<int> keyFrames = layer->allFrameNumbers();
+        std::sort(keyFrames.begin(), keyFrames.end());
+        // Only a hold or tween from the last keyframe before the tile can
+        // reach into it
+        auto it = std::lower_bound(keyFrames.cbegin(), keyFrames.cend(), firstFrame);
+        if (it != keyFrames.cbegin()) --it;
+        for (; it != keyFrames.cend() && *it <= lastFrame; ++it) {
+            int end = qMax(*it, layer->getExtensionEnd(*it));
+            const FrameInterpolation interp = layer->getInterpolationFor(*it);
+            if (interp.startFrame == *it)
+                end = qMax(end, interp.endFrame);
+            drawSpan(*it, qMin(end, m_project->totalFrames()), color);
         }
     }
+}
 
-    // Grid Content
-    auto layers = m_project->layers();
-    int currentFrame = m_project->currentFrame();
+void FrameGridWidget::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(event->rect(), theme().bg0Color());
+    // From here on everything is in content coordinates
+    painter.translate(-m_scrollX, 0);
+    const QRect exposed = event->rect().translated(m_scrollX, 0);
+
+    const int cellWidth = qMax(1, int(pixelsPerFrame()));
+    const int rowHeight = TimelineRows::RowHeight;
+    const int headerHeight = TimelineRows::HeaderHeight;
+
+    // Infinite audio clips and the ruler depend on the project length
+    if (m_project->totalFrames() != m_tileFrameCount || devicePixelRatioF() != m_tileDpr
+        || m_zoom != m_tileZoom) {
+        m_tiles.clear();
+        m_tileFrameCount = m_project->totalFrames();
+        m_tileDpr = devicePixelRatioF();
+        m_tileZoom = m_zoom;
+    }
 
-    for (int i = layers.size() - 1; i >= 0; --i) {
-        Layer *layer = layers[i];
-        int y = headerHeight + (layers.size() - 1 - i) * rowHeight;
+    // Only the exposed frames and rows are looked at
+    const QList<TimelineRows::Row> &rows = m_rows->rows();
+    int currentFrame = m_project->currentFrame();
+    const int firstFrame = qMax(1, frameAt(exposed.left()));
+    const int lastFrame = qMin(m_project->totalFrames(), frameAt(exposed.right()));
+    const int firstTile = frameX(firstFrame) / TilePx;
+    const int lastTile = (frameX(lastFrame + 1) - 1) / TilePx;
+    const int firstRow = m_rows->rowAt(qMax(exposed.top(), headerHeight));
+    const int rowsBottom = m_rows->totalHeight();
 
-        painter.fillRect(0, y, width(), rowHeight, theme().bg1Color());
+    // Header / ruler
+    if (exposed.top() < headerHeight) {
+        painter.fillRect(exposed.left(), 0, exposed.width(), headerHeight, theme().bg2Color());
+        for (int t = firstTile; t <= lastTile; ++t)
+            painter.drawPixmap(t * TilePx, 0, tile(nullptr, t));
+    }
 
-        // Highlight active layer row
-        if (layer == m_project->currentLayer()) {
-            QColor acc = theme().accentColor();
-            painter.fillRect(0, y, width(), rowHeight, QColor(acc.red(), acc.green(), acc.blue(), 20));
+    // Frame lines show through below the last row
+    if (exposed.bottom() >= rowsBottom) {
+        painter.setPen(theme().bg1Color());
+        const int step = rulerStep(pixelsPerFrame(), 4);
+        for (int frame = (firstFrame + step - 1) / step * step; frame <= lastFrame; frame += step) {
+            int x = frameX(frame);
+            painter.drawLine(x, rowsBottom, x, height());
         }
+    }
 
-        // AUDIO LAYER RENDERING — multi-clip
-        if (layer->layerType() == LayerType::Audio && layer->hasAudio()) {
-            const auto &clips = layer->audioClips();
-            // Stagger clip rows so overlapping clips are visible
-            int clipRowH = qMax(8, (rowHeight - 8) / qMax(1, clips.size()));
-
-            for (int ci = 0; ci < clips.size(); ++ci) {
-                const AudioData &audio = clips[ci];
-
-                // For -1 duration show an "infinite" bar (until end of timeline)
-                int effDuration = audio.durationFrames > 0
-                    ? audio.durationFrames
-                    : (m_project->totalFrames() - audio.startFrame + 1);
-
-                int startX = (audio.startFrame - 1) * cellWidth;
-                int widthPx = qMax(cellWidth, effDuration * cellWidth);
-                int clipY = y + 4 + ci * (clipRowH + 2);
-
-                QRect audioRect(startX, clipY, widthPx, clipRowH);
-
-                QColor clipColor = audio.isMidi
-                    ? QColor(138, 43, 226)          // purple for MIDI
-                    : (audio.muted ? QColor(90,90,90) : QColor(39, 174, 96));
-
-                painter.setBrush(clipColor);
-                painter.setPen(clipColor.darker(150));
-                painter.drawRoundedRect(audioRect, 3, 3);
-
-                // Waveform / MIDI indicator
-                int centerY = clipY + clipRowH / 2;
-                if (audio.isMidi && !audio.midiNotes.isEmpty()) {
-                    // Piano-roll: horizontal bars, pitch → Y, time → X
-                    // Find pitch range for this clip
-                    int minPitch = 127, maxPitch = 0;
-                    for (const MidiNote &n : audio.midiNotes) {
-                        minPitch = qMin(minPitch, n.pitch);
-                        maxPitch = qMax(maxPitch, n.pitch);
-                    }
-                    int pitchRange = qMax(1, maxPitch - minPitch);
-                    double totalBeats = audio.midiTotalBeats > 0 ? audio.midiTotalBeats : 1.0;
-                    int drawH = clipRowH - 6;
-                    int drawY = clipY + 3;
-
-                    for (const MidiNote &n : audio.midiNotes) {
-                        // X position: beat → pixel within clip rect
-                        int nx = startX + (int)((n.startBeat  / totalBeats) * widthPx);
-                        int nw = qMax(2, (int)((n.durationBeat / totalBeats) * widthPx));
-                        // Y position: higher pitch = higher on screen
-                        int ny = drawY + drawH - 1 -
-                                 (int)(((double)(n.pitch - minPitch) / pitchRange) * (drawH - 2));
-                        int nh = qMax(1, drawH / qMax(1, pitchRange + 1));
-
-                        // Color by channel
-                        static const QColor chanColors[] = {
-                            {220,180,255},{180,220,255},{255,220,180},{180,255,220},
-                            {255,180,220},{220,255,180},{200,200,255},{255,200,200}
-                        };
-                        QColor nc = chanColors[n.channel % 8];
-                        nc.setAlpha(160 + n.velocity);
-                        painter.fillRect(nx, ny, nw, nh, nc);
-                    }
-                } else if (audio.isMidi) {
-                    // No parsed notes yet — simple placeholder bars
-                    painter.setPen(QColor(220, 180, 255, 120));
-                    for (int wx = startX+4; wx < startX+widthPx-4 && wx < width(); wx += 10)
-                        painter.fillRect(wx, clipY+3, 4, clipRowH-6, QColor(220,180,255,100));
-                } else if (audio.waveformData.size() > 0) {
-                    painter.setPen(QColor(20, 60, 20, 200));
-                    int samplesPerPixel = qMax(1, audio.waveformData.size() / qMax(1, widthPx));
-                    for (int px = 0; px < widthPx && startX + px < width(); px++) {
-                        int sampleIdx = px * samplesPerPixel;
-                        if (sampleIdx < audio.waveformData.size()) {
-                            float amplitude = audio.waveformData[sampleIdx];
-                            int waveHeight = qAbs(amplitude * (clipRowH / 2 - 2));
-                            painter.drawLine(startX+px, centerY-waveHeight, startX+px, centerY+waveHeight);
-                        }
-                    }
-                } else {
-                    painter.setPen(QColor(20, 60, 20, 150));
-                    for (int wx = startX; wx < startX + widthPx && wx < width(); wx += 2) {
-                        int wh = 2 + (int)(std::sin(wx * 0.1) * std::cos(wx * 0.05) * (clipRowH/4));
-                        painter.drawLine(wx, centerY - wh, wx, centerY + wh);
-                    }
-                }
+    // Grid Content
+    for (int r = qMax(0, firstRow); firstRow >= 0 && r < rows.size() && rows[r].top <= exposed.bottom(); ++r) {
+        const TimelineRows::Row &row = rows[r];
+        Layer *layer = row.layers.first();
+        int y = row.top;
+        painter.fillRect(exposed.left(), y, exposed.width(), row.height, theme().bg1Color());
+        for (int t = firstTile; t <= lastTile; ++t)
+            painter.drawPixmap(t * TilePx, y, tile(&row, t));
+
+        if (row.collapsed || (layer->layerType() == LayerType::Audio && layer->hasAudio()))
+            continue;
 
-                // Clip label
-                painter.setPen(Qt::white);
-                QFont lf; lf.setPointSize(6); painter.setFont(lf);
-                QString label = QFileInfo(audio.filePath).baseName();
-                if (audio.isMidi) label = "🎹 " + label;
-                painter.drawText(audioRect.adjusted(4, 0, -2, 0),
-                                 Qt::AlignVCenter | Qt::AlignLeft,
-                                 painter.fontMetrics().elidedText(label, Qt::ElideRight, widthPx - 8));
-            }
+        // Zoomed far out the cells are too small to show a drawing
+        if (m_thumbnails && pixelsPerFrame() >= 1)
+            paintThumbnails(painter, layer, y, firstFrame, lastFrame);
 
-            continue;
+        // Highlight current frame
+        if (currentFrame >= firstFrame && currentFrame <= lastFrame) {
+            QColor acc = theme().accentColor();
+            painter.fillRect(frameX(currentFrame), y, cellWidth, rowHeight,
+                             QColor(acc.red(), acc.green(), acc.blue(), 20));
         }
 
         // === ONION SKIN ===
@@ -404,9 +984,9 @@ void FrameGridWidget::paintEvent(QPaintEvent *event) {
             for (int offset = 1; offset <= m_onionFrames; ++offset) {
                 int prevFrame = currentFrame - offset;
                 if (prevFrame >= 1 && layer->hasContentAtFrame(prevFrame)) {
-                    int x = (prevFrame - 1) * cellWidth;
+                    int x = frameX(prevFrame);
                     int alpha = 120 - (offset * 30);
-                    painter.fillRect(x + 2, y + 6, cellWidth - 4, rowHeight - 12,
+                    painter.fillRect(x + 2, y + 6, qMax(1, cellWidth - 4), rowHeight - 12,
                                      QColor(100, 200, 100, alpha));
                 }
             }
@@ -414,127 +994,51 @@ void FrameGridWidget::paintEvent(QPaintEvent *event) {
             for (int offset = 1; offset <= m_onionFrames; ++offset) {
                 int nextFrame = currentFrame + offset;
                 if (nextFrame <= m_project->totalFrames() && layer->hasContentAtFrame(nextFrame)) {
-                    int x = (nextFrame - 1) * cellWidth;
+                    int x = frameX(nextFrame);
                     int alpha = 120 - (offset * 30);
-                    painter.fillRect(x + 2, y + 6, cellWidth - 4, rowHeight - 12,
+                    painter.fillRect(x + 2, y + 6, qMax(1, cellWidth - 4), rowHeight - 12,
                                      QColor(200, 100, 100, alpha));
                 }
             }
         }
+    }
 
-        // === FRAME RENDERING WITH INTERPOLATION AS CONTINUOUS BAR ===
-        for (int frame = 1; frame <= m_project->totalFrames(); ++frame) {
-            int x = (frame - 1) * cellWidth;
-            QRect cellRect(x, y, cellWidth, rowHeight);
-
-            // Highlight current frame
-            if (frame == currentFrame) {
-                QColor acc = theme().accentColor();
-                painter.fillRect(cellRect, QColor(acc.red(), acc.green(), acc.blue(), 20));
-            }
-
-            bool isKeyFrame = layer->isKeyFrame(frame);
-            // isExtended / isInterpolated / isInterpKeyframe are checked
-            // implicitly through getExtensionEnd() / getInterpolationFor() below
-
-            if (isKeyFrame) {
-                QColor col = layer->color();
-
-                // Check for interpolation first
-                FrameInterpolation interp = layer->getInterpolationFor(frame);
-                if (interp.startFrame == frame && interp.endFrame > frame) {
-                    // === INTERPOLATION BAR (Purple continuous bar) ===
-                    int interpWidth = (interp.endFrame - frame + 1) * cellWidth;
-                    QRect interpRect(x, y + 8, interpWidth, rowHeight - 16);
-
-                    QColor purple(138, 43, 226);
-                    painter.setBrush(purple);
-                    painter.setPen(QPen(purple.darker(130), 1));
-                    painter.drawRoundedRect(interpRect, 6, 6);
-
-                    // Start keyframe dot
-                    painter.setBrush(Qt::white);
-                    painter.setPen(Qt::NoPen);
-                    painter.drawEllipse(x + 4, y + rowHeight / 2 - 3, 6, 6);
-
-                    // End keyframe dot
-                    painter.drawEllipse(x + interpWidth - 10, y + rowHeight / 2 - 3, 6, 6);
-
-                    // Skip ahead
-                    frame = interp.endFrame;
-                    continue;
-                }
+    // Shift/Ctrl multi-selection highlight (header row)
+    painter.setPen(Qt::NoPen);
+    const QMap<int, int> &selection = m_selectedFrames.ranges();
+    const int dragOffsetPx = m_dragCurrentX - m_dragStartX;
+    for (auto it = selection.cbegin(); it != selection.cend(); ++it) {
+        int sx = frameX(it.key());
+        int sw = frameX(it.value() + 1) - sx;
 
-                // Check if this keyframe has extension
-                int extendEnd = layer->getExtensionEnd(frame);
-                if (extendEnd > frame) {
-                    // === EXTENDED FRAME (Orange bar) ===
-                    int extendWidth = (extendEnd - frame + 1) * cellWidth;
-                    QRect extendRect(x, y + 8, extendWidth, rowHeight - 16);
-
-                    QColor orange(255, 165, 0);
-                    painter.setBrush(orange);
-                    painter.setPen(QPen(orange.darker(130), 1));
-                    painter.drawRoundedRect(extendRect, 6, 6);
-
-                    // Start dot
-                    painter.setBrush(Qt::white);
-                    painter.setPen(Qt::NoPen);
-                    painter.drawEllipse(x + 4, y + rowHeight / 2 - 3, 6, 6);
-
-                    // End dot
-                    painter.setBrush(QColor(230, 120, 20));
-                    painter.drawEllipse(x + extendWidth - 10, y + rowHeight / 2 - 3, 6, 6);
-
-                    frame = extendEnd;
-                    continue;
-                }
+        if (m_frameDragActive) {
+            sx = sx + dragOffsetPx;
+        } else if (m_frameDragBuffer != 0) {
+            sx = frameX(m_frameDragBuffer);
+            sw = cellWidth;
+        }
 
-                // === STANDARD KEYFRAME (Red/accent) or MOTION PATH (Purple) ===
-                if (layer->isMotionPathFrame(frame)) {
-                    // Motion-path generated frame — render purple
-                    QColor motionPurple(139, 92, 246);
-                    painter.setBrush(motionPurple);
-                    painter.setPen(motionPurple.lighter(130));
-                    painter.drawRoundedRect(cellRect.adjusted(2, 8, -2, -8), 4, 4);
-
-                    painter.setBrush(Qt::white);
-                    painter.setPen(Qt::NoPen);
-                    painter.drawEllipse(x + cellWidth / 2 - 2, y + rowHeight / 2 - 2, 4, 4);
-                } else {
-                    // Standard keyframe
-                    QColor keyRed = theme().accentColor();
-                    painter.setBrush(keyRed);
-                    painter.setPen(keyRed.lighter(130));
-                    painter.drawRoundedRect(cellRect.adjusted(2, 8, -2, -8), 4, 4);
-
-                    painter.setBrush(Qt::white);
-                    painter.setPen(Qt::NoPen);
-                    painter.drawEllipse(x + cellWidth / 2 - 2, y + rowHeight / 2 - 2, 4, 4);
-                }
+        painter.fillRect(sx, 1, qMax(1, sw - 1), headerHeight - 2, QColor(0, 120, 215, 150));
+    }
 
-                // ── Per-frame colour dot (top-right corner of cell) ───────
-                QColor fc = layer->frameColor(frame);
-                if (fc.isValid()) {
-                    painter.setBrush(fc);
-                    painter.setPen(QPen(fc.darker(160), 0.5));
-                    painter.drawEllipse(x + cellWidth - 9, y + 3, 6, 6);
-                }
+    // Preview of frames being dragged
+    if (!m_selectedFrames.isEmpty() && m_frameDragActive) {
+        // Only the ends of the selection can leave the timeline
+        const int delta = frameAt(m_dragCurrentX) - frameAt(m_dragStartX);
+        const bool isOutOfBounds = m_selectedFrames.first() + delta < 1
+                                || m_selectedFrames.last() + delta > m_project->totalFrames();
 
-                // ── Per-frame label text (bottom of cell) ─────────────────
-                QString fl = layer->frameLabel(frame);
-                if (!fl.isEmpty()) {
-                    painter.setPen(QColor(220, 220, 220, 210));
-                    painter.setFont(QFont("Arial", 7));
-                    painter.drawText(QRect(x + 2, y + rowHeight - 11, cellWidth - 4, 10),
-                                     Qt::AlignLeft | Qt::AlignVCenter, fl);
-                }
-            }
+        // Draw preview of dragged frames
+        QColor previewColor = isOutOfBounds ? QColor(215, 0, 0, 100) : QColor(0, 120, 215, 100);
+        for (auto it = selection.cbegin(); it != selection.cend(); ++it) {
+            int sx = frameX(it.key());
+            painter.fillRect(sx + dragOffsetPx, headerHeight, frameX(it.value() + 1) - sx,
+                             height() - headerHeight, previewColor);
         }
     }
 
     // === PLAYHEAD ===
-    int playheadX = (currentFrame - 1) * cellWidth + cellWidth / 2;
+    int playheadX = frameX(currentFrame) + cellWidth / 2;
     painter.setPen(QPen(theme().accentColor(), 2));
     painter.drawLine(playheadX, headerHeight, playheadX, height());
 
@@ -547,31 +1051,26 @@ void FrameGridWidget::paintEvent(QPaintEvent *event) {
 }
 
 void FrameGridWidget::mousePressEvent(QMouseEvent *event) {
-    const int cellWidth = 16;
-    const int headerHeight = 32;
+    const int headerHeight = TimelineRows::HeaderHeight;
 
-    int clickedFrame = (event->pos().x() / cellWidth) + 1;
+    // Content x: hit-testing is arithmetic on the zoom, whatever the length
+    const int x = event->pos().x() + m_scrollX;
+    int clickedFrame = frameAt(x);
     if (clickedFrame < 1 || clickedFrame > m_project->totalFrames())
         return;
 
     if (event->button() == Qt::LeftButton && event->pos().y() < headerHeight) {
-        m_dragStartX = event->pos().x();
-        m_dragCurrentX = event->pos().x();
+        m_dragStartX = x;
+        m_dragCurrentX = x;
 
         if (event->modifiers() & Qt::ShiftModifier) {
             int a = m_lastClickedFrame;
-            int lo = qMin(a, clickedFrame);
-            int hi = qMax(a, clickedFrame);
-            for (int f = lo; f <= hi; ++f)
-                m_selectedFrames.insert(f);
+            m_selectedFrames.select(qMin(a, clickedFrame), qMax(a, clickedFrame));
         } else if (event->modifiers() & Qt::ControlModifier) {
-            if (m_selectedFrames.contains(clickedFrame))
-                m_selectedFrames.remove(clickedFrame);
-            else
-                m_selectedFrames.insert(clickedFrame);
+            m_selectedFrames.toggle(clickedFrame);
         } else {
             m_selectedFrames.clear();
-            m_selectedFrames.insert(clickedFrame);
+            m_selectedFrames.select(clickedFrame, clickedFrame);
         }
 
         m_lastClickedFrame = clickedFrame;
@@ -588,17 +1087,17 @@ void FrameGridWidget::mousePressEvent(QMouseEvent *event) {
 }
 
 void FrameGridWidget::mouseMoveEvent(QMouseEvent *event) {
-    const int cellWidth = 16;
-    const int headerHeight = 32;
+    const int headerHeight = TimelineRows::HeaderHeight;
+    const int x = event->pos().x() + m_scrollX;
 
     if (m_frameDragActive) {
-        m_dragCurrentX = event->pos().x();
+        m_dragCurrentX = x;
 
         // Snap to frame boundaries if close enough
-        int frameAtPos = (event->pos().x() / cellWidth) + 1;
-        int snapThreshold = cellWidth / 3;
+        int frameAtPos = frameAt(x);
+        int snapThreshold = int(pixelsPerFrame() / 3);
         int dragOffsetPx = m_dragCurrentX - m_dragStartX;
-        int snapOffsetPx = (frameAtPos * cellWidth) - m_dragStartX;
+        int snapOffsetPx = frameX(frameAtPos + 1) - m_dragStartX;
 
         if (qAbs(dragOffsetPx - snapOffsetPx) < snapThreshold) {
             m_dragCurrentX = m_dragStartX + snapOffsetPx;
@@ -606,12 +1105,12 @@ void FrameGridWidget::mouseMoveEvent(QMouseEvent *event) {
 
         // Prevent dragging out of bounds
         int minX = 0;
-        int maxX = m_project->totalFrames() * cellWidth;
+        int maxX = contentWidth();
         m_dragCurrentX = qBound(minX, m_dragCurrentX, maxX);
 
         update();
     } else if (event->buttons() & Qt::LeftButton && event->pos().y() >= headerHeight) {
-        int frame = (event->pos().x() / cellWidth) + 1;
+        int frame = frameAt(x);
         if (frame > 0 && frame <= m_project->totalFrames() && frame != m_project->currentFrame()) {
             m_project->setCurrentFrame(frame);
         }
@@ -621,10 +1120,8 @@ void FrameGridWidget::mouseMoveEvent(QMouseEvent *event) {
 void FrameGridWidget::contextMenuEvent(QContextMenuEvent *event) {
     QMenu menu(this);
 
-    const int cellWidth = 16;
-    const int rowHeight = 36;
-    const int headerHeight = 32;
-    int clickedFrame = (event->pos().x() / cellWidth) + 1;
+    const int headerHeight = TimelineRows::HeaderHeight;
+    int clickedFrame = frameAt(event->pos().x() + m_scrollX);
     int y = event->pos().y();
 
     if (y < headerHeight) {
@@ -636,18 +1133,26 @@ void FrameGridWidget::contextMenuEvent(QContextMenuEvent *event) {
         } else if (selected == add24) {
             m_project->undoStack()->push(new AddFramesCommand(m_project, 24));
         }
-        updateGeometry();
+        updateScrollBar();
         update();
         return;
     }
 
     // Layer context menu
-    auto layers = m_project->layers();
-    int layerRow = (y - headerHeight) / rowHeight;
-    int layerIndex = layers.size() - 1 - layerRow;
-
-    if (layerIndex >= 0 && layerIndex < layers.size()) {
-        Layer *layer = layers[layerIndex];
+    const int layerRow = m_rows->rowAt(y);
+
+    if (layerRow >= 0) {
+        const TimelineRows::Row &row = m_rows->rows()[layerRow];
+        Layer *layer = row.layers.first();
+
+        // === COLLAPSED LAYERS ===
+        if (row.collapsed) {
+            const QList<Layer*> runLayers = row.layers;
+            QAction *expand = menu.addAction(runLayers.size() == 1 ? "Expand Layer" : "Expand Layers");
+            if (menu.exec(event->globalPos()) == expand)
+                m_rows->setCollapsed(runLayers, false);
+            return;
+        }
 
         // === AUDIO LAYER CONTEXT MENU ===
         if (layer->layerType() == LayerType::Audio) {
@@ -682,22 +1187,15 @@ void FrameGridWidget::contextMenuEvent(QContextMenuEvent *event) {
                 QString audioPath = QFileDialog::getOpenFileName(
                     this, "Load Audio File", QString(),
                     "Audio Files (*.mp3 *.wav *.ogg *.flac *.m4a *.aac)");
-                if (!audioPath.isEmpty()) {
-                    AudioData audio = loadAudioFile(audioPath, clickedFrame);
-                    layer->addAudioClip(audio);
-                    update();
-                    emit audioLoaded(layer, audioPath);
-                }
+                if (!audioPath.isEmpty())
+                    importAudioClip(layer, audioPath, clickedFrame);
             } else if (actText == "Add MIDI File...") {
                 QString midiPath = QFileDialog::getOpenFileName(
                     this, "Load MIDI File", QString(),
                     "MIDI Files (*.mid *.midi)");
                 if (!midiPath.isEmpty()) {
-                    // Use loadAudioFile so the MIDI gets parsed + rendered via FluidSynth
-                    AudioData audio = loadAudioFile(midiPath, clickedFrame);
-                    layer->addAudioClip(audio);
-                    update();
-                    emit audioLoaded(layer, midiPath);
+                    // Goes through loadAudioFile so the MIDI gets parsed + rendered via FluidSynth
+                    importAudioClip(layer, midiPath, clickedFrame);
                 }
             } else if (selected == clearAll) {
                 layer->clearAudio();
@@ -794,7 +1292,7 @@ void FrameGridWidget::contextMenuEvent(QContextMenuEvent *event) {
                    0, -1000, 1000, 1, &ok);
                if (ok && delta != 0) {
                    m_project->pushUndoState("Move Frames");
-                   m_project->moveMultipleFrames(m_selectedFrames, delta);
+                   m_project->moveMultipleFrames(m_selectedFrames.frames(), delta);
                    update();
                }
            });
@@ -913,8 +1411,11 @@ static quint32 readU32BE(const QByteArray &d, int p)
 }
 
 struct MidiParseResult {
-    QVector<MidiNote> notes;
+    QVector<MidiNote> notes;      // sorted by startBeat
     double            totalBeats = 0;
+    int               minPitch = 127;
+    int               maxPitch = 0;
+    double            maxNoteBeats = 0;
 };
 
 static MidiParseResult parseMidiFile(const QString &path)
@@ -1030,110 +1531,17 @@ static MidiParseResult parseMidiFile(const QString &path)
     }
 
     result.totalBeats = (double)maxTick / ticksPerBeat;
-    return result;
-}
-
-// MIDI → PCM rendering
-// Renders a .mid/.midi file to a temporary WAV using FluidSynth (CLI).
-// The soundfont path is read first from QSettings (user-configured in the
-// Settings panel → Audio → MIDI Synthesizer), then falls back to the
-// standard system locations so it works out-of-the-box on most distros.
-static QString renderMidiToWav(const QString &midiPath)
-{
-    // Find fluidsynth executable
-    QString fluidsynth = QStandardPaths::findExecutable("fluidsynth");
-
-#ifdef Q_OS_WIN
-    // On Windows, also check common install locations
-    if (fluidsynth.isEmpty()) {
-        const QStringList winPaths = {
-            "C:/Program Files/FluidSynth/bin/fluidsynth.exe",
-            "C:/Program Files (x86)/FluidSynth/bin/fluidsynth.exe",
-            QDir::homePath() + "/fluidsynth/bin/fluidsynth.exe",
-        };
-        for (const QString &p : winPaths) {
-            if (QFile::exists(p)) { fluidsynth = p; break; }
-        }
-    }
-#endif
-
-    if (fluidsynth.isEmpty()) {
-        qWarning() << "MIDI render: fluidsynth not found in PATH";
-        return QString();
-    }
-
-    // Resolve soundfont
-    QString sf2;
-    {
-        QSettings s("AkisVG", "AkisVG");
-        QString userSf2 = s.value("midi/soundfont").toString();
-        if (!userSf2.isEmpty() && QFile::exists(userSf2))
-            sf2 = userSf2;
-    }
-
-    // Common system locations (Arch, Debian/Ubuntu, Fedora, Windows)
-    if (sf2.isEmpty()) {
-        QStringList sfPaths = {
-            "/usr/share/soundfonts/default.sf2",
-            "/usr/share/soundfonts/FluidR3_GM.sf2",
-            "/usr/share/soundfonts/GeneralUser-GS.sf2",
-            "/usr/share/sounds/sf2/FluidR3_GM.sf2",
-            "/usr/share/sounds/sf2/default-GM.sf2",
-            "/usr/share/sounds/sf2/TimGM6mb.sf2",
-            "/usr/share/sounds/sf2/SGM-v2.01-NicePianosGuitarsBass-V1.3.sf2",
-            // Arch: fluidsynth usually ships FluidR3_GM via extra/soundfont-fluid
-            "/usr/share/soundfonts/fluid-soundfont-gm.sf2",
-        };
-#ifdef Q_OS_WIN
-        // Windows: check next to fluidsynth binary, common install locations
-        QDir fluidsynthDir = QFileInfo(fluidsynth).absoluteDir();
-        sfPaths.prepend(fluidsynthDir.filePath("../share/soundfonts/default.sf2"));
-        sfPaths.prepend(fluidsynthDir.filePath("../share/soundfonts/FluidR3_GM.sf2"));
-        sfPaths.prepend("C:/Program Files/FluidSynth/share/soundfonts/FluidR3_GM.sf2");
-        sfPaths.prepend("C:/soundfonts/FluidR3_GM.sf2");
-        sfPaths.prepend("C:/soundfonts/default.sf2");
-        // Also check user's Documents folder
-        QString docs = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation);
-        sfPaths.prepend(docs + "/soundfonts/FluidR3_GM.sf2");
-        sfPaths.prepend(docs + "/FluidR3_GM.sf2");
-#endif
-        for (const QString &p : sfPaths) {
-            if (QFile::exists(p)) { sf2 = p; break; }
-        }
-    }
-
-    if (sf2.isEmpty()) {
-        qWarning() << "MIDI render: no soundfont found — install soundfont-fluid "
-                      "(Arch) or fluid-soundfont-gm (Debian) or set a custom path "
-                      "in Settings → Audio → MIDI Soundfont";
-        return QString();
-    }
-
-    QString outWav = QDir::tempPath() + "/" +
-                     QFileInfo(midiPath).completeBaseName() + "_rendered.wav";
 
-    // fluidsynth -ni -g 1.0 -F output.wav soundfont.sf2 input.mid
-    QStringList args = { "-ni", "-g", "1.0", "-F", outWav, sf2, midiPath };
-    QProcess proc;
-#ifdef Q_OS_WIN
-    // On Windows, hide the console window that fluidsynth spawns
-    proc.setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments *args) {
-        args->flags |= CREATE_NO_WINDOW;
-    });
-#endif
-    proc.start(fluidsynth, args);
-    if (!proc.waitForFinished(30000)) {
-        proc.kill();
-        qWarning() << "MIDI render: fluidsynth timed out";
-        return QString();
-    }
-    if (proc.exitCode() != 0 || !QFile::exists(outWav)) {
-        qWarning() << "MIDI render failed:" << proc.readAllStandardError();
-        return QString();
+    // Sorted so the piano roll can binary-search the visible notes; the
+    // pitch range scales every note, so it is found once here
+    std::stable_sort(result.notes.begin(), result.notes.end(),
+                     [](const MidiNote &a, const MidiNote &b) { return a.startBeat < b.startBeat; });
+    for (const MidiNote &n : std::as_const(result.notes)) {
+        result.minPitch = qMin(result.minPitch, n.pitch);
+        result.maxPitch = qMax(result.maxPitch, n.pitch);
+        result.maxNoteBeats = qMax(result.maxNoteBeats, n.durationBeat);
     }
-
-    qDebug() << "MIDI rendered to" << outWav << "using" << sf2;
-    return outWav;
+    return result;
 }
 
 AudioData FrameGridWidget::loadAudioFile(const QString &filePath, int startFrame) {
@@ -1145,153 +1553,185 @@ AudioData FrameGridWidget::loadAudioFile(const QString &filePath, int startFrame
     audio.isMidi     = filePath.endsWith(".mid",  Qt::CaseInsensitive) ||
                        filePath.endsWith(".midi", Qt::CaseInsensitive);
 
-    // MIDI: parse notes for visualization + render to PCM
-    QString actualFilePath = filePath;
+    // MIDI: parse notes for visualization; the PCM render runs in the
+    // background (see loadMissingAudio)
     if (audio.isMidi) {
-        // 1. Parse note events for piano-roll display
         MidiParseResult parsed = parseMidiFile(filePath);
         audio.midiNotes     = parsed.notes;
         audio.midiTotalBeats = parsed.totalBeats;
+        audio.midiMinPitch  = parsed.minPitch;
+        audio.midiMaxPitch  = parsed.maxPitch;
+        audio.midiMaxNoteBeats = parsed.maxNoteBeats;
+    }
 
-        // 2. Render to WAV via FluidSynth for correct tempo + tones
-        QString rendered = renderMidiToWav(filePath);
-        if (!rendered.isEmpty()) {
-            audio.renderedPath = rendered;
-            actualFilePath     = rendered;
-        }
-        if (audio.renderedPath.isEmpty()) {
-            // FluidSynth render failed — warn the user instead of falling back
-            // to Qt's native MIDI (which produces beep-like sounds).
-            qWarning() << "MIDI playback: FluidSynth rendering failed for" << filePath
-                       << "-- install fluidsynth + a soundfont for proper audio.";
-            // Use a sentinel so the player knows not to play raw MIDI
-            // (we keep filePath set so the clip is shown in the timeline).
-            audio.durationFrames = 0; // Will be computed below if possible
+    // Duration and waveform are filled in by the clip's PcmDecodeJob (see
+    // watchDecode); until then the clip shows with its natural length
+    return audio;
+}
+
+void FrameGridWidget::importAudioClip(Layer *layer, const QString &filePath, int startFrame) {
+    AudioData audio = loadAudioFile(filePath, startFrame);
+    m_awaitingDuration.insert(qMakePair(layer, filePath));
+    layer->addAudioClip(audio);
+    loadMissingAudio();
+    update();
+    emit audioLoaded(layer, filePath);
+}
+
+QString FrameGridWidget::clipSource(const AudioData &clip) {
+    return clip.isMidi ? clip.renderedPath : clip.filePath;
+}
+
+bool FrameGridWidget::isRenderPending(const AudioData &clip) const {
+    return clip.isMidi && m_midiJobs.contains(clip.filePath);
+}
+
+void FrameGridWidget::invalidateClipRows(const QString &filePath) {
+    for (Layer *layer : m_project->layers()) {
+        for (const AudioData &clip : layer->audioClips()) {
+            if (clip.filePath == filePath) {
+                m_layerGeneration[layer] = ++m_generationCounter;
+                break;
+            }
         }
     }
+    update();
+}
 
-    // get accurate duration via QMediaPlayer
-    {
-        QMediaPlayer  probe;
-        QAudioOutput  probeOut;   // required by Qt6 even if we never play
-        probe.setAudioOutput(&probeOut);
-        probe.setSource(QUrl::fromLocalFile(actualFilePath));
-
-        QEventLoop probeLoop;
-        qint64     durationMs = -1;
-
-        // mediaStatusChanged fires LoadedMedia once metadata is ready
-        QObject::connect(&probe, &QMediaPlayer::mediaStatusChanged,
-            [&](QMediaPlayer::MediaStatus status) {
-                if (status == QMediaPlayer::LoadedMedia ||
-                    status == QMediaPlayer::BufferedMedia) {
-                    durationMs = probe.duration();
-                    probeLoop.quit();
-                } else if (status == QMediaPlayer::InvalidMedia ||
-                           status == QMediaPlayer::NoMedia) {
-                    probeLoop.quit();
-                }
-            });
-        // Also catch durationChanged which fires even before LoadedMedia on
-        // some backends (GStreamer sends it as soon as demux finishes)
-        QObject::connect(&probe, &QMediaPlayer::durationChanged,
-            [&](qint64 dur) {
-                if (dur > 0) {
-                    durationMs = dur;
-                    probeLoop.quit();
-                }
-            });
+void FrameGridWidget::rerenderMidiClips() {
+    // Renders are cached per soundfont, so switching back to an earlier
+    // one is instant; failed renders get another try
+    m_midiFailed.clear();
+    for (MidiRenderJob *job : std::as_const(m_midiJobs)) {
+        job->cancel();
+        job->disconnect(this);
+        job->deleteLater();
+    }
+    m_midiJobs.clear();
+    for (Layer *layer : m_project->layers()) {
+        if (layer->layerType() != LayerType::Audio) continue;
+        for (int i = 0; i < layer->audioClips().size(); ++i) {
+            AudioData clip = layer->audioClips()[i];
+            if (!clip.isMidi || clip.renderedPath.isEmpty()) continue;
+            clip.renderedPath.clear();
+            clip.peaks.reset();
+            layer->setAudioClip(i, clip);
+        }
+    }
+    loadMissingAudio();
+}
 
-        QTimer::singleShot(8000, &probeLoop, &QEventLoop::quit); // 8s safety
-        probeLoop.exec();
-        probe.stop();
+void FrameGridWidget::loadMissingAudio() {
+    for (Layer *layer : m_project->layers()) {
+        if (layer->layerType() != LayerType::Audio) continue;
+        const QList<AudioData> &clips = layer->audioClips();
+        for (int i = 0; i < clips.size(); ++i) {
+            const AudioData &clip = clips[i];
+            if (clip.isMidi && clip.renderedPath.isEmpty())
+                renderMidi(clip.filePath);
 
-        int fps = m_project->fps();
-        if (fps <= 0) fps = 24;
+            const QString source = clipSource(clip);
+            if (clip.peaks || source.isEmpty()) continue;
 
-        if (durationMs > 0) {
-            // Correct formula: ms * fps / 1000, with a small ceil to avoid
-            // clipping the last partial frame
-            audio.durationFrames = static_cast<int>(
-                (durationMs * fps + 999) / 1000);   // ceiling division
-        } else {
-            // Could not determine duration — store -1 so the clip renders
-            // and plays to its natural end without being cut off
-            audio.durationFrames = -1;
+            // Decoded before (or failed before); files not decoded yet are
+            // started by the mixer and reach us through watchDecode()
+            auto known = m_peaksBySource.constFind(source);
+            if (known != m_peaksBySource.constEnd() && known.value())
+                layer->setAudioClipPeaks(i, known.value());
         }
     }
+}
 
-    // build waveform via QAudioDecoder (non-blocking best-effort) IMPORTANT NOTE: No script Kiddies aloud
-    // Skip for MIDI — no PCM to decode, draw piano-roll style instead
-    if (!audio.isMidi) {
-        QAudioDecoder decoder;
-        decoder.setSource(QUrl::fromLocalFile(actualFilePath));
-
-        QEventLoop waveLoop;
-        bool       waveFinished = false;
-
-        QObject::connect(&decoder, &QAudioDecoder::bufferReady, [&]() {
-            if (waveFinished) return;
-            QAudioBuffer buffer = decoder.read();
-            if (!buffer.isValid()) return;
-
-            int channelCount = qMax(1, buffer.format().channelCount());
-            QAudioFormat::SampleFormat fmt = buffer.format().sampleFormat();
-
-            if (fmt == QAudioFormat::Float) {
-                const float *data = buffer.constData<float>();
-                int fc = buffer.frameCount();
-                for (int i = 0; i < fc; i += 50)
-                    audio.waveformData.append(
-                        qMin(qAbs(data[i * channelCount]), 1.0f));
-            } else if (fmt == QAudioFormat::Int16) {
-                const qint16 *data = buffer.constData<qint16>();
-                int fc = buffer.frameCount();
-                for (int i = 0; i < fc; i += 50)
-                    audio.waveformData.append(
-                        qMin(qAbs(data[i * channelCount] / 32768.0f), 1.0f));
+void FrameGridWidget::watchDecode(PcmDecodeJob *job) {
+    connect(job, &PcmDecodeJob::peaksUpdated, this, [this, job]() {
+        applyPeaks(job->audioPath(), job->peaks());
+    });
+    connect(job, &PcmDecodeJob::durationKnown, this, [this, job](qint64 ms) {
+        applyDuration(job->audioPath(), ms);
+    });
+    connect(job, &PcmDecodeJob::finished, this, [this, job](bool ok) {
+        const QString path = job->audioPath();
+        m_peaksBySource.insert(path, ok ? job->peaks() : nullptr);
+        // The decoded length is final now
+        for (Layer *l : m_project->layers()) {
+            for (const AudioData &c : l->audioClips()) {
+                if (clipSource(c) == path)
+                    m_awaitingDuration.remove(qMakePair(l, c.filePath));
             }
-        });
+        }
+    });
+}
+
+void FrameGridWidget::renderMidi(const QString &midiPath) {
+    if (m_midiJobs.contains(midiPath) || m_midiFailed.contains(midiPath)) return;
+
+    MidiRenderJob *job = new MidiRenderJob(midiPath, this);
+    m_midiJobs.insert(midiPath, job);
+    connect(job, &MidiRenderJob::finished, this, [this, job](bool ok) {
+        const QString midiPath = job->midiPath();
+        m_midiJobs.remove(midiPath);
+        job->deleteLater();
+        if (!ok) {
+            // Shown as a silent clip; retried when the soundfont changes
+            m_midiFailed.insert(midiPath);
+            invalidateClipRows(midiPath);
+            return;
+        }
+        for (Layer *layer : m_project->layers()) {
+            bool changed = false;
+            for (int i = 0; i < layer->audioClips().size(); ++i) {
+                AudioData clip = layer->audioClips()[i];
+                if (!clip.isMidi || clip.filePath != midiPath) continue;
+                clip.renderedPath = job->wavPath();
+                layer->setAudioClip(i, clip);
+                changed = true;
+            }
+            if (changed) emit audioLoaded(layer, midiPath);   // the mixer picks up the WAV
+        }
+    });
+    job->start();
+    invalidateClipRows(midiPath);
+}
 
-        QObject::connect(&decoder, &QAudioDecoder::finished,
-            [&]() { waveFinished = true; waveLoop.quit(); });
-        QObject::connect(&decoder,
-            QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error),
-            [&](QAudioDecoder::Error) { waveFinished = true; waveLoop.quit(); });
-
-        decoder.start();
-        QTimer::singleShot(6000, &waveLoop, &QEventLoop::quit);
-        waveLoop.exec();
-        decoder.stop();
-
-        // If we still don't have a duration (decoder sometimes fills it in
-        // after processing), grab it now as a fallback
-        if (audio.durationFrames <= 0 && decoder.duration() > 0) {
-            int fps = m_project->fps() > 0 ? m_project->fps() : 24;
-            audio.durationFrames = static_cast<int>(
-                (decoder.duration() * fps + 999) / 1000);
+void FrameGridWidget::applyPeaks(const QString &source, std::shared_ptr<const WaveformPeaks> peaks) {
+    for (Layer *layer : m_project->layers()) {
+        if (layer->layerType() != LayerType::Audio) continue;
+        const QList<AudioData> &clips = layer->audioClips();
+        for (int i = 0; i < clips.size(); ++i) {
+            if (clipSource(clips[i]) == source)
+                layer->setAudioClipPeaks(i, peaks);
         }
     }
+}
 
-    return audio;
+void FrameGridWidget::applyDuration(const QString &source, qint64 durationMs) {
+    // Only clips imported in this session take the decoded length; saved
+    // clips keep the duration they were saved with
+    const int fps = m_project->fps() > 0 ? m_project->fps() : 24;
+    for (Layer *layer : m_project->layers()) {
+        const QList<AudioData> &clips = layer->audioClips();
+        for (int i = 0; i < clips.size(); ++i) {
+            if (clipSource(clips[i]) != source
+                || !m_awaitingDuration.contains(qMakePair(layer, clips[i].filePath)))
+                continue;
+            AudioData clip = clips[i];
+            // ms * fps / 1000, rounded up so the last partial frame is kept
+            clip.durationFrames = static_cast<int>((durationMs * fps + 999) / 1000);
+            layer->setAudioClip(i, clip);
+        }
+    }
 }
-void FrameGridWidget::mouseReleaseEvent(QMouseEvent *event) {
-    const int cellWidth = 16;
 
+void FrameGridWidget::mouseReleaseEvent(QMouseEvent *event) {
     if (m_frameDragActive && event->button() == Qt::LeftButton) {
-        int delta = (m_dragCurrentX / cellWidth) - (m_dragStartX / cellWidth);
+        int delta = frameAt(m_dragCurrentX) - frameAt(m_dragStartX);
 
         if (delta != 0) {
-            QSet<int> newSelection;
-            for (int f : m_selectedFrames) {
-                newSelection.insert(f + delta);
-            }
-
             // Use the custom undo command for moving frames
-            m_project->undoStack()->push(new MoveFramesCommand(m_project, m_selectedFrames, delta));
+            m_project->undoStack()->push(new MoveFramesCommand(m_project, m_selectedFrames.frames(), delta));
 
             // Update the selection
-            m_selectedFrames = newSelection;
+            m_selectedFrames.shift(delta);
         }
 
         m_frameDragActive = false;
@@ -1307,13 +1747,35 @@ TimelineWidget::TimelineWidget(Project *project, QWidget *parent)
     : QWidget(parent)
     , m_project(project)
     , m_isPlaying(false)
-    , m_playbackTimerId(-1)
+    , m_playback(new PlaybackEngine(project, this))
+    , m_mixer(new AudioMixer(this))
 {
-    // Audio players are created on-demand per layer/clip
+    // The mixer's output position is the one clock for sound and picture
+    m_playback->setAudioClock([this]() { return m_mixer->positionMs(); });
+    connect(m_playback, &PlaybackEngine::seeked, this, [this](int frame) {
+        m_mixer->seek(qint64(frame - 1) * 1000 / qMax(1, m_project->fps()));
+    });
+    connect(m_playback, &PlaybackEngine::statsChanged, this, &TimelineWidget::showPlaybackStats);
+    connect(m_playback, &PlaybackEngine::finished, this, [this]() {
+        stopPlayback();
+        rewind();
+    });
 
     setupUI();
     connect(m_project, &Project::currentFrameChanged, this, &TimelineWidget::updateFrameDisplay);
-    connect(m_project, &Project::currentFrameChanged, this, &TimelineWidget::syncAudioToFrame);
+    connect(m_project, &Project::currentFrameChanged, this, &TimelineWidget::scrubAudio);
+    // Clip moves, volume and mute changes reach the mixer at once
+    auto connectAudioLayers = [this]() {
+        for (Layer *layer : m_project->layers()) {
+            if (layer->layerType() == LayerType::Audio)
+                connect(layer, &Layer::modified, this, &TimelineWidget::loadAudioTracks,
+                        Qt::UniqueConnection);
+        }
+        loadAudioTracks();
+    };
+    connect(m_project, &Project::layersChanged, this, connectAudioLayers);
+    connect(m_project, &Project::modified, this, &TimelineWidget::loadAudioTracks);   // fps
+    connectAudioLayers();
     // Update the FPS label whenever project settings change
     connect(m_project, &Project::modified, this, [this]() {
         m_fpsLabel->setText(QString("@ %1 FPS").arg(m_project->fps()));
@@ -1512,11 +1974,9 @@ void TimelineWidget::setupUI()
                 "QSlider::sub-page:horizontal { background: %2; border-radius: 2px; }")
         .arg(t.bg4, t.accent, t.accentHover)); }
     connect(m_volumeSlider, &QSlider::valueChanged, this, [this](int value) {
-        float vol = value / 100.0f;
-        for (auto &players : m_audioPlayers)
-            for (auto &cp : players)
-                cp.output->setVolume(vol);
+        m_mixer->setMasterVolume(value / 100.0f);
     });
+    m_mixer->setMasterVolume(m_volumeSlider->value() / 100.0f);
     controlLayout->addWidget(m_volumeSlider);
     controlLayout->addSpacing(8);
 
@@ -1527,9 +1987,11 @@ void TimelineWidget::setupUI()
     // Scrollable timeline body
     // Both the layer list and frame grid must scroll VERTICALLY together when
     // there are many layers, and HORIZONTALLY independently for wide timelines.
+    // The grid is only as wide as it is shown and scrolls (and zooms) its
+    // frames itself, so a feature-length project does not make it huge.
     // Layout:  outerScroll (vertical) -> splitterContainer -> splitter
     //                                                   ├─ layerList
-    //                                                   └─ hScrollArea (horizontal) -> frameGrid
+    //                                                   └─ gridPane -> frameGrid + hScrollBar
 
     QScrollArea *outerScroll = new QScrollArea();
     outerScroll->setWidgetResizable(true);
@@ -1545,20 +2007,20 @@ void TimelineWidget::setupUI()
         .arg(t.bg0, t.bg2, t.accent)); }
 
     // SplitterContainer: override sizeHint so the outer scroll area knows
-    // the minimum height needed (based on layer count) and can scroll vertically.
-    // Width is freely expandable — hScrollArea inside handles horizontal overflow.
+    // the minimum height needed (based on the rows) and can scroll vertically.
+    // Width is freely expandable — the grid scrolls horizontally by itself.
     struct SplitterContainer : public QWidget {
-        Project *proj;
-        SplitterContainer(Project *p, QWidget *par=nullptr): QWidget(par), proj(p) {
+        TimelineRows *rows;
+        SplitterContainer(TimelineRows *r, QWidget *par=nullptr): QWidget(par), rows(r) {
             setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
         }
         QSize sizeHint() const override {
-            const int rowHeight = 36, headerHeight = 32;
-            return QSize(400, headerHeight + proj->layerCount() * rowHeight);
+            return QSize(400, rows->totalHeight() + 10);   // + the scroll bar
         }
     };
-    SplitterContainer *splitterContainer = new SplitterContainer(m_project);
-    connect(m_project, &Project::layersChanged, splitterContainer,
+    m_rows = new TimelineRows(m_project, this);
+    SplitterContainer *splitterContainer = new SplitterContainer(m_rows);
+    connect(m_rows, &TimelineRows::changed, splitterContainer,
             [splitterContainer](){ splitterContainer->updateGeometry(); });
     QHBoxLayout *scLayout = new QHBoxLayout(splitterContainer);
     scLayout->setContentsMargins(0, 0, 0, 0);
@@ -1568,31 +2030,35 @@ void TimelineWidget::setupUI()
     splitter->setStyleSheet("QSplitter::handle { background-color: #000; width: 1px; }");
     splitter->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
 
-    LayerListWidget *layerList = new LayerListWidget(m_project);
+    LayerListWidget *layerList = new LayerListWidget(m_project, m_rows);
     splitter->addWidget(layerList);
 
-    QScrollArea *hScrollArea = new QScrollArea();
-    hScrollArea->setWidgetResizable(false);
-    hScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
-    hScrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    QWidget *gridPane = new QWidget();
+    QVBoxLayout *gridLayout = new QVBoxLayout(gridPane);
+    gridLayout->setContentsMargins(0, 0, 0, 0);
+    gridLayout->setSpacing(0);
+
+    QScrollBar *hScrollBar = new QScrollBar(Qt::Horizontal);
+    hScrollBar->setToolTip("Ctrl+Wheel over the frames to zoom");
     { const auto &t = theme();
-    hScrollArea->setStyleSheet(
-        QString("QScrollArea { background-color: %1; border: none; }"
-                "QScrollBar:horizontal { background: %1; height: 10px; }"
+    hScrollBar->setStyleSheet(
+        QString("QScrollBar:horizontal { background: %1; height: 10px; }"
                 "QScrollBar::handle:horizontal { background: %2; border-radius: 5px; }"
                 "QScrollBar::handle:horizontal:hover { background: %3; }")
         .arg(t.bg0, t.bg2, t.accent)); }
 
-    FrameGridWidget *frameGrid = new FrameGridWidget(m_project);
+    FrameGridWidget *frameGrid = new FrameGridWidget(m_project, m_rows);
+    m_frameGrid = frameGrid;
 
     // Connect audio loading signal
     connect(frameGrid, &FrameGridWidget::audioLoaded, this, &TimelineWidget::loadAudioTrack);
     connect(frameGrid, &FrameGridWidget::referenceImageImported, this, &TimelineWidget::handleReferenceImport);
 
-    hScrollArea->setWidget(frameGrid);
-    frameGrid->adjustSize();
+    frameGrid->setHorizontalScrollBar(hScrollBar);
+    gridLayout->addWidget(frameGrid, 1);
+    gridLayout->addWidget(hScrollBar);
 
-    splitter->addWidget(hScrollArea);
+    splitter->addWidget(gridPane);
     splitter->setStretchFactor(0, 0);
     splitter->setStretchFactor(1, 1);
 
@@ -1612,139 +2078,57 @@ void TimelineWidget::setupUI()
     });
 }
 
-void TimelineWidget::ensurePlayersForLayer(Layer *layer) {
-    if (!layer) return;
-    const auto &clips = layer->audioClips();
-    auto &players = m_audioPlayers[layer];
-
-    // Add players for new clips
-    for (int i = players.size(); i < clips.size(); ++i) {
-        AudioClipPlayer cp;
-        cp.output = new QAudioOutput(this);
-        cp.player = new QMediaPlayer(this);
-        cp.player->setAudioOutput(cp.output);
-        cp.clipIdx = i;
-        players.append(cp);
-    }
-    // Remove players for removed clips
-    while (players.size() > clips.size()) {
-        auto &cp = players.last();
-        cp.player->stop();
-        cp.player->deleteLater();
-        cp.output->deleteLater();
-        players.removeLast();
-    }
-    // Update sources + volume
-    for (int i = 0; i < clips.size() && i < players.size(); ++i) {
-        const AudioData &clip = clips[i];
-        auto &cp = players[i];
-        // For MIDI: only play the rendered WAV; never feed raw MIDI to QMediaPlayer
-        // (raw MIDI via Qt's backend produces beep-like sounds).
-        // For regular audio: play the file directly.
-        QString playPath;
-        if (clip.isMidi) {
-            if (!clip.renderedPath.isEmpty() && QFile::exists(clip.renderedPath))
-                playPath = clip.renderedPath;
-            // else: no rendered audio available — leave source empty (silent)
-        } else {
-            playPath = clip.filePath;
-        }
-
-        QUrl url = playPath.isEmpty() ? QUrl() : QUrl::fromLocalFile(playPath);
-        if (cp.player->source() != url)
-            cp.player->setSource(url);
-        cp.output->setVolume(clip.muted ? 0.0f : clip.volume);
-    }
-}
-
-void TimelineWidget::releasePlayersForLayer(Layer *layer) {
-    if (!m_audioPlayers.contains(layer)) return;
-    for (auto &cp : m_audioPlayers[layer]) {
-        cp.player->stop();
-        cp.player->deleteLater();
-        cp.output->deleteLater();
-    }
-    m_audioPlayers.remove(layer);
-}
-
-void TimelineWidget::releaseAllPlayers() {
-    for (Layer *layer : m_audioPlayers.keys())
-        releasePlayersForLayer(layer);
-}
-
 void TimelineWidget::loadAudioTracks() {
-    // Rebuild players for ALL audio layers
-    for (Layer *layer : m_project->layers()) {
-        if (layer->layerType() == LayerType::Audio && layer->hasAudio())
-            ensurePlayersForLayer(layer);
-    }
-}
-
-void TimelineWidget::loadAudioTrack(Layer *layer, const QString &/*audioPath*/) {
-    if (layer) ensurePlayersForLayer(layer);
-}
-
-void TimelineWidget::syncAudioToFrame() {
-    int currentFrame = m_project->currentFrame();
-    int fps = m_project->fps();
-    qint64 frameDiffMs = 1000 / qMax(1, fps);
-
-    // Ensure we have players for all audio layers
+    const int fps = qMax(1, m_project->fps());
+    QList<AudioMixer::Clip> mix;
+    QSet<QString> used;
     for (Layer *layer : m_project->layers()) {
         if (layer->layerType() != LayerType::Audio || !layer->hasAudio()) continue;
-        ensurePlayersForLayer(layer);
-
-        const auto &clips  = layer->audioClips();
-        auto       &players = m_audioPlayers[layer];
-
-        for (int i = 0; i < clips.size() && i < players.size(); ++i) {
-            const AudioData &clip = clips[i];
-            auto &cp = players[i];
-
-            // Effective duration: -1 means "use full audio length"
-            int effDuration = clip.durationFrames > 0
-                ? clip.durationFrames
-                : (cp.player->duration() > 0
-                    ? (int)((cp.player->duration() * fps) / 1000) + 1
-                    : 99999);
-
-            bool inRange = (currentFrame >= clip.startFrame &&
-                            currentFrame < clip.startFrame + effDuration);
-
-            cp.output->setVolume(clip.muted ? 0.0f : clip.volume);
-
-            if (inRange) {
-                int frameOffset = currentFrame - clip.startFrame;
-                qint64 posMs = (static_cast<qint64>(frameOffset) * 1000) / qMax(1, fps);
-
-                bool alreadyPlaying = (cp.player->playbackState() == QMediaPlayer::PlayingState);
-
-                // Only seek if:
-                //  - Not currently playing (scrubbing), OR
-                //  - Drift is very large (> 500ms) which means we jumped to a new position
-                // Do NOT seek every frame while playing — this causes stuttering.
-                if (!alreadyPlaying || !m_isPlaying) {
-                    // Scrubbing: always seek to the correct position
-                    qint64 curPosMs = cp.player->position();
-                    if (qAbs(curPosMs - posMs) > frameDiffMs)
-                        cp.player->setPosition(posMs);
-                } else {
-                    // Playing: only correct large drifts (> 500ms) to avoid stutter
-                    qint64 curPosMs = cp.player->position();
-                    if (qAbs(curPosMs - posMs) > 500)
-                        cp.player->setPosition(posMs);
-                }
-
-                if (m_isPlaying && !clip.muted) {
-                    if (cp.player->playbackState() != QMediaPlayer::PlayingState)
-                        cp.player->play();
+        for (const AudioData &clip : layer->audioClips()) {
+            // MIDI plays its rendered WAV; raw MIDI would go to the
+            // platform's beep synth, so without a render it stays silent
+            const QString source = clip.isMidi ? clip.renderedPath : clip.filePath;
+            if (source.isEmpty() || !QFile::exists(source)) continue;
+            used.insert(source);
+
+            if (!m_pcmBySource.contains(source)) {
+                // Decoded once per file, for the mix and the clip's waveform;
+                // the mix is rebuilt when it is ready
+                if (!m_pcmJobs.contains(source)) {
+                    PcmDecodeJob *job = new PcmDecodeJob(source, this);
+                    m_pcmJobs.insert(source, job);
+                    m_frameGrid->watchDecode(job);
+                    connect(job, &PcmDecodeJob::finished, this, [this, job, source](bool ok) {
+                        m_pcmJobs.remove(source);
+                        m_pcmBySource.insert(source, ok ? job->pcm() : nullptr);
+                        job->deleteLater();
+                        loadAudioTracks();
+                    });
+                    job->start();
                 }
-            } else {
-                if (cp.player->playbackState() == QMediaPlayer::PlayingState)
-                    cp.player->pause();
+                continue;
             }
+            if (clip.muted || !m_pcmBySource.value(source)) continue;
+
+            AudioMixer::Clip mixClip;
+            mixClip.pcm = m_pcmBySource.value(source);
+            mixClip.startMs = qint64(clip.startFrame - 1) * 1000 / fps;
+            mixClip.lengthMs = clip.durationFrames > 0 ? qint64(clip.durationFrames) * 1000 / fps : -1;
+            mixClip.volume = clip.volume;
+            mix.append(mixClip);
         }
     }
+
+    // Files no clip plays any more are let go
+    for (auto it = m_pcmBySource.begin(); it != m_pcmBySource.end();) {
+        if (used.contains(it.key())) ++it;
+        else it = m_pcmBySource.erase(it);
+    }
+    m_mixer->setClips(mix);
+}
+
+void TimelineWidget::loadAudioTrack(Layer */*layer*/, const QString &/*audioPath*/) {
+    loadAudioTracks();
 }
 
 void TimelineWidget::handleReferenceImport(Layer *layer, const QString &imagePath, int frame) {
@@ -1759,7 +2143,21 @@ void TimelineWidget::onPlayPauseClicked() {
 
 void TimelineWidget::onStopClicked() {
     stopPlayback();
+    rewind();
+}
+
+void TimelineWidget::rewind() {
+    // Going back to the start is not scrubbing
+    m_scrubEnabled = false;
     m_project->setCurrentFrame(1);
+    m_scrubEnabled = true;
+}
+
+void TimelineWidget::scrubAudio(int frame) {
+    // Dragging the playhead or stepping frames plays that frame's audio
+    if (m_isPlaying || !m_scrubEnabled) return;
+    const int fps = qMax(1, m_project->fps());
+    m_mixer->scrub(qint64(frame - 1) * 1000 / fps, 1000 / fps);
 }
 
 void TimelineWidget::onFrameChanged(int frame) {
@@ -1789,20 +2187,10 @@ void TimelineWidget::startPlayback() {
         }
     }
 
-    // Record the wall-clock time and the frame we're starting from so
-    // timerEvent can compute which frame *should* be showing right now
-    // instead of blindly incrementing. This prevents timer drift from
-    // causing audio stutter.
-    m_playStartFrame = m_project->currentFrame();
-    m_playElapsed.restart();
-
-    // Fire the timer slightly faster than frame-rate so we never skip a frame
-    // (at 24 fps one frame = 41.67 ms; fire every 10 ms and let timerEvent
-    // decide whether it's actually time to advance).
-    m_playbackTimerId = startTimer(10, Qt::PreciseTimer);
-
     loadAudioTracks();
-    syncAudioToFrame();
+    // The engine shows whatever frame the audio has reached
+    m_mixer->start(qint64(m_project->currentFrame() - 1) * 1000 / qMax(1, m_project->fps()));
+    m_playback->start();
 }
 
 void TimelineWidget::stopPlayback() {
@@ -1823,41 +2211,18 @@ void TimelineWidget::stopPlayback() {
             m_playPauseBtn->setText("▶");
         }
     }
-    if (m_playbackTimerId != -1) {
-        killTimer(m_playbackTimerId);
-        m_playbackTimerId = -1;
-    }
-    // Pause all active audio players
-    for (auto &players : m_audioPlayers)
-        for (auto &cp : players)
-            if (cp.player->playbackState() == QMediaPlayer::PlayingState)
-                cp.player->pause();
+    m_playback->stop();
+    m_mixer->stop();
 }
 
-void TimelineWidget::timerEvent(QTimerEvent *event) {
-    if (event->timerId() != m_playbackTimerId)
-        return;
-
-    int fps = qMax(1, m_project->fps());
-
-    // Calculate which frame should be shown now based on wall-clock time.
-    // This makes visual frame advance perfectly in sync with audio position
-    // regardless of Qt timer jitter.
-    qint64 elapsedMs  = m_playElapsed.elapsed();
-    int    frameOffset = static_cast<int>((elapsedMs * fps) / 1000);
-    int    targetFrame = m_playStartFrame + frameOffset;
-
-    int stopAt = m_project->highestUsedFrame();
-    if (targetFrame > stopAt) {
-        stopPlayback();
-        m_project->setCurrentFrame(1);
-        return;
-    }
+void TimelineWidget::showPlaybackStats(double achievedFps, int framesDropped) {
+    m_fpsLabel->setText(QString("@ %1 FPS · %2 shown, %3 dropped")
+                            .arg(m_project->fps()).arg(achievedFps, 0, 'f', 1).arg(framesDropped));
+}
 
-    // Only call setCurrentFrame (which is expensive — it triggers a full
-    // refreshFrame) when the frame actually changes.
-    if (targetFrame != m_project->currentFrame())
-        m_project->setCurrentFrame(targetFrame);
+void TimelineWidget::setThumbnailsVisible(bool visible) {
+    if (FrameGridWidget *grid = findChild<FrameGridWidget*>())
+        grid->setThumbnailsVisible(visible);
 }
 
 void TimelineWidget::setOnionSkinEnabled(bool enabled) {
@@ -1870,33 +2235,10 @@ void TimelineWidget::setOnionSkinEnabled(bool enabled) {
 
 void TimelineWidget::rerenderMidiClips()
 {
-    // For every MIDI clip across all audio layers: delete the old rendered WAV,
-    // re-render with the now-current soundfont, rebuild the QMediaPlayer source.
-    bool any = false;
-    for (Layer *layer : m_project->layers()) {
-        if (layer->layerType() != LayerType::Audio) continue;
-        for (int i = 0; i < layer->audioClips().size(); ++i) {
-            AudioData clip = layer->audioClips()[i];
-            if (!clip.isMidi) continue;
-
-            // Remove stale rendered WAV
-            if (!clip.renderedPath.isEmpty() && QFile::exists(clip.renderedPath))
-                QFile::remove(clip.renderedPath);
-            clip.renderedPath.clear();
-
-            // Re-render with new soundfont
-            QString newWav = renderMidiToWav(clip.filePath);
-            clip.renderedPath = newWav;
-            layer->setAudioClip(i, clip);
-            any = true;
-        }
-    }
-
-    if (any) {
-        // Rebuild all players so they pick up the new WAV sources
-        releaseAllPlayers();
-        loadAudioTracks();
-    }
+    // Renders run in the background; each clip is decoded into the mix when
+    // its WAV is ready (FrameGridWidget::audioLoaded)
+    if (FrameGridWidget *grid = findChild<FrameGridWidget*>())
+        grid->rerenderMidiClips();
 }
 
 void TimelineWidget::applyTheme()
@@ -1929,5 +2271,7 @@ void TimelineWidget::applyTheme()
         .arg(t.bg4, t.accent, t.accentHover));
 
     // Repaint the painted sub-widgets so QPainter colors update
+    if (FrameGridWidget *grid = findChild<FrameGridWidget*>())
+        grid->invalidateTiles();
     update();
 }
@@ -8,22 +8,79 @@
 #include <QList>
 #include <QMap>
 #include <QSet>
-#include <QElapsedTimer>
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+#include <QPair>
+#include <memory>
+
+#include "timelinerows.h"
 
 class Project;
 class Layer;
-class QMediaPlayer;
-class QAudioOutput;
+class QPainter;
+class QScrollBar;
+class MidiRenderJob;
+class ThumbnailCache;
+class WaveformPeaks;
+class PlaybackEngine;
+class AudioMixer;
+class PcmDecodeJob;
+struct PcmAudio;
 struct AudioData;
-struct AudioClipPlayer;
+
+// A cached piece of the frame grid: the ruler (layer == nullptr) or a
+// stretch of one row
+struct GridTileKey {
+    Layer *layer;           // the row's first layer
+    int span;               // 0 = expanded row, else the layers of a collapsed run
+    int tile;               // TilePx pixels per tile at the current zoom
+    quint64 generation;     // bumped whenever a layer of the row changes
+    bool current;           // the current layer's row is tinted
+    bool operator==(const GridTileKey &other) const;
+};
+size_t qHash(const GridTileKey &key, size_t seed = 0);
+
+// Frames selected in the ruler, as disjoint inclusive ranges keyed by their
+// first frame, so selecting a span costs the same whatever its length
+class FrameSelection
+{
+public:
+    bool isEmpty() const { return m_ranges.isEmpty(); }
+    void clear() { m_ranges.clear(); }
+    bool contains(int frame) const;
+    void select(int first, int last);
+    void toggle(int frame);
+    void shift(int delta);
+    int first() const { return m_ranges.firstKey(); }   // not empty
+    int last() const { return m_ranges.last(); }
+    const QMap<int, int> &ranges() const { return m_ranges; }
+    QSet<int> frames() const;
+
+private:
+    QMap<int, int> m_ranges;   // first -> last
+};
 
 class FrameGridWidget : public QWidget
 {
     Q_OBJECT
 public:
-    explicit FrameGridWidget(Project *project, QWidget *parent = nullptr);
+    FrameGridWidget(Project *project, TimelineRows *rows, QWidget *parent = nullptr);
+    // Only as wide as it is shown; the bar scrolls the frames through it
     QSize sizeHint() const override;
+    void setHorizontalScrollBar(QScrollBar *bar);
     void setOnionSkin(bool enabled, int frames);
+    // Small pictures of each drawing in its keyframe cells, rendered in
+    // the background (off by default)
+    void setThumbnailsVisible(bool visible);
+    // Drops every cached tile, e.g. after a theme change
+    void invalidateTiles();
+    // Renders every MIDI clip again with the current soundfont (cached
+    // renders are reused)
+    void rerenderMidiClips();
+    // Fills in waveforms and durations from a decode started for playback
+    // (see TimelineWidget::loadAudioTracks); each file is decoded only once
+    void watchDecode(PcmDecodeJob *job);
 
 signals:
     void audioLoaded(Layer *layer, const QString &audioPath);
@@ -35,21 +92,74 @@ protected:
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
+    // Ctrl+wheel zooms around the pointer, Shift+wheel scrolls the frames
+    void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private:
+    // Horizontal view. Content x is the position on the whole timeline at
+    // the current zoom; the widget shows [m_scrollX, m_scrollX + width())
+    int frameX(int frame) const;    // content x of the left edge of the frame
+    int frameAt(int x) const;       // frame under content x, not clamped
+    double pixelsPerFrame() const;
+    int contentWidth() const;
+    void setZoom(int level, int anchorX);
+    void setScrollX(int x);
+    void updateScrollBar();
+
     AudioData loadAudioFile(const QString &filePath, int startFrame);
+    void importAudioClip(Layer *layer, const QString &filePath, int startFrame);
+    static QString clipSource(const AudioData &clip);   // the file that is decoded
+    bool isRenderPending(const AudioData &clip) const;
+    void invalidateClipRows(const QString &filePath);
+    // Starts a MidiRenderJob for every MIDI clip without a WAV and hands
+    // decoded waveforms to clips still without one
+    void loadMissingAudio();
+    void renderMidi(const QString &midiPath);
+    void applyPeaks(const QString &source, std::shared_ptr<const WaveformPeaks> peaks);
+    void applyDuration(const QString &source, qint64 durationMs);
+    void onCurrentFrameChanged(int frame);
+    void updateFrameColumns(int first, int last);
+    QPixmap tile(const TimelineRows::Row *row, int index);   // row == nullptr: the ruler
+    void paintRulerTile(QPainter &painter, int firstFrame, int lastFrame);
+    void paintRowTile(QPainter &painter, Layer *layer, int firstFrame, int lastFrame, bool current);
+    void paintCollapsedRowTile(QPainter &painter, const QList<Layer*> &layers,
+                               int firstFrame, int lastFrame, bool current);
+    QPixmap midiStripSegment(const AudioData &audio, int widthPx, int height, int segment);
+    void paintThumbnails(QPainter &painter, Layer *layer, int y, int firstFrame, int lastFrame);
 
     Project *m_project;
+    TimelineRows *m_rows;
     int m_onionFrames;
     bool m_isDragging;
     bool m_onionSkinEnabled;
-    QSet<int> m_selectedFrames;
+    FrameSelection m_selectedFrames;
     int m_lastClickedFrame = 1;
     int m_frameDragStart = -1;
-    int m_dragCurrentX = 0;
+    int m_dragCurrentX = 0;         // content x
     int m_dragStartX = 0; 
     int m_frameDragBuffer = 1;
     bool m_frameDragActive = false;
+
+    QCache<GridTileKey, QPixmap> m_tiles;     // cost in KB
+    QCache<QString, QPixmap> m_midiStrips;    // cost in KB
+    QHash<Layer*, quint64> m_layerGeneration;
+    quint64 m_generationCounter = 0;
+    int m_tileFrameCount = 0;
+    qreal m_tileDpr = 1.0;
+    int m_tileZoom = -1;
+    int m_shownFrame = 1;                     // where the playhead was last drawn
+
+    QHash<QString, std::shared_ptr<const WaveformPeaks>> m_peaksBySource; // null = undecodable
+    QSet<QPair<Layer*, QString>> m_awaitingDuration;                      // imported this session
+    QHash<QString, MidiRenderJob*> m_midiJobs;                            // by MIDI file
+    QSet<QString> m_midiFailed;
+
+    ThumbnailCache *m_thumbnails = nullptr;   // null while thumbnails are hidden
+
+    int m_zoom;                               // index into the zoom levels
+    int m_scrollX = 0;
+    QScrollBar *m_hBar = nullptr;
 };
 
 class TimelineWidget : public QWidget
@@ -62,14 +172,12 @@ public:
 signals:
     void referenceImageRequested(Layer *layer, const QString &imagePath, int frame);
 
-protected:
-    void timerEvent(QTimerEvent *event) override;
-
 public slots:
     void setOnionSkinEnabled(bool enabled);
+    void setThumbnailsVisible(bool visible);
     void applyTheme();
     void rerenderMidiClips();
-    // Re-initialize all audio players; call after export to restore playback.
+    // Hand every audible clip to the mixer, decoding new files first
     void loadAudioTracks();
     void stopPlayback();
 
@@ -78,13 +186,15 @@ private slots:
     void onStopClicked();
     void onFrameChanged(int frame);
     void updateFrameDisplay();
+    void scrubAudio(int frame);
     void loadAudioTrack(Layer *layer, const QString &audioPath);
-    void syncAudioToFrame();
     void handleReferenceImport(Layer *layer, const QString &imagePath, int frame);
 
 private:
     void setupUI();
     void startPlayback();
+    void rewind();
+    void showPlaybackStats(double achievedFps, int framesDropped);
 
     Project *m_project;
     QPushButton *m_playPauseBtn;
@@ -92,23 +202,19 @@ private:
     QLabel *m_frameLabel;
     QLabel *m_fpsLabel;
     bool m_isPlaying;
-    int m_playbackTimerId;
-    QElapsedTimer m_playElapsed;   // wall-clock timer for drift-free frame advance
-    int           m_playStartFrame = 1; // frame we were on when playback started
+    PlaybackEngine *m_playback;    // follows the audio clock, drops late frames
     QWidget *m_controlBar;
     QSlider *m_volumeSlider;
     QList<QPushButton*> m_playButtons;
-
-    // Audio playback — one player per audio layer, supports multiple layers + clips
-    struct AudioClipPlayer {
-        QMediaPlayer  *player  = nullptr;
-        QAudioOutput  *output  = nullptr;
-        int            clipIdx = 0;   // which clip in the layer this player serves
-    };
-    QMap<Layer*, QList<AudioClipPlayer>> m_audioPlayers; // layer -> [player per clip]
-    void ensurePlayersForLayer(Layer *layer);
-    void releasePlayersForLayer(Layer *layer);
-    void releaseAllPlayers();
+    TimelineRows *m_rows;          // shared by the layer list and the frame grid
+    FrameGridWidget *m_frameGrid = nullptr;
+
+    // Audio playback — all clips mixed into one stream, which is also the
+    // playback clock
+    AudioMixer *m_mixer;
+    QHash<QString, std::shared_ptr<const PcmAudio>> m_pcmBySource;   // null = undecodable
+    QHash<QString, PcmDecodeJob*> m_pcmJobs;                         // by decoded file
+    bool m_scrubEnabled = true;
 };
 
 #endif // TIMELINEWIDGET_H
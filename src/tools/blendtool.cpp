@@ -1,6 +1,7 @@
 #include "blendtool.h"
 #include "canvas/vectorcanvas.h"
 #include "canvas/objects/pathobject.h"
+#include "core/project.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsItem>
 #include <QtMath>
@@ -109,6 +110,8 @@ void BlendTool::mouseReleaseEvent(QGraphicsSceneMouseEvent *event, VectorCanvas
 
     m_activeSmear->setPath(m_activeSmearPath);
     canvas->update();
+    // Added to the layer on press; it has grown since
+    if (canvas->project()) canvas->project()->markObjectDirty(m_activeSmear);
 
     if (canvas->undoStack()) {
         canvas->undoStack()->endMacro();
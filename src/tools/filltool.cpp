@@ -13,6 +13,7 @@
 #include "canvas/objects/pathobject.h"
 #include "canvas/objects/shapeobject.h"
 #include "core/commands.h"
+#include "core/project.h"
 
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsItem>
@@ -125,9 +126,12 @@ void FillTool::mousePressEvent(QGraphicsSceneMouseEvent *event, VectorCanvas *ca
         // Colour the stroke (no undo for open-path stroke — acceptable trade-off).
         target->setStrokeColor(applyColor);
         target->update();
+        if (canvas->project()) canvas->project()->markObjectDirty(target);
     } else {
         // Colour the fill with full undo support.
-        canvas->undoStack()->push(new FillColorCommand(target, applyColor));
+        int frame = -1;
+        Layer *layer = canvas->project() ? canvas->project()->layerOfObject(target, &frame) : nullptr;
+        canvas->undoStack()->push(new FillColorCommand(target, layer, frame, applyColor));
     }
 
     canvas->update();
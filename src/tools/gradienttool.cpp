@@ -1,6 +1,7 @@
 #include "gradienttool.h"
 #include "canvas/vectorcanvas.h"
 #include "canvas/objects/gradientobject.h"
+#include "core/project.h"
 #include <QGraphicsSceneMouseEvent>
 #include <cmath>
 
@@ -77,6 +78,9 @@ void GradientTool::mouseReleaseEvent(QGraphicsSceneMouseEvent *event, VectorCanv
     if (std::hypot(d.x(), d.y()) < 5.0) {
         // removeObject handles undo; but this was just added — pop from undo
         canvas->removeObject(m_liveGradient);
+    } else if (canvas->project()) {
+        // Added to the layer on press; dragged out since
+        canvas->project()->markObjectDirty(m_liveGradient);
     }
 
     m_isDragging   = false;
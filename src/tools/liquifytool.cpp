@@ -2,6 +2,7 @@
 #include "canvas/vectorcanvas.h"
 #include "canvas/objects/pathobject.h"
 #include "canvas/objects/vectorobject.h"
+#include "core/project.h"
 #include <cmath>
 
 LiquifyTool::LiquifyTool(QObject *parent) : Tool(ToolType::Blend, parent) {}
@@ -77,6 +78,11 @@ void LiquifyTool::warpAtPoint(const QPointF &pos, VectorCanvas *canvas)
 void LiquifyTool::mouseReleaseEvent(QGraphicsSceneMouseEvent *event, VectorCanvas *canvas)
 {
     m_isDrawing = false;
+    // Paths were warped in place on the source objects
+    if (canvas->project()) {
+        for (PathObject *path : std::as_const(m_affectedObjects))
+            canvas->project()->markObjectDirty(path);
+    }
     // Refresh to ensure source objects are synced to display
     canvas->refreshFrame();
     if (canvas->undoStack()) canvas->undoStack()->endMacro();
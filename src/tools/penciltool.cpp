@@ -1,6 +1,7 @@
 #include "penciltool.h"
 #include "canvas/vectorcanvas.h"
 #include "canvas/objects/pathobject.h"
+#include "core/project.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QDateTime>
 #include <QtMath>
@@ -102,6 +103,8 @@ void PencilTool::mouseReleaseEvent(QGraphicsSceneMouseEvent *event, VectorCanvas
         } else {
             m_currentPath->lineTo(event->scenePos());
         }
+        // Added to the layer on press; it has grown since
+        if (canvas->project()) canvas->project()->markObjectDirty(m_currentPath);
     }
 
     m_currentPath  = nullptr;
@@ -1,6 +1,7 @@
 #include "selecttool.h"
 #include "canvas/vectorcanvas.h"
 #include "canvas/objects/vectorobject.h"
+#include "core/project.h"
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsRectItem>
 #include <QPen>
@@ -84,6 +85,7 @@ void SelectTool::mousePressEvent(QGraphicsSceneMouseEvent *event, VectorCanvas *
 
         // Start move immediately
         m_isMovingObjects = true;
+        m_objectsMoved    = false;
         m_lastDragPos     = pos;
 
         canvas->showSelectionOverlays(m_selectedObjects);
@@ -119,6 +121,7 @@ void SelectTool::mouseMoveEvent(QGraphicsSceneMouseEvent *event, VectorCanvas *c
     if (m_isMovingObjects && !m_selectedObjects.isEmpty()) {
         QPointF delta = pos - m_lastDragPos;
         m_lastDragPos = pos;
+        m_objectsMoved = m_objectsMoved || !delta.isNull();
 
         for (VectorObject *src : m_selectedObjects) {
             // Move the source (authoritative position, persists to layer).
@@ -156,7 +159,13 @@ void SelectTool::mouseReleaseEvent(QGraphicsSceneMouseEvent *event, VectorCanvas
     // ── Finish object move — commit positions to layer ────────────────────────
     if (m_isMovingObjects) {
         m_isMovingObjects = false;
-        // Objects were moved directly on source objects; refresh display clones
+        // Objects were moved directly on source objects; record that for the
+        // journaled save and refresh display clones
+        if (m_objectsMoved && canvas->project()) {
+            for (VectorObject *src : m_selectedObjects)
+                canvas->project()->markObjectDirty(src);
+        }
+        m_objectsMoved = false;
         canvas->refreshFrame();
         event->accept();
         return;
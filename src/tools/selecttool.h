@@ -50,6 +50,7 @@ private:
 
     // Object-move drag state
     bool    m_isMovingObjects = false;
+    bool    m_objectsMoved    = false;   // the drag actually moved them
     QPointF m_lastDragPos;
 
     QList<VectorObject*> m_selectedObjects; // always SOURCE pointers
@@ -11,6 +11,11 @@
 ExportDialog::ExportDialog(ExportType type, QWidget *parent)
     : QDialog(parent)
     , m_type(type)
+    , m_fpsSpinBox(nullptr)
+    , m_formatComboBox(nullptr)
+    , m_startFrameSpinBox(nullptr)
+    , m_endFrameSpinBox(nullptr)
+    , m_allFramesCheckBox(nullptr)
     , m_defaultWidth(1920)
     , m_defaultHeight(1080)
     , m_defaultFPS(24)
@@ -30,6 +35,9 @@ ExportDialog::ExportDialog(ExportType type, QWidget *parent)
         case ExportType::Image:
             title = "Export Image";
             break;
+        case ExportType::ImageSequence:
+            title = "Export PNG Sequence";
+            break;
     }
     setWindowTitle(title);
     
@@ -55,6 +63,9 @@ void ExportDialog::setupUI()
         case ExportType::Image:
             titleLabel->setText("Image Export Settings");
             break;
+        case ExportType::ImageSequence:
+            titleLabel->setText("PNG Sequence Export Settings");
+            break;
     }
     titleLabel->setAlignment(Qt::AlignCenter);
     mainLayout->addWidget(titleLabel);
@@ -110,6 +121,23 @@ void ExportDialog::setupUI()
     presetLayout->addStretch();
     
     resLayout->addRow("Presets:", presetLayout);
+
+    // Frames are painted from the vectors at the chosen size; these trade
+    // render time for edge quality
+    m_supersampleComboBox = new QComboBox();
+    m_supersampleComboBox->addItem("Off", 1);
+    m_supersampleComboBox->addItem("2× (smoother edges)", 2);
+    m_supersampleComboBox->addItem("4× (slowest)", 4);
+    connect(m_supersampleComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &ExportDialog::updatePreview);
+    resLayout->addRow("Supersampling:", m_supersampleComboBox);
+
+    m_draftCheckBox = new QCheckBox("Draft (no antialiasing or brush textures)");
+    connect(m_draftCheckBox, &QCheckBox::toggled, [this](bool draft) {
+        m_supersampleComboBox->setEnabled(!draft);
+        updatePreview();
+    });
+    resLayout->addRow("", m_draftCheckBox);
     mainLayout->addWidget(resolutionGroup);
 
     // Type-specific settings
@@ -119,6 +147,8 @@ void ExportDialog::setupUI()
     } else if (m_type == ExportType::GIF) {
         createGIFSettings();
         mainLayout->addWidget(new QWidget());  // Will be replaced by GIF settings group
+    } else if (m_type == ExportType::ImageSequence) {
+        createSequenceSettings();
     } else {
         createImageSettings();
     }
@@ -192,6 +222,8 @@ void ExportDialog::setupUI()
         if (m_fpsSpinBox) m_fpsSpinBox->setValue(m_defaultFPS);
         m_qualitySlider->setValue(85);
         m_transparentBgCheckBox->setChecked(false);
+        m_supersampleComboBox->setCurrentIndex(0);
+        m_draftCheckBox->setChecked(false);
         updatePreview();
     });
 
@@ -228,7 +260,17 @@ void ExportDialog::createVideoSettings()
             this, &ExportDialog::onFormatChanged);
     videoLayout->addRow("Format:", m_formatComboBox);
 
-    // Frame Range
+    videoLayout->addRow(createFrameRangeGroup());
+
+    // Add to main layout (replace placeholder)
+    QVBoxLayout *mainLayout = qobject_cast<QVBoxLayout*>(layout());
+    if (mainLayout) {
+        mainLayout->insertWidget(2, videoGroup);
+    }
+}
+
+QGroupBox *ExportDialog::createFrameRangeGroup()
+{
     QGroupBox *rangeGroup = new QGroupBox("Frame Range");
     QVBoxLayout *rangeLayout = new QVBoxLayout(rangeGroup);
 
@@ -264,13 +306,7 @@ void ExportDialog::createVideoSettings()
         updatePreview();
     });
 
-    videoLayout->addRow(rangeGroup);
-
-    // Add to main layout (replace placeholder)
-    QVBoxLayout *mainLayout = qobject_cast<QVBoxLayout*>(layout());
-    if (mainLayout) {
-        mainLayout->insertWidget(2, videoGroup);
-    }
+    return rangeGroup;
 }
 
 void ExportDialog::createGIFSettings()
@@ -326,6 +362,19 @@ void ExportDialog::createImageSettings()
     }
 }
 
+void ExportDialog::createSequenceSettings()
+{
+    // One PNG per frame; the format is fixed, only the range is chosen
+    QGroupBox *sequenceGroup = new QGroupBox("Sequence Settings");
+    QFormLayout *sequenceLayout = new QFormLayout(sequenceGroup);
+    sequenceLayout->addRow(createFrameRangeGroup());
+
+    QVBoxLayout *mainLayout = qobject_cast<QVBoxLayout*>(layout());
+    if (mainLayout) {
+        mainLayout->insertWidget(2, sequenceGroup);
+    }
+}
+
 void ExportDialog::updatePreview()
 {
     int w = m_widthSpinBox->value();
@@ -343,11 +392,18 @@ void ExportDialog::updatePreview()
         if (m_type == ExportType::Video && !exportAllFrames()) {
             int frames = m_endFrameSpinBox->value() - m_startFrameSpinBox->value() + 1;
             qreal duration = (qreal)frames / fps;
-            preview += QString("<br><b>Duration:</b> %.2f seconds (%3 frames)")
-                           .arg(duration).arg(frames);
+            preview += QString("<br><b>Duration:</b> %1 seconds (%2 frames)")
+                           .arg(duration, 0, 'f', 2).arg(frames);
         }
     }
 
+    if (draftMode()) {
+        preview += "<br><b>Rendering:</b> Draft";
+    } else if (supersampling() > 1) {
+        preview += QString("<br><b>Rendering:</b> %1×%2 px, filtered down")
+                       .arg(w * supersampling()).arg(h * supersampling());
+    }
+
     if (m_transparentBgCheckBox->isChecked()) {
         preview += "<br><b>Background:</b> Transparent";
     } else {
@@ -564,6 +620,8 @@ bool ExportDialog::transparentBackground() const { return m_transparentBgCheckBo
 int ExportDialog::startFrame() const { return m_startFrameSpinBox ? m_startFrameSpinBox->value() : 1; }
 int ExportDialog::endFrame() const { return m_endFrameSpinBox ? m_endFrameSpinBox->value() : m_maxFrame; }
 bool ExportDialog::exportAllFrames() const { return m_allFramesCheckBox ? m_allFramesCheckBox->isChecked() : true; }
+int ExportDialog::supersampling() const { return m_supersampleComboBox->currentData().toInt(); }
+bool ExportDialog::draftMode() const { return m_draftCheckBox->isChecked(); }
 
 QString ExportDialog::format() const
 {
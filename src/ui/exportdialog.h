@@ -9,6 +9,8 @@
 #include <QLabel>
 #include <QPushButton>
 
+class QGroupBox;
+
 class ExportDialog : public QDialog
 {
     Q_OBJECT
@@ -17,7 +19,8 @@ public:
     enum class ExportType {
         Video,
         GIF,
-        Image
+        Image,
+        ImageSequence   // numbered PNG files, one per frame
     };
 
     explicit ExportDialog(ExportType type, QWidget *parent = nullptr);
@@ -32,6 +35,8 @@ public:
     int startFrame() const;
     int endFrame() const;
     bool exportAllFrames() const;
+    int supersampling() const;     // 1, 2 or 4
+    bool draftMode() const;
 
     // Setters for default values
     void setDefaultResolution(int width, int height);
@@ -47,6 +52,8 @@ private:
     void createVideoSettings();
     void createGIFSettings();
     void createImageSettings();
+    void createSequenceSettings();
+    QGroupBox *createFrameRangeGroup();
     void applyModernStyle();
 
     ExportType m_type;
@@ -62,6 +69,8 @@ private:
     QSpinBox *m_startFrameSpinBox;
     QSpinBox *m_endFrameSpinBox;
     QCheckBox *m_allFramesCheckBox;
+    QComboBox *m_supersampleComboBox;
+    QCheckBox *m_draftCheckBox;
     QLabel *m_previewLabel;
     QPushButton *m_resetButton;
 
@@ -0,0 +1,35 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <QAtomicInt>
+#include <QThread>
+#include <QThreadPool>
+#include <functional>
+
+// Calls fn(0) .. fn(count - 1) on a private thread pool and returns once all
+// calls are done. Indices are handed out one at a time, so uneven items (a
+// frame full of photos next to plain line art) still spread across cores.
+// fn must be safe to call concurrently for different indices.
+inline void parallelFor(int count, const std::function<void(int)> &fn,
+                        int maxThreads = QThread::idealThreadCount())
+{
+    if (count <= 0) return;
+    const int threads = qBound(1, maxThreads, count);
+    if (threads == 1) {
+        for (int i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    QAtomicInt next(0);
+    for (int t = 0; t < threads; ++t) {
+        pool.start([&]() {
+            for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1))
+                fn(i);
+        });
+    }
+    pool.waitForDone();
+}
+
+#endif // PARALLEL_H